@@ -0,0 +1,88 @@
+/*
+Arquivo: auditoria.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Conferência das faixas de sequência dos lotes no estágio
+        de relatório, fora do caminho das esteiras.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "auditoria.h"
+
+auditoria_t auditoria;
+
+void auditoria_inicia(const uint32_t *proxima)
+{
+    memset(&auditoria, 0, sizeof(auditoria));
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        auditoria.proxima[i] = proxima[i];
+    }
+}
+
+bool auditoria_lote(const lote_t *lote)
+{
+    uint32_t lacunas = 0, repetidas = 0;
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        // emenda com o lote anterior (diferenças com sinal, tolera a volta do contador)
+        int32_t emenda = (int32_t) (lote->seq_inicio[i] - auditoria.proxima[i]);
+
+        if (emenda > 0)
+        {
+            lacunas += emenda;
+        } else
+        {
+            repetidas -= emenda;
+        }
+
+        // dentro do lote as sequências são crescentes (a inserção descarta
+        // as repetidas), então a faixa maior que a contagem é lacuna
+        lacunas += (lote->seq_fim[i] - lote->seq_inicio[i]) - lote->contagem[i];
+
+        auditoria.proxima[i] = lote->seq_fim[i];
+    }
+
+    auditoria.lotes++;
+    auditoria.lacunas += lacunas;
+    auditoria.repetidas += repetidas;
+
+    return lacunas == 0 && repetidas == 0;
+}
+
+void auditoria_rejeita(void)
+{
+    auditoria.rejeitadas++;
+}
+
+uint32_t auditoria_sequencia(esteira_t *esteira)
+{
+#if AUDITORIA_INJETA_FALHAS
+    static uint32_t produtos = 0;
+    uint32_t n = __atomic_add_fetch(&produtos, 1, __ATOMIC_RELAXED);
+
+    if (n % AUDITORIA_INTERVALO == 0)
+    {
+        if ((n / AUDITORIA_INTERVALO) % 2)
+        {
+            // produto perdido antes da inserção
+            __atomic_add_fetch(&auditoria.injetadas_lacunas, 1, __ATOMIC_RELAXED);
+            esteira->sequencia++;
+        } else if (esteira->sequencia > 0)
+        {
+            // o sensor reenvia o produto anterior
+            __atomic_add_fetch(&auditoria.injetadas_repetidas, 1, __ATOMIC_RELAXED);
+            return esteira->sequencia - 1;
+        }
+    }
+#endif
+
+    return esteira->sequencia++;
+}
@@ -0,0 +1,57 @@
+/*
+Arquivo: auditoria.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Auditoria de contagem exatamente-uma-vez: cada produto leva
+        a sequência da sua esteira e cada lote guarda as faixas de
+        sequência que cobre; lacunas e repetições aparecem na
+        comparação entre lotes consecutivos.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef AUDITORIA_H
+#define AUDITORIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esteiras.h"
+#include "lote.h"
+
+// 1 = as esteiras pulam ou repetem uma sequência de vez em quando,
+// para conferir que a auditoria encontra exatamente o que foi injetado
+#ifndef AUDITORIA_INJETA_FALHAS
+#define AUDITORIA_INJETA_FALHAS 0
+#endif
+#define AUDITORIA_INTERVALO 97
+
+typedef struct
+{
+    uint32_t proxima[NUM_ESTEIRAS];     // início esperado do próximo lote
+    uint32_t lotes;                     // lotes auditados
+    uint32_t lacunas;                   // sequências que nenhum lote cobriu
+    uint32_t repetidas;                 // sequências cobertas por dois lotes
+    uint32_t rejeitadas;                // repetições descartadas na inserção
+    uint32_t injetadas_lacunas;
+    uint32_t injetadas_repetidas;
+} auditoria_t;
+
+extern auditoria_t auditoria;
+
+// proxima: sequência do primeiro produto ainda não relatado, por esteira
+void auditoria_inicia(const uint32_t *proxima);
+
+// compara as faixas do lote com o fim do lote anterior e com a
+// contagem do próprio lote; retorna false se achou lacuna ou repetição
+bool auditoria_lote(const lote_t *lote);
+
+// inserção (dentro do mutex): produto repetido descartado
+void auditoria_rejeita(void);
+
+// esteiras: sequência do próximo produto, com falhas injetadas se habilitado
+uint32_t auditoria_sequencia(esteira_t *esteira);
+
+#endif
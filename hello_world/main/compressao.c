@@ -0,0 +1,344 @@
+/*
+Arquivo: compressao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Codificador em fluxo (corridas + deltas em varint) e
+        decodificador do vetor de pesos dos lotes.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "compressao.h"
+
+#define CONTROLE_MEDIDO 0x80
+#define CONTROLE_CLASSE 0x7F
+
+static void grava_byte(compressor_t *c, uint8_t b)
+{
+    if (c->tamanho < c->capacidade)
+    {
+        c->saida[c->tamanho++] = b;
+    } else
+    {
+        c->estourou = true;
+    }
+}
+
+static void grava_varint(compressor_t *c, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        grava_byte(c, (v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+
+    grava_byte(c, v);
+}
+
+// inteiros pequenos com sinal viram varints curtos: 0, -1, 1, -2 ...
+static uint32_t zigzag(int32_t v)
+{
+    return ((uint32_t) v << 1) ^ (uint32_t) (v >> 31);
+}
+
+static int32_t dezigzag(uint32_t v)
+{
+    return (int32_t) (v >> 1) ^ -(int32_t) (v & 1);
+}
+
+static void fecha_corrida(compressor_t *c)
+{
+    if (c->classe < 0)
+    {
+        return;
+    }
+
+    grava_byte(c, (c->variavel ? CONTROLE_MEDIDO : 0) | c->classe);
+    grava_varint(c, c->repeticoes);
+
+    if (c->variavel)
+    {
+        for (uint32_t i = 0; i < c->repeticoes; i++)
+        {
+            grava_varint(c, zigzag(c->pendentes[i]));
+        }
+    }
+
+    c->classe = -1;
+    c->repeticoes = 0;
+}
+
+void compressor_inicia(compressor_t *c, uint8_t *saida, size_t capacidade)
+{
+    memset(c, 0, sizeof(*c));
+
+    c->saida = saida;
+    c->capacidade = capacidade;
+    c->classe = -1;
+}
+
+void compressor_fixo(compressor_t *c, int classe)
+{
+    if (c->classe != classe || c->variavel)
+    {
+        fecha_corrida(c);
+        c->classe = classe & CONTROLE_CLASSE;
+        c->variavel = false;
+    }
+
+    c->repeticoes++;
+}
+
+void compressor_medido(compressor_t *c, int classe, float peso)
+{
+    int32_t q = (int32_t) lroundf(peso * COMPRESSAO_ESCALA);
+
+    classe &= CONTROLE_CLASSE;
+
+    if (c->classe != classe || !c->variavel || c->repeticoes == COMPRESSAO_MAX_PENDENTES)
+    {
+        fecha_corrida(c);
+        c->classe = classe;
+        c->variavel = true;
+    }
+
+    c->pendentes[c->repeticoes++] = q - c->anterior[classe];
+    c->anterior[classe] = q;
+}
+
+size_t compressor_fim(compressor_t *c)
+{
+    fecha_corrida(c);
+
+    return c->estourou ? 0 : c->tamanho;
+}
+
+static bool le_varint(const uint8_t *entrada, size_t tamanho, size_t *pos, uint32_t *v)
+{
+    *v = 0;
+
+    for (int deslocamento = 0; deslocamento < 35; deslocamento += 7)
+    {
+        if (*pos >= tamanho)
+        {
+            return false;
+        }
+
+        uint8_t b = entrada[(*pos)++];
+        *v |= (uint32_t) (b & 0x7F) << deslocamento;
+
+        if ((b & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int compressao_decodifica(const uint8_t *entrada, size_t tamanho, const float *dicionario,
+                          uint8_t *classes, float *pesos, int max)
+{
+    int32_t anterior[COMPRESSAO_MAX_CLASSES] = {0};
+    size_t pos = 0;
+    int n = 0;
+
+    while (pos < tamanho)
+    {
+        uint8_t controle = entrada[pos++];
+        int classe = controle & CONTROLE_CLASSE;
+        uint32_t k;
+
+        if (!le_varint(entrada, tamanho, &pos, &k) || k > (uint32_t) (max - n))
+        {
+            return -1;
+        }
+
+        if (controle & CONTROLE_MEDIDO)
+        {
+            for (uint32_t j = 0; j < k; j++, n++)
+            {
+                uint32_t d;
+
+                if (!le_varint(entrada, tamanho, &pos, &d))
+                {
+                    return -1;
+                }
+
+                anterior[classe] += dezigzag(d);
+
+                if (classes != NULL)
+                {
+                    classes[n] = classe;
+                }
+                if (pesos != NULL)
+                {
+                    pesos[n] = (float) anterior[classe] / COMPRESSAO_ESCALA;
+                }
+            }
+        } else
+        {
+            // corrida de peso fixo: preenchimento direto
+            float peso = dicionario != NULL ? dicionario[classe] : 0;
+
+            if (classes != NULL)
+            {
+                memset(&classes[n], classe, k);
+            }
+            if (pesos != NULL)
+            {
+                for (uint32_t j = 0; j < k; j++)
+                {
+                    pesos[n + j] = peso;
+                }
+            }
+            n += k;
+        }
+    }
+
+    return n;
+}
+
+#if COMPRESSAO_BENCHMARK
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_timer.h"
+#include "esteiras.h"
+
+#define BENCHMARK_PRODUTOS 1500
+#define BENCHMARK_REPETICOES 20
+
+// traço por simulação do tempo: a esteira i libera um produto quando
+// t % periodo[i] == fase[i]; pesos medidos ganham ruído de até ±20 g
+static void gera_traco(uint8_t *classes, float *pesos, const uint32_t *periodos, int esteiras,
+                       bool medido)
+{
+    uint32_t aleatorio = 12345;
+    int n = 0;
+
+    for (uint32_t t = 0; n < BENCHMARK_PRODUTOS; t++)
+    {
+        for (int i = 0; i < esteiras && n < BENCHMARK_PRODUTOS; i++)
+        {
+            if (t % periodos[i] != (uint32_t) i % periodos[i])
+            {
+                continue;
+            }
+
+            aleatorio = aleatorio * 1103515245 + 12345;
+            classes[n] = i;
+            pesos[n] = 0.5f + 0.25f * i;
+            if (medido)
+            {
+                pesos[n] += ((int) ((aleatorio >> 16) % 41) - 20) / 1000.0f;
+            }
+            n++;
+        }
+    }
+}
+
+static bool mede(const char *nome, const uint32_t *periodos, int esteiras, bool medido)
+{
+    uint8_t *classes = malloc(BENCHMARK_PRODUTOS);
+    uint8_t *classes_dec = malloc(BENCHMARK_PRODUTOS);
+    float *pesos = malloc(BENCHMARK_PRODUTOS * sizeof(float));
+    float *pesos_dec = malloc(BENCHMARK_PRODUTOS * sizeof(float));
+    size_t capacidade = BENCHMARK_PRODUTOS * 5 + 16;
+    uint8_t *saida = malloc(capacidade);
+    compressor_t *c = malloc(sizeof(compressor_t));
+    float dicionario[COMPRESSAO_MAX_CLASSES];
+    size_t bytes = 0;
+    int n = 0;
+    bool ok = false;
+
+    if (classes == NULL || classes_dec == NULL || pesos == NULL || pesos_dec == NULL ||
+        saida == NULL || c == NULL)
+    {
+        printf("%s: sem memória\n", nome);
+        goto libera;
+    }
+
+    for (int i = 0; i < esteiras; i++)
+    {
+        dicionario[i] = 0.5f + 0.25f * i;
+    }
+
+    gera_traco(classes, pesos, periodos, esteiras, medido);
+
+    int64_t inicio = esp_timer_get_time();
+    for (int r = 0; r < BENCHMARK_REPETICOES; r++)
+    {
+        compressor_inicia(c, saida, capacidade);
+        for (int i = 0; i < BENCHMARK_PRODUTOS; i++)
+        {
+            if (medido)
+            {
+                compressor_medido(c, classes[i], pesos[i]);
+            } else
+            {
+                compressor_fixo(c, classes[i]);
+            }
+        }
+        bytes = compressor_fim(c);
+    }
+    int64_t codifica = esp_timer_get_time() - inicio;
+
+    inicio = esp_timer_get_time();
+    for (int r = 0; r < BENCHMARK_REPETICOES; r++)
+    {
+        n = compressao_decodifica(saida, bytes, dicionario, classes_dec, pesos_dec, BENCHMARK_PRODUTOS);
+    }
+    int64_t decodifica = esp_timer_get_time() - inicio;
+
+    // ida e volta: classes exatas, pesos na resolução da escala
+    ok = n == BENCHMARK_PRODUTOS;
+    for (int i = 0; ok && i < n; i++)
+    {
+        ok = classes_dec[i] == classes[i] && fabsf(pesos_dec[i] - pesos[i]) < 0.6f / COMPRESSAO_ESCALA;
+    }
+
+    double bruto = (double) BENCHMARK_PRODUTOS * sizeof(float) * BENCHMARK_REPETICOES;
+
+    printf("%s: %u -> %u bytes (%.1fx), codifica %.2f MB/s, decodifica %.2f MB/s %s\n", nome,
+           (unsigned) (BENCHMARK_PRODUTOS * sizeof(float)), (unsigned) bytes,
+           bytes > 0 ? (double) BENCHMARK_PRODUTOS * sizeof(float) / bytes : 0.0,
+           bruto / codifica, bruto / decodifica, ok ? "ok" : "ERRO");
+
+libera:
+    free(classes);
+    free(classes_dec);
+    free(pesos);
+    free(pesos_dec);
+    free(saida);
+    free(c);
+
+    return ok;
+}
+
+bool compressao_benchmark(void)
+{
+    const uint32_t periodos_3[3] = {TEMPO_EST_1, TEMPO_EST_2, TEMPO_EST_3};
+    uint32_t periodos_64[64];
+    bool ok = true;
+
+    // periodos de 100 ms a ~2.4 s, sem múltiplos comuns óbvios
+    for (int i = 0; i < 64; i++)
+    {
+        periodos_64[i] = 100 + 37 * i;
+    }
+
+    printf("Benchmark da compressão (%d produtos por lote)\n", BENCHMARK_PRODUTOS);
+
+    ok &= mede(" 3 esteiras, peso fixo  ", periodos_3, 3, false);
+    ok &= mede(" 3 esteiras, peso medido", periodos_3, 3, true);
+    ok &= mede("64 esteiras, peso fixo  ", periodos_64, 64, false);
+    ok &= mede("64 esteiras, peso medido", periodos_64, 64, true);
+
+    return ok;
+}
+#endif
@@ -0,0 +1,79 @@
+/*
+Arquivo: compressao.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Compressão em fluxo do vetor de pesos de um lote para
+        arquivamento: corridas de produtos da mesma classe de peso
+        fixo e deltas por classe para pesos medidos. Não depende
+        do ESP-IDF (só o benchmark), então compila também no host.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef COMPRESSAO_H
+#define COMPRESSAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// classes de 0 a 127 (7 bits no byte de controle)
+#define COMPRESSAO_MAX_CLASSES 128
+
+// pesos medidos são gravados em unidades de 1 g (1000 por kg)
+#define COMPRESSAO_ESCALA 1000
+
+// pesos medidos acumulados antes de fechar uma corrida
+#define COMPRESSAO_MAX_PENDENTES 32
+
+// pior caso do fluxo para n produtos: cada um na sua corrida (controle e
+// contagem) com um delta de até 3 bytes, ou seja, pesos de até ~500 kg
+#define COMPRESSAO_PIOR_CASO(n) (5 * (n))
+
+// 1 = mede razão e vazão em traços de 3 e 64 esteiras na partida
+#ifndef COMPRESSAO_BENCHMARK
+#define COMPRESSAO_BENCHMARK 0
+#endif
+
+// formato, byte de controle seguido de varints (LEB128):
+//   0ccccccc n            n produtos da classe c (peso do dicionário)
+//   1ccccccc n d1 .. dn   n pesos medidos da classe c, cada di é o delta
+//                         em zigzag para o peso anterior da mesma classe
+typedef struct
+{
+    uint8_t *saida;
+    size_t capacidade;
+    size_t tamanho;
+    bool estourou;
+
+    int classe;                 // corrida aberta (-1 = nenhuma)
+    bool variavel;
+    uint32_t repeticoes;
+    int32_t pendentes[COMPRESSAO_MAX_PENDENTES];
+
+    int32_t anterior[COMPRESSAO_MAX_CLASSES];   // último peso medido de cada classe
+} compressor_t;
+
+void compressor_inicia(compressor_t *c, uint8_t *saida, size_t capacidade);
+
+// produto de peso fixo (o decodificador usa o dicionário)
+void compressor_fixo(compressor_t *c, int classe);
+
+// produto com peso medido
+void compressor_medido(compressor_t *c, int classe, float peso);
+
+// fecha a corrida aberta; retorna os bytes gravados (0 se não coube)
+size_t compressor_fim(compressor_t *c);
+
+// decodifica até max produtos; dicionario pode ser NULL (pesos fixos
+// saem como 0). Retorna o número de produtos ou -1 se o fluxo é inválido
+int compressao_decodifica(const uint8_t *entrada, size_t tamanho, const float *dicionario,
+                          uint8_t *classes, float *pesos, int max);
+
+// retorna false se alguma ida e volta divergiu
+bool compressao_benchmark(void);
+
+#endif
@@ -0,0 +1,235 @@
+/*
+Arquivo: contador.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Leitura dos contadores de pulsos (PCNT ou simulador) com
+        tratamento das voltas do contador de 16 bits.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "driver/pcnt.h"
+#include "contador.h"
+
+static bool servico_isr = false;
+
+// o contador chegou no limite e voltou a 0
+static void IRAM_ATTR isr_limite(void *arg)
+{
+    contador_t *c = (contador_t *) arg;
+
+    c->voltas++;
+}
+
+bool contador_inicia_pcnt(contador_t *c, int unidade, int gpio)
+{
+    pcnt_config_t config = {
+        .pulse_gpio_num = gpio,
+        .ctrl_gpio_num = PCNT_PIN_NOT_USED,
+        .channel = PCNT_CHANNEL_0,
+        .unit = unidade,
+        .pos_mode = PCNT_COUNT_INC,         // conta a borda de subida
+        .neg_mode = PCNT_COUNT_DIS,
+        .lctrl_mode = PCNT_MODE_KEEP,
+        .hctrl_mode = PCNT_MODE_KEEP,
+        .counter_h_lim = CONTADOR_LIMITE,
+        .counter_l_lim = 0,
+    };
+
+    memset(c, 0, sizeof(*c));
+    c->unidade = unidade;
+
+    if (pcnt_unit_config(&config) != ESP_OK)
+    {
+        return false;
+    }
+
+    pcnt_set_filter_value(unidade, CONTADOR_FILTRO);
+    pcnt_filter_enable(unidade);
+    pcnt_event_enable(unidade, PCNT_EVT_H_LIM);
+
+    if (!servico_isr)
+    {
+        if (pcnt_isr_service_install(0) != ESP_OK)
+        {
+            return false;
+        }
+        servico_isr = true;
+    }
+    pcnt_isr_handler_add(unidade, isr_limite, c);
+
+    pcnt_counter_pause(unidade);
+    pcnt_counter_clear(unidade);
+    pcnt_counter_resume(unidade);
+
+    return true;
+}
+
+static uint32_t nova_rajada(contador_t *c)
+{
+    c->aleatorio = c->aleatorio * 1103515245 + 12345;
+
+    return 1 + (c->aleatorio >> 16) % CONTADOR_RAJADA_MAX;
+}
+
+void contador_inicia_simulado(contador_t *c, uint32_t periodo_ms, uint32_t semente)
+{
+    memset(c, 0, sizeof(*c));
+
+    c->unidade = -1;
+    c->periodo_us = periodo_ms * 1000;
+    c->inicio_us = esp_timer_get_time();
+    c->aleatorio = semente;
+}
+
+void contador_pulsos(contador_t *c, uint32_t n)
+{
+    // mesma aritmética do hardware: cada chegada no limite é uma interrupção
+    uint32_t valor = c->valor + n;
+
+    c->voltas += valor / CONTADOR_LIMITE;
+    c->valor = valor % CONTADOR_LIMITE;
+}
+
+// voltas e valor coerentes: relê se a ISR rodou no meio
+static uint32_t total(contador_t *c)
+{
+    uint32_t voltas;
+    int16_t valor;
+
+    do
+    {
+        voltas = c->voltas;
+        if (c->unidade >= 0)
+        {
+            pcnt_get_counter_value(c->unidade, &valor);
+        } else
+        {
+            valor = c->valor;
+        }
+    } while (voltas != c->voltas);
+
+    // módulo 2^32, como a diferença que sai daqui
+    return voltas * CONTADOR_LIMITE + (uint16_t) valor;
+}
+
+uint32_t contador_delta(contador_t *c)
+{
+    uint32_t atual, delta;
+
+    if (c->unidade < 0 && c->periodo_us > 0)
+    {
+        // produtos devidos até agora, soltos só quando uma rajada inteira chegou
+        uint32_t devidos = (uint32_t) ((esp_timer_get_time() - c->inicio_us) / c->periodo_us);
+        uint32_t rajada = 1 + (c->aleatorio >> 16) % CONTADOR_RAJADA_MAX;
+
+        while (devidos - c->emitidos >= rajada)
+        {
+            contador_pulsos(c, rajada);
+            c->emitidos += rajada;
+            rajada = nova_rajada(c);
+        }
+    }
+
+    atual = total(c);
+    delta = atual - c->anterior;
+
+    if ((int32_t) delta < 0)
+    {
+        // o contador já voltou a 0 mas a ISR ainda não somou a volta
+        delta += CONTADOR_LIMITE;
+        c->voltas_pendentes++;
+    }
+
+    c->anterior += delta;
+    c->leituras++;
+
+    return delta;
+}
+
+#if CONTADOR_BENCHMARK
+#include <stdio.h>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "lote.h"
+
+#define BENCHMARK_PRODUTOS 1000
+
+// inserção com o mesmo mutex + código de classe do caminho real
+static SemaphoreHandle_t mutex_benchmark;
+static lote_t lote_teste;
+static volatile uint32_t inseridos;
+
+static void insere(uint32_t n)
+{
+    xSemaphoreTake(mutex_benchmark, portMAX_DELAY);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        lote_insere(&lote_teste, inseridos % NUM_MAX_PROD, 0, 0);
+        inseridos++;
+    }
+    xSemaphoreGive(mutex_benchmark);
+}
+
+// uma ativação por produto, como as tarefas das esteiras
+static void consumidor(void *pvParameter)
+{
+    while (1)
+    {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+        insere(1);
+    }
+}
+
+void contador_benchmark(void)
+{
+    TaskHandle_t tarefa;
+    contador_t c;
+    int64_t inicio, por_tarefa, por_contador;
+
+    mutex_benchmark = xSemaphoreCreateMutex();
+    if (mutex_benchmark == NULL ||
+        xTaskCreatePinnedToCore(&consumidor, "consumidor", 2048, NULL, uxTaskPriorityGet(NULL) + 1,
+                                &tarefa, xPortGetCoreID()) != pdPASS)
+    {
+        printf("Benchmark do contador: sem memória\n");
+        return;
+    }
+
+    // prioridade maior no mesmo core: cada notificação troca de contexto
+    inseridos = 0;
+    inicio = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_PRODUTOS; i++)
+    {
+        xTaskNotifyGive(tarefa);
+    }
+    por_tarefa = esp_timer_get_time() - inicio;
+    vTaskDelete(tarefa);
+
+    // contador simulado lido a cada rajada (no firmware, a cada CONTADOR_PERIODO_MS);
+    // periodo 0: só os pulsos injetados aqui
+    contador_inicia_simulado(&c, 0, 1);
+    inseridos = 0;
+    inicio = esp_timer_get_time();
+    while (inseridos < BENCHMARK_PRODUTOS)
+    {
+        contador_pulsos(&c, nova_rajada(&c));
+        insere(contador_delta(&c));
+    }
+    por_contador = esp_timer_get_time() - inicio;
+
+    printf("Benchmark do contador (%d produtos): tarefa por produto %lld us, "
+           "contador %lld us em %u leituras (%.1fx)\n", BENCHMARK_PRODUTOS,
+           por_tarefa, por_contador, c.leituras,
+           por_contador > 0 ? (double) por_tarefa / por_contador : 0.0);
+
+    vSemaphoreDelete(mutex_benchmark);
+}
+#endif
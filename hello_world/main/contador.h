@@ -0,0 +1,75 @@
+/*
+Arquivo: contador.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Contagem de produtos por pulsos da fotocélula no periférico
+        PCNT: o hardware conta, a esteira só lê a diferença desde a
+        última leitura. Tem um simulador com a mesma aritmética de
+        16 bits para rodar sem sensor.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef CONTADOR_H
+#define CONTADOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 1 = esteiras somam em lote os pulsos contados a cada CONTADOR_PERIODO_MS
+// 0 = uma ativação da tarefa por produto (comportamento original)
+#define CONTADOR_HABILITADO 0
+
+// 1 = pulsos simulados em rajadas no ritmo da esteira, 0 = PCNT real
+#define CONTADOR_SIMULADO 1
+
+// periodo de leitura dos contadores
+#define CONTADOR_PERIODO_MS 100
+
+// o contador de 16 bits volta a 0 ao chegar no limite e avisa a ISR
+#define CONTADOR_LIMITE 32000
+
+// filtro de ruído da fotocélula, em ciclos do APB (80 MHz, até 1023)
+#define CONTADOR_FILTRO 1000
+
+// rajada máxima do simulador (produtos que chegam colados)
+#define CONTADOR_RAJADA_MAX 8
+
+// 1 = mede o custo de 1000 produtos por tarefa e por contador na partida
+#define CONTADOR_BENCHMARK 0
+
+typedef struct
+{
+    int unidade;                // PCNT_UNIT_x; -1 no simulador
+    volatile uint32_t voltas;   // vezes que o contador chegou no limite (ISR)
+    uint32_t anterior;          // total na última leitura
+    uint32_t leituras;
+    uint32_t voltas_pendentes;  // leituras que viram a volta antes da ISR
+
+    // simulador: pulsos devidos pelo tempo, entregues em rajadas
+    int16_t valor;
+    uint32_t periodo_us;
+    int64_t inicio_us;
+    uint32_t emitidos;
+    uint32_t aleatorio;
+} contador_t;
+
+// configura a unidade do PCNT no GPIO da fotocélula (borda de subida)
+bool contador_inicia_pcnt(contador_t *c, int unidade, int gpio);
+
+// simulador: um produto a cada periodo_ms em média, em rajadas
+// (periodo_ms 0 = só os pulsos de contador_pulsos)
+void contador_inicia_simulado(contador_t *c, uint32_t periodo_ms, uint32_t semente);
+
+// simulador: n pulsos de uma vez, com as voltas que o hardware daria
+void contador_pulsos(contador_t *c, uint32_t n);
+
+// produtos desde a leitura anterior (só a tarefa dona do contador chama)
+uint32_t contador_delta(contador_t *c);
+
+void contador_benchmark(void);
+
+#endif
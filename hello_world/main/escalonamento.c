@@ -0,0 +1,446 @@
+/*
+Arquivo: escalonamento.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Atribuição de prioridades rate-monotonic, partição das
+        tarefas entre os cores e análise de tempo de resposta
+        (RTA) com termo de bloqueio pelo mutex das esteiras.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <math.h>
+#include "escalonamento.h"
+
+static uint32_t maior(uint32_t a, uint32_t b)
+{
+    return a > b ? a : b;
+}
+
+// custo usado na análise: só o C estimado; o job medido de parede já traz
+// a preempção e o bloqueio, somá-lo à interferência contaria os dois de novo
+static uint32_t custo(const tarefa_periodica_t *t)
+{
+    return t->wcet_us;
+}
+
+static uint32_t secao(const tarefa_periodica_t *t, bool usar_medido)
+{
+    return usar_medido ? maior(t->secao_critica_us, t->secao_medida_us) : t->secao_critica_us;
+}
+
+void escalonamento_inicia(conjunto_tarefas_t *c, int num_cores)
+{
+    c->num_tarefas = 0;
+    c->num_cores = num_cores > ESCALONAMENTO_MAX_CORES ? ESCALONAMENTO_MAX_CORES : num_cores;
+
+    for (int k = 0; k < ESCALONAMENTO_MAX_CORES; k++)
+    {
+        c->utilizacao[k] = 0;
+    }
+}
+
+tarefa_periodica_t *escalonamento_adiciona(conjunto_tarefas_t *c, const char *nome,
+                                           uint32_t periodo_us, uint32_t wcet_us,
+                                           uint32_t secao_critica_us, bool usa_recurso)
+{
+    if (c->num_tarefas >= ESCALONAMENTO_MAX_TAREFAS || periodo_us == 0)
+    {
+        return NULL;
+    }
+
+    tarefa_periodica_t *t = &c->tarefas[c->num_tarefas++];
+
+    t->nome = nome;
+    t->periodo_us = periodo_us;
+    t->wcet_us = wcet_us;
+    t->secao_critica_us = secao_critica_us;
+    t->usa_recurso = usa_recurso;
+    t->prioridade = 0;
+    t->core = -1;
+    t->core_fixo = -1;
+    t->resposta_us = 0;
+    t->resposta_medida_us = 0;
+    t->secao_medida_us = 0;
+    t->resposta_analisada_us = 0;
+    t->secao_analisada_us = 0;
+
+    return t;
+}
+
+void escalonamento_atribui_rm(conjunto_tarefas_t *c, uint32_t prio_min, uint32_t prio_max)
+{
+    // cada periodo distinto recebe um nível, do menor periodo para o maior;
+    // se faltarem níveis, os periodos mais longos dividem a prioridade mínima
+    for (int i = 0; i < c->num_tarefas; i++)
+    {
+        int nivel = 0;
+
+        for (int j = 0; j < c->num_tarefas; j++)
+        {
+            // conta periodos distintos menores que o da tarefa i
+            if (c->tarefas[j].periodo_us < c->tarefas[i].periodo_us)
+            {
+                bool repetido = false;
+
+                for (int k = 0; k < j; k++)
+                {
+                    if (c->tarefas[k].periodo_us == c->tarefas[j].periodo_us)
+                    {
+                        repetido = true;
+                        break;
+                    }
+                }
+
+                if (!repetido)
+                {
+                    nivel++;
+                }
+            }
+        }
+
+        if (prio_max < prio_min + (uint32_t) nivel)
+        {
+            c->tarefas[i].prioridade = prio_min;
+        } else
+        {
+            c->tarefas[i].prioridade = prio_max - nivel;
+        }
+    }
+}
+
+// bloqueio: uma seção crítica de outra tarefa que usa o mesmo mutex
+// (conservador, cobre também o bloqueio remoto vindo do outro core)
+static uint32_t bloqueio(const conjunto_tarefas_t *c, int i, bool usar_medido)
+{
+    uint32_t b = 0;
+
+    if (!c->tarefas[i].usa_recurso)
+    {
+        return 0;
+    }
+
+    for (int j = 0; j < c->num_tarefas; j++)
+    {
+        if (j != i && c->tarefas[j].usa_recurso && c->tarefas[j].core >= 0)
+        {
+            b = maior(b, secao(&c->tarefas[j], usar_medido));
+        }
+    }
+
+    return b;
+}
+
+uint32_t escalonamento_bloqueio(const conjunto_tarefas_t *c, int i)
+{
+    return bloqueio(c, i, true);
+}
+
+// RTA da tarefa i no seu core; retorna 0 se passa do deadline
+static uint32_t tempo_resposta(const conjunto_tarefas_t *c, int i, bool usar_medido)
+{
+    const tarefa_periodica_t *ti = &c->tarefas[i];
+    uint64_t base = (uint64_t) custo(ti) + bloqueio(c, i, usar_medido);
+    uint64_t r = base, anterior = 0;
+
+    while (r != anterior)
+    {
+        if (r > ti->periodo_us)
+        {
+            return 0;
+        }
+
+        anterior = r;
+        r = base;
+
+        // interferência das tarefas de prioridade maior ou igual no mesmo core
+        for (int j = 0; j < c->num_tarefas; j++)
+        {
+            const tarefa_periodica_t *tj = &c->tarefas[j];
+
+            if (j == i || tj->core != ti->core || tj->prioridade < ti->prioridade)
+            {
+                continue;
+            }
+
+            r += ((anterior + tj->periodo_us - 1) / tj->periodo_us) * custo(tj);
+        }
+    }
+
+    return (uint32_t) r;
+}
+
+static bool analisa_core(conjunto_tarefas_t *c, int core, bool usar_medido)
+{
+    bool escalonavel = true;
+
+    c->utilizacao[core] = 0;
+
+    for (int i = 0; i < c->num_tarefas; i++)
+    {
+        tarefa_periodica_t *t = &c->tarefas[i];
+
+        if (t->core != core)
+        {
+            continue;
+        }
+
+        c->utilizacao[core] += (float) custo(t) / t->periodo_us;
+        t->resposta_us = tempo_resposta(c, i, usar_medido);
+
+        // um job observado mais longo que o R calculado desmente o C estimado
+        if (t->resposta_us == 0 || (usar_medido && t->resposta_medida_us > t->resposta_us))
+        {
+            escalonavel = false;
+        }
+    }
+
+    return escalonavel && c->utilizacao[core] <= 1.0f;
+}
+
+bool escalonamento_particiona(conjunto_tarefas_t *c)
+{
+    bool ok = true;
+
+    for (int i = 0; i < c->num_tarefas; i++)
+    {
+        c->tarefas[i].core = -1;
+    }
+
+    // ordem RM: prioridade decrescente, depois índice
+    for (int prio = 255; prio >= 0; prio--)
+    {
+        for (int i = 0; i < c->num_tarefas; i++)
+        {
+            tarefa_periodica_t *t = &c->tarefas[i];
+
+            if (t->prioridade != (uint32_t) prio)
+            {
+                continue;
+            }
+
+            int core;
+
+            for (core = 0; core < c->num_cores; core++)
+            {
+                if (t->core_fixo >= 0 && t->core_fixo != core)
+                {
+                    continue;
+                }
+
+                t->core = core;
+
+                if (analisa_core(c, core, false))
+                {
+                    break;
+                }
+            }
+
+            if (core == c->num_cores)
+            {
+                // não coube: deixa no core 0 (ou no fixo) para o relatório
+                t->core = t->core_fixo >= 0 ? t->core_fixo : 0;
+                ok = false;
+            }
+        }
+    }
+
+    return escalonamento_analisa(c, false) && ok;
+}
+
+bool escalonamento_analisa(conjunto_tarefas_t *c, bool usar_medido)
+{
+    bool escalonavel = true;
+
+    if (usar_medido)
+    {
+        for (int i = 0; i < c->num_tarefas; i++)
+        {
+            c->tarefas[i].resposta_analisada_us = c->tarefas[i].resposta_medida_us;
+            c->tarefas[i].secao_analisada_us = c->tarefas[i].secao_medida_us;
+        }
+    }
+
+    for (int core = 0; core < c->num_cores; core++)
+    {
+        if (!analisa_core(c, core, usar_medido))
+        {
+            escalonavel = false;
+        }
+    }
+
+    return escalonavel;
+}
+
+bool escalonamento_medicao_mudou(const conjunto_tarefas_t *c)
+{
+    for (int i = 0; i < c->num_tarefas; i++)
+    {
+        const tarefa_periodica_t *t = &c->tarefas[i];
+
+        if (t->resposta_medida_us > t->resposta_analisada_us || t->secao_medida_us > t->secao_analisada_us)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void escalonamento_registra(tarefa_periodica_t *t, uint32_t duracao_us)
+{
+    if (t != NULL && duracao_us > t->resposta_medida_us)
+    {
+        t->resposta_medida_us = duracao_us;
+    }
+}
+
+void escalonamento_registra_secao(tarefa_periodica_t *t, uint32_t duracao_us)
+{
+    if (t != NULL && duracao_us > t->secao_medida_us)
+    {
+        t->secao_medida_us = duracao_us;
+    }
+}
+
+static uint32_t mdc(uint32_t a, uint32_t b)
+{
+    while (b != 0)
+    {
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+
+    return a;
+}
+
+// liberações por tick do hiperperiodo das tarefas já colocadas
+static uint8_t carga[ESCALONAMENTO_MAX_HIPERPERIODO];
+
+// periodo em ticks como vTaskDelayUntil o enxerga
+static uint32_t periodo_ticks(uint32_t periodo_ms, uint32_t tick_ms)
+{
+    return periodo_ms >= tick_ms ? periodo_ms / tick_ms : 1;
+}
+
+// sem hiperperiodo curto: i * mdc / n em us, arredondado só no fim para o tick
+static void fases_mdc(const uint32_t *periodos_ms, uint32_t *fases_ms, int n, uint32_t tick_ms)
+{
+    uint32_t g = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        g = mdc(g, periodos_ms[i]);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        uint64_t fase_us = (uint64_t) i * g * 1000 / n;
+
+        fases_ms[i] = (uint32_t) ((fase_us + tick_ms * 500) / (tick_ms * 1000)) * tick_ms;
+    }
+}
+
+void escalonamento_fases(const uint32_t *periodos_ms, uint32_t *fases_ms, int n, uint32_t tick_ms)
+{
+    uint64_t h = 1;
+    bool colocada[ESCALONAMENTO_MAX_TAREFAS] = {false};
+
+    for (int i = 0; i < n && h <= ESCALONAMENTO_MAX_HIPERPERIODO; i++)
+    {
+        uint32_t p = periodo_ticks(periodos_ms[i], tick_ms);
+
+        h = h / mdc((uint32_t) (h % p), p) * p;
+    }
+
+    if (h > ESCALONAMENTO_MAX_HIPERPERIODO || n > ESCALONAMENTO_MAX_TAREFAS)
+    {
+        fases_mdc(periodos_ms, fases_ms, n, tick_ms);
+        return;
+    }
+
+    for (uint32_t t = 0; t < h; t++)
+    {
+        carga[t] = 0;
+    }
+
+    for (int k = 0; k < n; k++)
+    {
+        // a de menor periodo ainda sem fase (a de menor índice no empate)
+        int i = -1;
+
+        for (int j = 0; j < n; j++)
+        {
+            if (!colocada[j] && (i < 0 || periodos_ms[j] < periodos_ms[i]))
+            {
+                i = j;
+            }
+        }
+
+        // a fase cujo pior tick fica menos cheio; empate pela menor soma, depois a menor fase
+        uint32_t p = periodo_ticks(periodos_ms[i], tick_ms);
+        uint32_t melhor = 0, melhor_pico = UINT32_MAX, melhor_soma = UINT32_MAX;
+
+        for (uint32_t fase = 0; fase < p; fase++)
+        {
+            uint32_t pico = 0, soma = 0;
+
+            for (uint32_t t = fase; t < h; t += p)
+            {
+                pico = maior(pico, carga[t]);
+                soma += carga[t];
+            }
+
+            if (pico < melhor_pico || (pico == melhor_pico && soma < melhor_soma))
+            {
+                melhor = fase;
+                melhor_pico = pico;
+                melhor_soma = soma;
+            }
+        }
+
+        for (uint32_t t = melhor; t < h; t += p)
+        {
+            carga[t]++;
+        }
+        fases_ms[i] = melhor * tick_ms;
+        colocada[i] = true;
+    }
+}
+
+void escalonamento_imprime(const conjunto_tarefas_t *c)
+{
+    printf("Tarefa               T(us)    C(us)  B(us)  prio core  R(us)  Rmed(us)\n");
+
+    for (int i = 0; i < c->num_tarefas; i++)
+    {
+        const tarefa_periodica_t *t = &c->tarefas[i];
+
+        printf("%-16s %9u %8u %6u %5u %4d %6u %9u%s\n", t->nome,
+               t->periodo_us, t->wcet_us, escalonamento_bloqueio(c, i),
+               t->prioridade, t->core, t->resposta_us, t->resposta_medida_us,
+               t->resposta_us == 0 ? "  PERDE DEADLINE" :
+               t->resposta_medida_us > t->resposta_us ? "  ACIMA DO R" : "");
+    }
+
+    for (int core = 0; core < c->num_cores; core++)
+    {
+        int n = 0;
+
+        for (int i = 0; i < c->num_tarefas; i++)
+        {
+            n += c->tarefas[i].core == core;
+        }
+
+        // limite de Liu & Layland, apenas informativo (teste suficiente)
+        float limite = n > 0 ? n * (powf(2.0f, 1.0f / n) - 1.0f) : 1.0f;
+
+        printf("Core %d: %d tarefas, utilização %.3f (limite RM %.3f)\n",
+               core, n, c->utilizacao[core], limite);
+    }
+}
@@ -0,0 +1,106 @@
+/*
+Arquivo: escalonamento.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Análise de escalonabilidade rate-monotonic (RM) das
+        tarefas periódicas, com WCET medido e análise de tempo
+        de resposta por core.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef ESCALONAMENTO_H
+#define ESCALONAMENTO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esteiras.h"
+#include "reducao.h"
+
+// NUM máximo de tarefas analisadas: as esteiras, redução, relatório, touch,
+// display e os trabalhadores da redução
+#define ESCALONAMENTO_MAX_TAREFAS (NUM_ESTEIRAS + 4 + REDUCAO_MAX_TRABALHADORES)
+
+// NUM máximo de cores considerados na partição
+#define ESCALONAMENTO_MAX_CORES 2
+
+// maior hiperperiodo (em ticks) em que as fases são escolhidas tick a tick
+#define ESCALONAMENTO_MAX_HIPERPERIODO 4096
+
+typedef struct tarefa_periodica
+{
+    const char *nome;
+    uint32_t periodo_us;        // periodo (= deadline) da tarefa
+    uint32_t wcet_us;           // pior tempo de execução (C) estimado na partida
+    uint32_t secao_critica_us;  // maior tempo segurando o recurso compartilhado
+    bool usa_recurso;           // compartilha o mutex das esteiras
+    uint32_t prioridade;        // atribuída por RM
+    int core;                   // core atribuído pela partição
+    int core_fixo;              // -1 = livre para a partição
+    uint32_t resposta_us;       // tempo de resposta calculado (0 = não converge)
+
+    // valores medidos durante a execução; o job é medido de parede, do
+    // início ao fim, com preempção e bloqueio dentro: é tempo de resposta
+    // (limitado por R), não C, e não entra na soma da interferência
+    volatile uint32_t resposta_medida_us;
+    volatile uint32_t secao_medida_us;
+
+    // medidas usadas na última análise com usar_medido
+    uint32_t resposta_analisada_us;
+    uint32_t secao_analisada_us;
+} tarefa_periodica_t;
+
+typedef struct
+{
+    tarefa_periodica_t tarefas[ESCALONAMENTO_MAX_TAREFAS];
+    int num_tarefas;
+    int num_cores;
+    float utilizacao[ESCALONAMENTO_MAX_CORES];
+} conjunto_tarefas_t;
+
+// inicializa um conjunto vazio para num_cores cores
+void escalonamento_inicia(conjunto_tarefas_t *c, int num_cores);
+
+// adiciona uma tarefa periódica e retorna seu ponteiro (NULL se cheio)
+tarefa_periodica_t *escalonamento_adiciona(conjunto_tarefas_t *c, const char *nome,
+                                           uint32_t periodo_us, uint32_t wcet_us,
+                                           uint32_t secao_critica_us, bool usa_recurso);
+
+// atribui prioridades RM (menor periodo = maior prioridade) em [prio_min, prio_max]
+void escalonamento_atribui_rm(conjunto_tarefas_t *c, uint32_t prio_min, uint32_t prio_max);
+
+// distribui as tarefas entre os cores (first-fit em ordem RM)
+// retorna false se alguma tarefa não coube em nenhum core
+bool escalonamento_particiona(conjunto_tarefas_t *c);
+
+// análise de tempo de resposta com a partição atual
+// se usar_medido, o bloqueio usa a maior seção medida e um job medido
+// acima do R calculado reprova a tarefa (o C estimado não cobre)
+bool escalonamento_analisa(conjunto_tarefas_t *c, bool usar_medido);
+
+// true se algum pior caso medido cresceu desde a última análise com
+// usar_medido (só aí vale refazer a análise)
+bool escalonamento_medicao_mudou(const conjunto_tarefas_t *c);
+
+// registra o tempo de parede de um job da tarefa (tempo de resposta)
+void escalonamento_registra(tarefa_periodica_t *t, uint32_t duracao_us);
+
+// registra o tempo de uma seção crítica da tarefa
+void escalonamento_registra_secao(tarefa_periodica_t *t, uint32_t duracao_us);
+
+// fases da primeira liberação de n tarefas periódicas, em ms múltiplos de
+// tick_ms: cada tarefa, da de menor periodo para a de maior, fica na fase
+// que menos acumula liberações num mesmo tick ao longo do hiperperiodo;
+// hiperperiodo longo demais espalha as fases por igual dentro do mdc
+void escalonamento_fases(const uint32_t *periodos_ms, uint32_t *fases_ms, int n, uint32_t tick_ms);
+
+// bloqueio da tarefa i pelo mutex das esteiras, com as seções medidas
+uint32_t escalonamento_bloqueio(const conjunto_tarefas_t *c, int i);
+
+// imprime a tabela de análise (printf: só na partida, fora das tarefas)
+void escalonamento_imprime(const conjunto_tarefas_t *c);
+
+#endif
@@ -0,0 +1,113 @@
+/*
+Arquivo: estatistica.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Variância dos acumuladores, junção dos lotes no acumulado da
+        esteira e o benchmark de custo.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include "estatistica.h"
+
+float estatistica_variancia(const estatistica_t *e)
+{
+    return e->n > 1 ? e->m2 / (e->n - 1) : 0.0f;
+}
+
+float estatistica_desvio(const estatistica_t *e)
+{
+    return sqrtf(estatistica_variancia(e));
+}
+
+void estatistica_zera_acumulada(estatistica_acumulada_t *a)
+{
+    a->n = 0;
+    a->media = 0;
+    a->m2 = 0;
+    a->min = 0;
+    a->max = 0;
+}
+
+void estatistica_junta(estatistica_acumulada_t *a, const estatistica_t *e)
+{
+    uint64_t n;
+    double delta;
+
+    if (e->n == 0)
+    {
+        return;
+    }
+
+    if (a->n == 0)
+    {
+        a->min = e->min;
+        a->max = e->max;
+    } else
+    {
+        a->min = e->min < a->min ? e->min : a->min;
+        a->max = e->max > a->max ? e->max : a->max;
+    }
+
+    n = a->n + e->n;
+    delta = (double) e->media - a->media;
+    a->media += delta * e->n / n;
+    a->m2 += e->m2 + delta * delta * ((double) a->n * e->n / n);
+    a->n = n;
+}
+
+double estatistica_variancia_acumulada(const estatistica_acumulada_t *a)
+{
+    return a->n > 1 ? a->m2 / (a->n - 1) : 0.0;
+}
+
+#if ESTATISTICA_BENCHMARK
+#include <stdio.h>
+#include "esp_timer.h"
+#include "lote.h"
+
+#define BENCHMARK_INSERCOES 100000
+
+#define BENCHMARK_NOMINAL 2.0f
+
+static lote_t lote_teste;
+static estatistica_t estatistica_teste;
+
+// custo acrescentado a cada lote_insere do caminho das esteiras
+static void custo_insercao(void)
+{
+    int64_t inicio, sem, com;
+    float peso = BENCHMARK_NOMINAL;
+
+    inicio = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_INSERCOES; i++)
+    {
+        lote_insere(&lote_teste, i % NUM_MAX_PROD, 0, peso - BENCHMARK_NOMINAL);
+        peso += 1e-6f;
+    }
+    sem = esp_timer_get_time() - inicio;
+
+    peso = BENCHMARK_NOMINAL;
+    inicio = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_INSERCOES; i++)
+    {
+        lote_insere(&lote_teste, i % NUM_MAX_PROD, 0, peso - BENCHMARK_NOMINAL);
+        estatistica_acrescenta(&estatistica_teste, peso);
+        peso += 1e-6f;
+    }
+    com = esp_timer_get_time() - inicio;
+
+    printf("Benchmark da estatística: inserção %.3f us, com Welford %.3f us (+%.3f us)\n",
+           (double) sem / BENCHMARK_INSERCOES, (double) com / BENCHMARK_INSERCOES,
+           (double) (com - sem) / BENCHMARK_INSERCOES);
+}
+
+void estatistica_benchmark(void)
+{
+    custo_insercao();
+}
+#endif
@@ -0,0 +1,89 @@
+/*
+Arquivo: estatistica.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Média, variância, mínimo e máximo dos pesos atualizados a cada
+        produto pelo método de Welford (O(1) e estável), sem reler o
+        lote. O acumulador da esteira junta os lotes em double.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef ESTATISTICA_H
+#define ESTATISTICA_H
+
+#include <stdint.h>
+
+// 1 = mede o custo por inserção na partida (a estabilidade com 10^8
+// amostras é conferida no host, test/teste_estatistica.c)
+#define ESTATISTICA_BENCHMARK 0
+
+// de um lote: no máximo NUM_MAX_PROD amostras, float basta
+typedef struct
+{
+    uint32_t n;
+    float media;
+    float m2;                       // Σ (x - média)²
+    float min;
+    float max;
+} estatistica_t;
+
+// da esteira desde a partida: em float, média/n cairia abaixo do epsilon
+// com poucos milhões de produtos e a média pararia de andar
+typedef struct
+{
+    uint64_t n;
+    double media;
+    double m2;
+    float min;
+    float max;
+} estatistica_acumulada_t;
+
+// min e max também: uma esteira sem produtos no lote não mostra os do anterior
+static inline void estatistica_zera(estatistica_t *e)
+{
+    e->n = 0;
+    e->media = 0;
+    e->m2 = 0;
+    e->min = 0;
+    e->max = 0;
+}
+
+// Welford: um produto de peso x
+static inline void estatistica_acrescenta(estatistica_t *e, float x)
+{
+    float delta = x - e->media;
+
+    if (e->n == 0)
+    {
+        e->min = x;
+        e->max = x;
+    } else
+    {
+        e->min = x < e->min ? x : e->min;
+        e->max = x > e->max ? x : e->max;
+    }
+
+    e->n++;
+    e->media += delta / e->n;
+    e->m2 += delta * (x - e->media);
+}
+
+// variância amostral (n - 1); 0 com menos de dois produtos
+float estatistica_variancia(const estatistica_t *e);
+
+float estatistica_desvio(const estatistica_t *e);
+
+void estatistica_zera_acumulada(estatistica_acumulada_t *a);
+
+// soma um lote ao acumulado (fórmula paralela de Chan), uma vez por lote
+void estatistica_junta(estatistica_acumulada_t *a, const estatistica_t *e);
+
+double estatistica_variancia_acumulada(const estatistica_acumulada_t *a);
+
+void estatistica_benchmark(void);
+
+#endif
@@ -0,0 +1,67 @@
+/*
+Arquivo: esteiras.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Parâmetros das esteiras compartilhados entre os módulos.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef ESTEIRAS_H
+#define ESTEIRAS_H
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "pesagem.h"
+#include "sensor.h"
+#include "contador.h"
+#include "ingestao.h"
+#include "rejeicao.h"
+#include "serie.h"
+
+// numero de esteiras (os testes no host sobem para 64)
+#ifndef NUM_ESTEIRAS
+#define NUM_ESTEIRAS 3
+#endif
+
+// periodo milissegundos entre passagem de produtos nas esteiras 
+#define TEMPO_EST_1 1000
+#define TEMPO_EST_2 500
+#define TEMPO_EST_3 100
+
+// peso dos produtos nas esteiras
+#define PESO_EST_1 5.0
+#define PESO_EST_2 2.0
+#define PESO_EST_3 0.5
+
+typedef struct
+{
+    int id;                      // identificador da esteira
+    const char *nome;
+    uint32_t periodo_ms;         // periodo entre produtos
+    uint32_t fase_ms;            // atraso da primeira liberação após a partida
+    float peso;                  // peso do produto
+    int classe;                  // código do peso no dicionário dos lotes
+    TaskHandle_t handler;
+    struct tarefa_periodica *tarefa;  // entrada na análise de escalonamento (escalonamento.h)
+    uint32_t latencia_max_us;    // pior tempo entre acordar e inserir o produto
+    uint32_t sequencia;          // próximo número de produto desta esteira
+    rejeicao_t rejeicao;         // faixa de tolerância e decisões do ejetor
+    serie_t serie;               // contagem e massa por segundo, minuto e hora
+#if PESAGEM_HABILITADA
+    pesagem_t pesagem;           // detecção na célula de carga da esteira
+    sensor_t sensor;             // fonte das amostras da célula
+#endif
+#if CONTADOR_HABILITADO
+    contador_t contador;         // pulsos da fotocélula desta esteira
+#endif
+#if INGESTAO_HABILITADA
+    ingestao_t ingestao;         // interrupções da fotocélula desta esteira
+#endif
+} esteira_t;
+
+#endif
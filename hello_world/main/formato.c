@@ -0,0 +1,319 @@
+/*
+Arquivo: formato.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Formatador sem alocação para o display e o relatório.
+        Os números são convertidos de trás para frente num
+        buffer local pequeno e copiados para a linha.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "esp_vfs_dev.h"
+#include "xtensa/hal.h"
+#include "formato.h"
+
+#define UART_CONSOLE CONFIG_ESP_CONSOLE_UART_NUM
+
+// maior valor escalado que cabe em int32_t (2^31 - 128, o float abaixo de 2^31)
+#define DECIMAL_MAX 2147483520.0f
+
+// bytes entregues ao driver que a UART ainda não transmitiu: a estimativa
+// desconta o que a linha escoa no tempo (10 bits por byte). printf também
+// usa o driver: na partida fica de fora da conta (as tarefas ainda não
+// escrevem), depois dela quem usa printf soma os bytes com formato_externo
+static portMUX_TYPE mux_tx = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t pendentes = 0;
+static int64_t ultima_us = 0;
+static uint32_t descartadas = 0;
+
+void formato_inicia(void)
+{
+    // com o driver instalado a escrita só copia para o buffer de transmissão
+    uart_driver_install(UART_CONSOLE, 256, FORMATO_BUFFER_TX, 0, NULL, 0);
+    esp_vfs_dev_uart_use_driver(UART_CONSOLE);
+}
+
+void linha_inicia(linha_t *l, char *buf, int tam)
+{
+    l->buf = buf;
+    l->tam = tam;
+    l->pos = 0;
+    l->truncado = 0;
+}
+
+static void coloca(linha_t *l, const char *s, int n)
+{
+    int livre = l->tam - l->pos;
+
+    if (n > livre)
+    {
+        l->truncado += n - livre;
+        n = livre;
+    }
+
+    memcpy(&l->buf[l->pos], s, n);
+    l->pos += n;
+}
+
+void linha_texto(linha_t *l, const char *texto)
+{
+    coloca(l, texto, strlen(texto));
+}
+
+void linha_bytes(linha_t *l, const char *dados, int n)
+{
+    coloca(l, dados, n);
+}
+
+void linha_u32(linha_t *l, uint32_t valor)
+{
+    char d[10];
+    int n = 0;
+
+    do
+    {
+        d[sizeof(d) - 1 - n++] = '0' + valor % 10;
+        valor /= 10;
+    } while (valor != 0);
+
+    coloca(l, &d[sizeof(d) - n], n);
+}
+
+void linha_i32(linha_t *l, int32_t valor)
+{
+    if (valor < 0)
+    {
+        coloca(l, "-", 1);
+        linha_u32(l, (uint32_t) 0 - (uint32_t) valor);
+    } else
+    {
+        linha_u32(l, valor);
+    }
+}
+
+void linha_fixo(linha_t *l, int32_t valor, int casas)
+{
+    uint32_t divisor = 1;
+    uint32_t absoluto;
+
+    for (int i = 0; i < casas; i++)
+    {
+        divisor *= 10;
+    }
+
+    if (valor < 0)
+    {
+        coloca(l, "-", 1);
+        absoluto = (uint32_t) 0 - (uint32_t) valor;
+    } else
+    {
+        absoluto = valor;
+    }
+
+    linha_u32(l, absoluto / divisor);
+
+    if (casas > 0)
+    {
+        // parte fracionária com zeros à esquerda
+        char d[9];
+        uint32_t resto = absoluto % divisor;
+
+        for (int i = casas - 1; i >= 0; i--)
+        {
+            d[i] = '0' + resto % 10;
+            resto /= 10;
+        }
+
+        coloca(l, ".", 1);
+        coloca(l, d, casas);
+    }
+}
+
+void linha_decimal(linha_t *l, float valor, int casas)
+{
+    float escala = 1;
+
+    for (int i = 0; i < casas; i++)
+    {
+        escala *= 10;
+    }
+
+    float escalado = valor * escala;
+
+    // fora de int32_t a conversão não é definida: campo marcado em vez de lixo
+    if (escalado != escalado)
+    {
+        linha_texto(l, "nan");
+    } else if (escalado >= DECIMAL_MAX)
+    {
+        linha_texto(l, "ovf");
+    } else if (escalado <= -DECIMAL_MAX)
+    {
+        linha_texto(l, "-ovf");
+    } else
+    {
+        linha_fixo(l, (int32_t) (escalado < 0 ? escalado - 0.5f : escalado + 0.5f), casas);
+    }
+}
+
+void linha_duracao(linha_t *l, int64_t us)
+{
+    if (us < 10000)
+    {
+        linha_u32(l, (uint32_t) us);
+        linha_texto(l, " us");
+    } else if (us < 10000000)
+    {
+        linha_fixo(l, (int32_t) (us / 10), 2);
+        linha_texto(l, " ms");
+    } else
+    {
+        linha_fixo(l, (int32_t) (us / 1000), 3);
+        linha_texto(l, " s");
+    }
+}
+
+void linha_nova(linha_t *l)
+{
+    coloca(l, "\n", 1);
+}
+
+int linha_escreve(linha_t *l)
+{
+    int escrito = formato_escreve(l->buf, l->pos);
+
+    l->pos = 0;
+
+    return escrito;
+}
+
+// desconta o que a UART transmitiu desde a última conta (com mux_tx)
+static void escoa(int64_t agora)
+{
+    uint64_t escoados = (uint64_t) (agora - ultima_us) * (FORMATO_BAUD / 10) / 1000000;
+
+    pendentes = escoados >= pendentes ? 0 : pendentes - (uint32_t) escoados;
+    ultima_us = agora;
+}
+
+int formato_escreve(const char *dados, int n)
+{
+    int64_t agora = esp_timer_get_time();
+    bool cabe;
+
+    if (n <= 0)
+    {
+        return 0;
+    }
+
+    // reserva o espaço antes de escrever: uart_write_bytes bloquearia
+    // esperando o buffer esvaziar
+    portENTER_CRITICAL(&mux_tx);
+    escoa(agora);
+
+    cabe = pendentes + n <= FORMATO_BUFFER_TX;
+    if (cabe)
+    {
+        pendentes += n;
+    } else
+    {
+        descartadas++;
+    }
+    portEXIT_CRITICAL(&mux_tx);
+
+    return cabe ? uart_write_bytes(UART_CONSOLE, dados, n) : 0;
+}
+
+void formato_externo(int n)
+{
+    int64_t agora = esp_timer_get_time();
+
+    if (n <= 0)
+    {
+        return;
+    }
+
+    // printf esperou o driver aceitar tudo: no máximo o buffer inteiro ficou
+    portENTER_CRITICAL(&mux_tx);
+    escoa(agora);
+    pendentes = pendentes + n > FORMATO_BUFFER_TX ? FORMATO_BUFFER_TX : pendentes + n;
+    portEXIT_CRITICAL(&mux_tx);
+}
+
+uint32_t formato_descartadas(void)
+{
+    return __atomic_load_n(&descartadas, __ATOMIC_RELAXED);
+}
+
+// valores típicos de um refresh do display
+static const uint32_t contagem_exemplo = 123456;
+static const float massa_exemplo = 61728.5f;
+static const float taxa_exemplo = 10.04f;
+
+static volatile uint32_t ciclos_medidos;
+static volatile uint32_t pilha_usada;
+
+static void bench_printf(void *pvParameter)
+{
+    TaskHandle_t chamador = (TaskHandle_t) pvParameter;
+    char buf[128];
+    uint32_t inicio = xthal_get_ccount();
+
+    snprintf(buf, sizeof(buf), "  esteira_3: %u produtos, %f kg | %f prod/s\n",
+             contagem_exemplo, massa_exemplo, taxa_exemplo);
+
+    ciclos_medidos = xthal_get_ccount() - inicio;
+    pilha_usada = 4096 - uxTaskGetStackHighWaterMark(NULL);
+    xTaskNotifyGive(chamador);
+    vTaskDelete(NULL);
+}
+
+static void bench_formato(void *pvParameter)
+{
+    TaskHandle_t chamador = (TaskHandle_t) pvParameter;
+    char buf[128];
+    linha_t l;
+    uint32_t inicio = xthal_get_ccount();
+
+    linha_inicia(&l, buf, sizeof(buf));
+    linha_texto(&l, "  esteira_3: ");
+    linha_u32(&l, contagem_exemplo);
+    linha_texto(&l, " produtos, ");
+    linha_decimal(&l, massa_exemplo, 3);
+    linha_texto(&l, " kg | ");
+    linha_decimal(&l, taxa_exemplo, 2);
+    linha_texto(&l, " prod/s");
+    linha_nova(&l);
+
+    ciclos_medidos = xthal_get_ccount() - inicio;
+    pilha_usada = 4096 - uxTaskGetStackHighWaterMark(NULL);
+    xTaskNotifyGive(chamador);
+    vTaskDelete(NULL);
+}
+
+// cada variante roda numa tarefa nova para a marca de pilha ser só dela
+static void mede(const char *nome, TaskFunction_t func)
+{
+    xTaskCreate(func, nome, 4096, xTaskGetCurrentTaskHandle(), configMAX_PRIORITIES - 1, NULL);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    printf("%-8s %6u ciclos, %5u bytes de pilha\n", nome, ciclos_medidos, pilha_usada);
+}
+
+void formato_benchmark(void)
+{
+    printf("Benchmark de uma linha do display\n");
+    mede("printf", bench_printf);
+    mede("formato", bench_formato);
+}
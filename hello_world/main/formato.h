@@ -0,0 +1,74 @@
+/*
+Arquivo: formato.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Formatação de contadores, pesos em ponto fixo e durações
+        num buffer de linha pré-alocado, sem printf nem malloc.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef FORMATO_H
+#define FORMATO_H
+
+#include <stdint.h>
+
+// buffer de transmissão do driver da UART do console
+#define FORMATO_BUFFER_TX 2048
+
+// velocidade do console, para estimar quanto do buffer já saiu
+#ifndef FORMATO_BAUD
+#define FORMATO_BAUD CONFIG_ESP_CONSOLE_UART_BAUDRATE
+#endif
+
+// 1 = compara ciclos e pilha do formatador com printf na partida
+#define FORMATO_BENCHMARK 0
+
+typedef struct
+{
+    char *buf;
+    int tam;
+    int pos;
+    int truncado;   // caracteres que não couberam
+} linha_t;
+
+// instala o driver da UART do console (printf passa a usá-lo também)
+void formato_inicia(void);
+
+void linha_inicia(linha_t *l, char *buf, int tam);
+void linha_texto(linha_t *l, const char *texto);
+void linha_bytes(linha_t *l, const char *dados, int n);
+void linha_u32(linha_t *l, uint32_t valor);
+void linha_i32(linha_t *l, int32_t valor);
+
+// valor com 'casas' casas decimais implícitas: (1234, 2) -> 12.34
+void linha_fixo(linha_t *l, int32_t valor, int casas);
+
+// float arredondado para 'casas' casas decimais, sem formatação de float
+void linha_decimal(linha_t *l, float valor, int casas);
+
+// duração em us escolhendo a unidade (us, ms ou s)
+void linha_duracao(linha_t *l, int64_t us);
+
+void linha_nova(linha_t *l);
+
+// uma única escrita do buffer no console; retorna bytes aceitos
+int linha_escreve(linha_t *l);
+
+// escreve no console sem bloquear: sem espaço no buffer de transmissão
+// a escrita inteira é descartada e contada; retorna bytes aceitos
+int formato_escreve(const char *dados, int n);
+
+// bytes que printf entregou ao driver depois da partida, para
+// formato_escreve não contar com um buffer que já está ocupado
+void formato_externo(int n);
+
+// escritas descartadas por buffer de transmissão cheio desde a partida
+uint32_t formato_descartadas(void);
+
+void formato_benchmark(void);
+
+#endif
@@ -12,31 +12,49 @@ Modificado em 02 de dezembro de 2020
 */
 
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
+#include "freertos/event_groups.h"
 #include "esp_system.h"
 #include "driver/gpio.h"
 #include "nvs_flash.h"
 #include "driver/touch_pad.h"
 #include "esp_log.h"
 #include "esp_timer.h"
-
-// NUM máximo de produto
-#define NUM_MAX_PROD 200
-
-// periodo milissegundos entre passagem de produtos nas esteiras 
-#define TEMPO_EST_1 1000
-#define TEMPO_EST_2 500
-#define TEMPO_EST_3 100
+#include "escalonamento.h"
+#include "esteiras.h"
+#include "lote.h"
+#include "reducao.h"
+#include "instantaneo.h"
+#include "metricas.h"
+#include "formato.h"
+#include "telemetria.h"
+#include "log_diferido.h"
+#include "rastro.h"
+#include "persistencia.h"
+#include "historico.h"
+#include "recuperacao.h"
+#include "auditoria.h"
+#include "compressao.h"
+#include "pesagem.h"
+#include "sensor.h"
+#include "contador.h"
+#include "ingestao.h"
+#include "estatistica.h"
+#include "quantil.h"
+
+#if PESAGEM_HABILITADA + CONTADOR_HABILITADO + INGESTAO_HABILITADA > 1
+#error "pesagem, contador por pulsos e ingestão por interrupção são modos exclusivos das esteiras"
+#endif
 
 // periodo entre atualizações do display
 #define TEMPO_ATUALIZACAO 2000
 
-// peso dos produtos nas esteiras
-#define PESO_EST_1 5.0
-#define PESO_EST_2 2.0
-#define PESO_EST_3 0.5
+// periodo de leitura do touch
+#define TEMPO_TOUCH 200
 
 // Valores do touch
 #define TOUCH_PAD_NO_CHANGE   (-1)
@@ -44,205 +62,796 @@ Modificado em 02 de dezembro de 2020
 #define TOUCH_FILTER_MODE_EN  (0)
 #define TOUCHPAD_FILTER_TOUCH_PERIOD (10)
 
+// 1 = defasa a liberação das esteiras para não acordarem no mesmo tick
+// 0 = todas partem juntas (para comparar a contenção)
+#define ESTEIRAS_DEFASADAS 1
+
+// 1 = calcula as fases automaticamente, 0 = usa fase_ms da tabela
+#define FASE_AUTOMATICA 1
+
+// pilha das esteiras (o bloco de amostras fica na pilha com a pesagem)
+#define PILHA_ESTEIRA (PESAGEM_HABILITADA ? 3072 : 2048)
+
+// trabalhadores da redução paralela: só a conferência do total e os
+// benchmarks somam produto a produto; o total do lote sai do dicionário
+#define REDUCAO_TRABALHADORES (LOTE_CONFERE_REDUCAO || REDUCAO_BENCHMARK || LOTE_BENCHMARK)
+
+// bit do grupo de eventos que libera a partida sincronizada
+#define EVENTO_PARTIDA (1 << 0)
+
+// faixa de prioridades distribuída por rate-monotonic
+#define PRIORIDADE_MIN 1
+#define PRIORIDADE_MAX 5
+
+// 1 = não inicia as esteiras se o conjunto não for escalonável
+// 0 = apenas avisa
+#define ESCALONAMENTO_RECUSAR_INICIO 1
+
+// fator de segurança sobre o WCET medido na partida
+#define ESCALONAMENTO_MARGEM 2
+
+// repetições da medição de WCET na partida
+#define ESCALONAMENTO_AMOSTRAS 16
+
 // variavel do semaforo
 SemaphoreHandle_t mutual_exclusion_mutex;
-SemaphoreHandle_t mutual_exclusion_mutex_soma;
 
-// handler de task para suspender
+// grupo de eventos da partida sincronizada
+EventGroupHandle_t grupo_eventos;
+static TickType_t epoca_partida;
+
+// contenção no mutex das esteiras
+static portMUX_TYPE mux_contencao = portMUX_INITIALIZER_UNLOCKED;
+static int esperando_mutex = 0;
+static int pico_contencao = 0;
+static uint32_t num_contencoes = 0;
+
 TaskHandle_t handler_display;
 
-// handler das esteiras 
-TaskHandle_t handler_est1;
-TaskHandle_t handler_est2;
-TaskHandle_t handler_est3;
+// esteiras
+static esteira_t esteiras[NUM_ESTEIRAS] = {
+    {1, "esteira_1", TEMPO_EST_1, 0, PESO_EST_1},
+    {2, "esteira_2", TEMPO_EST_2, 0, PESO_EST_2},
+    {3, "esteira_3", TEMPO_EST_3, 0, PESO_EST_3},
+};
+
 TaskHandle_t handler_touch;
-TaskHandle_t handler_task1;
-TaskHandle_t handler_task2;
+TaskHandle_t handler_reducao;
+TaskHandle_t handler_relatorio;
+
+// vazão por esteira
+static metricas_esteira_t metricas[NUM_ESTEIRAS];
 
+// lote em preenchimento
+static lote_t *lote_atual = NULL;
 static int num_produtos = 0;
-static float pesos[NUM_MAX_PROD] = {0x0};
-static float peso_total = 0;
+static uint32_t num_lotes = 0;
+
+// estado restaurado da NVS; as contagens desta partida somam a ele
+static checkpoint_t checkpoint_base;
+static uint32_t lote_inicial = 0;
+
+// kg por esteira nos lotes relatados desde a partida (só o relatório escreve)
+static double massa_relatada[NUM_ESTEIRAS];
+
+// false se a partição de histórico não existe
+static bool historico_ativo = false;
+
+// próxima sequência aceita de cada esteira (protegida pelo mutex)
+static uint32_t seq_esperada[NUM_ESTEIRAS];
+
+// vezes em que o preenchimento esperou um buffer livre (sempre com o
+// mutex das esteiras solto)
+static uint32_t esperas_buffer = 0;
 
 int64_t start_soma, end_soma;
-double total_time;
 
-void suspender_tasks ()
+// tarefas periódicas para análise de escalonabilidade
+static conjunto_tarefas_t tarefas_sistema;
+static tarefa_periodica_t *tarefa_display;
+static tarefa_periodica_t *tarefa_touch;
+static tarefa_periodica_t *tarefa_reducao;
+static tarefa_periodica_t *tarefa_relatorio;
+
+// quantis do turno, só a redução escreve e lê; o relatório recebe os
+// valores no lote
+static quantil_t quantis_turno;
+static int64_t inicio_turno_us = 0;
+
+void soma_pesos(lote_t *lote)
 {
-    // display
-    vTaskSuspend(handler_display);
-    // inserir tasks para suspender aqui
+    RASTRO_INICIO(RASTRO_SOMA_PESOS);
+
+    // Σ contagem × peso das classes, sem percorrer os produtos
+    lote->peso_total = lote_total(lote);
+
+    // ordenar os pesos e compactar o esboço: aqui não segura o mutex das esteiras
+    if (quantis_turno.n == 0 || lote->fechado_us - inicio_turno_us >= (int64_t) QUANTIL_TURNO_MS * 1000)
+    {
+        quantil_inicia(&quantis_turno, lote->numero);
+        inicio_turno_us = lote->inicio_us;
+    }
+    lote_quantis(lote, &quantis_turno);
+
+#if LOTE_CONFERE_REDUCAO
+    // só o estágio de redução usa este vetor
+    static float pesos[NUM_MAX_PROD];
+
+    // decodifica e divide entre os trabalhadores persistentes (um por core)
+    lote_decodifica(lote, pesos);
+    float conferido = reducao_soma(pesos, lote->num_produtos);
+
+    // pesos medidos: o dicionário não guarda o desvio de cada produto
+    for (int c = 0; c < LOTE_MAX_CLASSES; c++)
+    {
+        conferido += lote->desvio_classe[c];
+    }
+
+    if (fabsf(conferido - lote->peso_total) > 1e-5f * fabsf(lote->peso_total))
+    {
+        LOG_DIF(MSG_CONFERENCIA, LOG_U(lote->numero), LOG_F(lote->peso_total), LOG_F(conferido));
+    }
+#endif
+
+    RASTRO_FIM(RASTRO_SOMA_PESOS);
 }
 
-void resumir_tasks ()
+// estágio 2: soma o lote k enquanto o k+1 enche
+void reducao(void *pvParameter)
 {
-    // display
-    vTaskResume(handler_display);
-    // inserir tasks para suspender aqui
-}
+    lote_t *lote;
+    int64_t inicio;
 
-void soma_paralela(int ID){
+    while(1)
+    {
+        lote = lote_aguarda_reducao();
 
-    float resultado = 0;
-    int max = 0, i = 0; 
+        inicio = esp_timer_get_time();
+        lote->inicio_reducao_us = inicio;
+        soma_pesos(lote);
+        lote->fim_reducao_us = esp_timer_get_time();
 
-    while(1)
+        instantaneo_lote(lote->numero, lote->peso_total);
+
+        escalonamento_registra(tarefa_reducao, (uint32_t) (lote->fim_reducao_us - inicio));
+
+        lote_envia_relatorio(lote);
+    }
+}
+
+#if TELEMETRIA_HABILITADA
+// arquiva o vetor de pesos do lote comprimido, em pedaços
+static int envia_pesos(const lote_t *lote)
+{
+    // só a tarefa de relatório usa (o compressor não cabe bem na pilha)
+    static compressor_t compressor;
+    static uint8_t fluxo[COMPRESSAO_PIOR_CASO(NUM_MAX_PROD)];
+    telemetria_pesos_t pedaco;
+    size_t total;
+    int bytes = 0;
+
+    compressor_inicia(&compressor, fluxo, sizeof(fluxo));
+    for (int i = 0; i < lote->num_produtos; i++)
     {
-        if (ID == 1)
-        {
-            i = 0;
-            max = (int) NUM_MAX_PROD/2;
-        } else if (ID == 2)
+        int classe = LOTE_CODIGO_LE(lote->codigos, i);
+
+        // peso fixo entra na corrida da classe; o medido vai como delta em gramas
+        if (lote_desvio(lote, i) == 0)
         {
-            i = (int) NUM_MAX_PROD/2;
-            max = NUM_MAX_PROD;
-        } else 
+            compressor_fixo(&compressor, classe);
+        } else
         {
-            printf("ID recebido errado!\n");
-            vTaskDelete(NULL);
+            compressor_medido(&compressor, classe,
+                              lote_peso_classe(classe) + (float) lote_desvio(lote, i) / LOTE_ESCALA_DESVIO);
         }
+    }
+    total = compressor_fim(&compressor);
 
-        // soma as posições do valor incial ao final
-        for(int j = i; j < max; j ++ )
-        {                
-            resultado += pesos[j];                
-        }        
+    pedaco.lote = lote->numero;
+    pedaco.total = total;
 
-        // start semaphore
-        xSemaphoreTake(mutual_exclusion_mutex_soma, portMAX_DELAY);
-        peso_total += resultado;    // adiciona a soma total
-        xSemaphoreGive(mutual_exclusion_mutex_soma);
-        // end mutex
+    for (size_t d = 0; d < total; d += TELEMETRIA_PESOS_PEDACO)
+    {
+        size_t n = total - d < TELEMETRIA_PESOS_PEDACO ? total - d : TELEMETRIA_PESOS_PEDACO;
 
-        // printf("Resultado task %d = %f\n", ID, resultado);
+        pedaco.deslocamento = d;
+        memcpy(pedaco.dados, &fluxo[d], n);
+        bytes += telemetria_envia(TELEMETRIA_PESOS, &pedaco, TELEMETRIA_PESOS_CABECALHO + n);
+    }
 
-        // deleta task atual
-        vTaskDelete(NULL);
-    }    
+    return bytes;
 }
 
-void soma_pesos()
+// quadros binários do lote: resumo, contadores por esteira e histograma
+void envia_telemetria(lote_t *lote, uint32_t texto_us)
 {
-    // suspender as  tasks
-    suspender_tasks();
+    telemetria_lote_t resumo;
+    telemetria_esteira_t esteira;
+    telemetria_histograma_t histograma;
+    instantaneo_t estado;
+    int bytes = 0;
+    int64_t inicio = esp_timer_get_time();
+
+    resumo.numero = lote->numero;
+    resumo.tempo_ms = (uint32_t) ((lote->fim_reducao_us - start_soma) / 1000);
+    resumo.peso_total = lote->peso_total;
+    resumo.reducao_us = (uint32_t) (lote->fim_reducao_us - lote->inicio_reducao_us);
+    resumo.preenchimento_us = (uint32_t) (lote->fechado_us - lote->inicio_us);
+    resumo.num_produtos = lote->num_produtos;
+    bytes += telemetria_envia(TELEMETRIA_LOTE, &resumo, sizeof(resumo));
+
+    instantaneo_le(&estado);
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        esteira.esteira = esteiras[i].id;
+        esteira.contagem = estado.contagem[i];
+        esteira.massa = massa_relatada[i];
+        esteira.taxa = estado.taxa[i];
+        esteira.latencia_max_us = esteiras[i].latencia_max_us;
+        esteira.produtos_lote = lote->estatistica[i].n;
+        esteira.media = lote->estatistica[i].media;
+        esteira.desvio = estatistica_desvio(&lote->estatistica[i]);
+        esteira.min = lote->estatistica[i].min;
+        esteira.max = lote->estatistica[i].max;
+        bytes += telemetria_envia(TELEMETRIA_ESTEIRA, &esteira, sizeof(esteira));
+    }
 
-    // cria threads para realizar a soma paralelamente
-    // divide entre os dois cores 50% pra cada
-    // colocado mutex nas tasks para poder somar corretamente
-    xTaskCreatePinnedToCore(&soma_paralela, "soma_1", 2048, (int*)1, 4, &handler_task1, APP_CPU_NUM);
-    configASSERT(handler_task1);
-    xTaskCreatePinnedToCore(&soma_paralela, "soma_2", 2048, (int*)2, 4, &handler_task2, PRO_CPU_NUM);
-    configASSERT(handler_task2);
-    
-    // aguarda task1 finalizar
-    while(eTaskGetState(handler_task1) == eRunning)
+    telemetria_histograma_coleta(&histograma);
+    bytes += telemetria_envia(TELEMETRIA_HISTOGRAMA, &histograma, sizeof(histograma));
+
+    bytes += envia_pesos(lote);
+
+    // custo do canal binário contra o relatório em texto do mesmo lote
+    LOG_DIF(MSG_TELEMETRIA, LOG_D(bytes), LOG_U(esp_timer_get_time() - inicio), LOG_U(texto_us));
+}
+#endif
+
+// totais acumulados desde a primeira partida até o fim deste lote, para o
+// checkpoint: tudo tirado do lote fechado, nada das contagens ao vivo, que já
+// incluem produtos de lotes que ainda não chegaram aqui
+static void monta_checkpoint(checkpoint_t *c, const lote_t *lote, double peso_acumulado)
+{
+    c->lotes = lote->numero + 1;
+    c->peso_acumulado = peso_acumulado;
+    c->ultimo_total = lote->peso_total;
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        // a sequência é o índice do produto desde a primeira partida
+        c->contagem[i] = lote->seq_fim[i];
+        c->massa[i] = checkpoint_base.massa[i] + massa_relatada[i];
+    }
+}
+
+// estágio 3: imprime o lote k-1 e devolve o buffer ao pool
+void relatorio(void *pvParameter)
+{
+    lote_t *lote;
+    int64_t inicio;
+    checkpoint_t checkpoint;
+    persistencia_estatisticas_t persistencia;
+    historico_registro_t registro;
+    double peso_acumulado = checkpoint_base.peso_acumulado;
+    uint32_t rejeitadas = 0;
+    estatistica_acumulada_t acumulada[NUM_ESTEIRAS];    // só este estágio escreve
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
     {
-        vTaskDelay(1 / portTICK_RATE_MS); // pra liberar o core
-    } 
+        estatistica_zera_acumulada(&acumulada[i]);
+    }
 
-    // aguarda task2 finalizar
-    while(eTaskGetState(handler_task2) == eRunning)
+    while(1)
     {
-        vTaskDelay(1 / portTICK_RATE_MS); // pra liberar o core
-    } 
+        lote = lote_aguarda_relatorio();
+
+        RASTRO_INICIO(RASTRO_RELATORIO);
+        inicio = esp_timer_get_time();
+
+        // vazão sustentada desde a partida
+        end_soma = esp_timer_get_time();
+
+        LOG_DIF(MSG_PESO_TOTAL, LOG_F(lote->peso_total));
+        LOG_DIF(MSG_TEMPO_SOMA, LOG_U(lote->fim_reducao_us - lote->inicio_reducao_us));
+        LOG_DIF(MSG_LOTE, LOG_U(lote->numero), LOG_U((lote->fechado_us - lote->inicio_us) / 1000),
+                LOG_F(((float) (lote->numero - lote_inicial + 1) * NUM_MAX_PROD * 1000000) / (end_soma - start_soma)),
+                LOG_U(esperas_buffer));
+
+        // distribuição dos pesos sem reler o lote: Welford feito na inserção
+        for (int i = 0; i < NUM_ESTEIRAS; i++)
+        {
+            const estatistica_t *e = &lote->estatistica[i];
+
+            estatistica_junta(&acumulada[i], e);
+            massa_relatada[i] += (double) e->n * e->media;
+            LOG_DIF(MSG_ESTATISTICA, LOG_S(esteiras[i].nome), LOG_U(e->n), LOG_F(e->media),
+                    LOG_F(estatistica_desvio(e)), LOG_F(e->min), LOG_F(e->max),
+                    LOG_F(acumulada[i].media), LOG_F(sqrt(estatistica_variancia_acumulada(&acumulada[i]))));
+        }
+
+        // p1/p50/p99 exatos do lote e do turno pelo esboço, calculados na redução
+        LOG_DIF(MSG_QUANTIS, LOG_U(lote->numero), LOG_F(lote->quantis[0]), LOG_F(lote->quantis[1]),
+                LOG_F(lote->quantis[2]), LOG_U(lote->produtos_turno), LOG_F(lote->quantis_turno[0]),
+                LOG_F(lote->quantis_turno[1]), LOG_F(lote->quantis_turno[2]));
+
+#if TELEMETRIA_HABILITADA
+        envia_telemetria(lote, (uint32_t) (esp_timer_get_time() - inicio));
+#endif
+
+        // cada sequência de cada esteira em exatamente um lote
+        if (!auditoria_lote(lote) || auditoria.rejeitadas != rejeitadas)
+        {
+            rejeitadas = auditoria.rejeitadas;
+            LOG_DIF(MSG_AUDITORIA, LOG_U(lote->numero), LOG_U(auditoria.lacunas),
+                    LOG_U(auditoria.repetidas), LOG_U(auditoria.rejeitadas),
+                    LOG_U(auditoria.injetadas_lacunas), LOG_U(auditoria.injetadas_repetidas));
+        }
+
+        // checkpoint fora do caminho das esteiras; grava só a cada N lotes ou T s
+        peso_acumulado += lote->peso_total;
+        monta_checkpoint(&checkpoint, lote, peso_acumulado);
+        recuperacao_relatado(&checkpoint);
+
+        if (persistencia_atualiza(&checkpoint))
+        {
+            persistencia_estatisticas(&persistencia);
+            LOG_DIF(MSG_CHECKPOINT, LOG_U(lote->numero), LOG_U(persistencia.ultimo_commit_us),
+                    LOG_U(persistencia.pior_commit_us), LOG_U(persistencia.gravacoes_hora),
+                    LOG_U(persistencia.falhas));
+        }
+
+        // registro permanente do lote no anel da partição de histórico
+        registro.lote = lote->numero;
+        registro.tempo_ms = (uint32_t) (lote->fechado_us / 1000);
+        for (int i = 0; i < NUM_ESTEIRAS; i++)
+        {
+            registro.seq_inicio[i] = lote->seq_inicio[i];
+            registro.contagem[i] = lote->contagem[i];
+        }
+        registro.reservado = 0xFFFF;
+        registro.peso_total = lote->peso_total;
+        registro.reducao_us = (uint32_t) (lote->fim_reducao_us - lote->inicio_reducao_us);
+
+        if (historico_ativo && !historico_acrescenta(&registro))
+        {
+            LOG_DIF(MSG_HISTORICO_FALHOU, LOG_U(lote->numero));
+        }
 
-    printf("Peso total dos produtos = %f\n", peso_total);
-       
-    //zera o peso total
-	peso_total = 0;
+        escalonamento_registra(tarefa_relatorio, (uint32_t) (esp_timer_get_time() - inicio));
+        RASTRO_FIM(RASTRO_RELATORIO);
+
+        if (lote->numero % RASTRO_DESPEJO_LOTES == RASTRO_DESPEJO_LOTES - 1)
+        {
+            rastro_pede_despejo();
+        }
 
-    // resumir as tasks
-    resumir_tasks();
+        lote_libera(lote);
+    }
 }
 
-void soma_produto(float peso)
+// dentro do mutex: produto novo no lote em preenchimento
+static void insere_produto(esteira_t *esteira, uint32_t sequencia, float peso, int64_t inicio_secao)
 {
-    // mutex (semaforo)
-    xSemaphoreTake(mutual_exclusion_mutex, portMAX_DELAY);
+    int i = esteira->id - 1;
 
-    pesos[num_produtos] = peso;
+    if (num_produtos == 0)
+    {
+        lote_atual->inicio_us = inicio_secao;
+        for (int k = 0; k < NUM_ESTEIRAS; k++)
+        {
+            lote_atual->contagem[k] = 0;
+            lote_atual->seq_inicio[k] = seq_esperada[k];
+            lote_atual->seq_fim[k] = seq_esperada[k];
+        }
+    }
+
+    lote_insere(lote_atual, num_produtos, esteira->classe, peso - esteira->peso);
+    lote_atual->contagem[i]++;
+    estatistica_acrescenta(&lote_atual->estatistica[i], peso);
+    lote_atual->seq_fim[i] = sequencia + 1;
+    seq_esperada[i] = sequencia + 1;
+    recuperacao_produto(num_produtos, i, esteira->classe, peso);
     num_produtos++;
 
+    instantaneo_produto(i, num_produtos % NUM_MAX_PROD);
+    metricas_produto(&metricas[i], peso);
+
     if (num_produtos >= NUM_MAX_PROD)
     {
+        // fecha o lote e passa para a redução
+        lote_atual->num_produtos = num_produtos;
+        lote_atual->numero = num_lotes++;
+        recuperacao_fecha_lote();
+        lote_atual->fechado_us = esp_timer_get_time();
+        lote_envia_reducao(lote_atual);
 
-        // inicia soma de peso
-        soma_pesos(); 
+        // sem buffer livre (os três estágios ocupados) fica NULL: quem
+        // inserir o próximo produto espera fora do mutex
+        lote_atual = lote_obtem_livre(0);
 
         num_produtos = 0;
+    }
+}
 
+// toma o mutex das esteiras contando a contenção; retorna o início da seção
+static int64_t toma_mutex(void)
+{
+    int64_t inicio_secao;
 
-        // tempo final 
-        end_soma = esp_timer_get_time();
-
-        // tempo total 
-        total_time = ((double) (end_soma - start_soma)) / 1000000;
+    // conta quantas esteiras disputam o mutex ao mesmo tempo
+    portENTER_CRITICAL(&mux_contencao);
+    esperando_mutex++;
+    if (esperando_mutex > pico_contencao)
+    {
+        pico_contencao = esperando_mutex;
+    }
+    portEXIT_CRITICAL(&mux_contencao);
 
-        printf("Tempo consumido para realizar a soma dos produtos nas esteiras: %f\n", total_time);
+    // mutex (semaforo)
+    if (xSemaphoreTake(mutual_exclusion_mutex, 0) != pdTRUE)
+    {
+        RASTRO_INICIO(RASTRO_ESPERA_MUTEX);
+        num_contencoes++;
+        xSemaphoreTake(mutual_exclusion_mutex, portMAX_DELAY);
+        RASTRO_FIM(RASTRO_ESPERA_MUTEX);
     }
+    inicio_secao = esp_timer_get_time();
+
+    portENTER_CRITICAL(&mux_contencao);
+    esperando_mutex--;
+    portEXIT_CRITICAL(&mux_contencao);
+
+    return inicio_secao;
+}
+
+static void solta_mutex(esteira_t *esteira, int64_t inicio_secao)
+{
+    escalonamento_registra_secao(esteira->tarefa, (uint32_t) (esp_timer_get_time() - inicio_secao));
 
     // end mutex
     xSemaphoreGive(mutual_exclusion_mutex);
 }
 
-void esteira_1(void *pvParameter)
-{    
-    TickType_t xLastWakeTime;
+// toma o mutex com um lote em preenchimento: com o pool vazio espera o
+// relatório devolver um buffer com o mutex solto, para não travar as
+// outras esteiras junto
+static int64_t toma_mutex_com_lote(esteira_t *esteira)
+{
+    int64_t inicio_secao = toma_mutex();
 
-    // tempo atual
-    xLastWakeTime = xTaskGetTickCount ();
+    while (lote_atual == NULL)
+    {
+        lote_t *livre = lote_obtem_livre(0);
 
-	while(1)
-	{
-        // aguardar produto
-        vTaskDelayUntil(&xLastWakeTime, TEMPO_EST_1 / portTICK_RATE_MS);
+        if (livre == NULL)
+        {
+            esperas_buffer++;
+            solta_mutex(esteira, inicio_secao);
+            livre = lote_obtem_livre(portMAX_DELAY);
+            inicio_secao = toma_mutex();
+        }
 
-	    // somar produto
-        soma_produto(PESO_EST_1);
-	}
+        // outra esteira pode ter posto um buffer enquanto esta esperava
+        if (lote_atual == NULL)
+        {
+            lote_atual = livre;
+        } else if (livre != NULL)
+        {
+            lote_libera(livre);
+        }
+    }
+
+    return inicio_secao;
 }
 
-void esteira_2(void *pvParameter)
+// dentro do mutex: insere ou descarta a repetição
+static void aceita_produto(esteira_t *esteira, uint32_t sequencia, float peso, int64_t inicio_secao)
 {
-    TickType_t xLastWakeTime;
+    // repetição: o produto já está em algum lote
+    if ((int32_t) (sequencia - seq_esperada[esteira->id - 1]) < 0)
+    {
+        auditoria_rejeita();
+    } else
+    {
+        insere_produto(esteira, sequencia, peso, inicio_secao);
+    }
+}
 
-    // tempo atual
-    xLastWakeTime = xTaskGetTickCount ();
+// estágio 1: insere o produto no lote em preenchimento; a decisão do
+// ejetor sai antes do mutex para não esperar pela contenção do lote
+void soma_produto(esteira_t *esteira, uint32_t sequencia, float peso, int64_t evento_us)
+{
+    int64_t inicio_secao;
 
-    while(1)
-	{
-         // aguardar produto
-        vTaskDelayUntil(&xLastWakeTime, TEMPO_EST_2 / portTICK_RATE_MS);
+    RASTRO_INICIO(RASTRO_SOMA_PRODUTO);
 
-	    // somar produto
-        soma_produto(PESO_EST_2);
-	}
+    rejeicao_decide(&esteira->rejeicao, peso, evento_us);
+    serie_acrescenta(&esteira->serie, 1, peso, evento_us);
+
+    inicio_secao = toma_mutex_com_lote(esteira);
+    aceita_produto(esteira, sequencia, peso, inicio_secao);
+    solta_mutex(esteira, inicio_secao);
+
+    RASTRO_FIM(RASTRO_SOMA_PRODUTO);
 }
 
-void esteira_3(void *pvParameter)
+// estágio 1 em lote: n produtos de peso fixo com uma só tomada do mutex
+void soma_produtos(esteira_t *esteira, uint32_t n, int64_t evento_us)
 {
+    int64_t inicio_secao;
+
+    RASTRO_INICIO(RASTRO_SOMA_PRODUTO);
+
+    for (uint32_t k = 0; k < n; k++)
+    {
+        rejeicao_decide(&esteira->rejeicao, esteira->peso, evento_us);
+    }
+    serie_acrescenta(&esteira->serie, n, n * esteira->peso, evento_us);
+
+    inicio_secao = toma_mutex_com_lote(esteira);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        // o lote fechou no meio e não havia outro buffer
+        if (lote_atual == NULL)
+        {
+            solta_mutex(esteira, inicio_secao);
+            inicio_secao = toma_mutex_com_lote(esteira);
+        }
+        aceita_produto(esteira, auditoria_sequencia(esteira), esteira->peso, inicio_secao);
+    }
+    solta_mutex(esteira, inicio_secao);
+
+    RASTRO_FIM(RASTRO_SOMA_PRODUTO);
+}
+
+// fim do job da esteira: tempo de resposta, telemetria e pior latência
+static void registra_job(esteira_t *est, uint32_t duracao)
+{
+    escalonamento_registra(est->tarefa, duracao);
+    telemetria_latencia(duracao);
+    if (duracao > est->latencia_max_us)
+    {
+        est->latencia_max_us = duracao;
+    }
+}
+
+#if PESAGEM_HABILITADA
+// callback de bloco do sensor: detecção e inserção dos produtos assentados
+static void bloco_esteira(void *ctx, const float *amostras, int n)
+{
+    esteira_t *est = (esteira_t *) ctx;
+    pesagem_produto_t produtos[PESAGEM_MAX_PRODUTOS];
+    int64_t inicio = esp_timer_get_time();
+    int k = pesagem_processa(&est->pesagem, amostras, n, produtos, PESAGEM_MAX_PRODUTOS);
+
+    // o bloco chega junto com a última amostra: o peso saiu tantas amostras antes
+    for (int j = 0; j < k; j++)
+    {
+        int64_t evento_us = inicio - (int64_t) (est->pesagem.amostras - produtos[j].amostra) *
+                            1000000 / PESAGEM_TAXA_HZ;
+
+        soma_produto(est, auditoria_sequencia(est), produtos[j].peso, evento_us);
+    }
+
+    registra_job(est, (uint32_t) (esp_timer_get_time() - inicio));
+}
+#endif
+
+void esteira(void *pvParameter)
+{    
+    esteira_t *est = (esteira_t *) pvParameter;
     TickType_t xLastWakeTime;
 
-    // tempo atual
-    xLastWakeTime = xTaskGetTickCount ();
+    // aguarda todas as tarefas serem criadas
+    xEventGroupWaitBits(grupo_eventos, EVENTO_PARTIDA, pdFALSE, pdTRUE, portMAX_DELAY);
+
+    // época comum mais a fase da esteira
+    xLastWakeTime = epoca_partida + est->fase_ms / portTICK_RATE_MS;
 
+#if PESAGEM_HABILITADA
+    float amostras[PESAGEM_BLOCO];
+
+    // um bloco da célula por vez; produto quando o peso assenta
+    sensor_executa(&est->sensor, amostras, PESAGEM_BLOCO, xLastWakeTime, bloco_esteira, est);
+#elif CONTADOR_HABILITADO
+    // o PCNT conta; a tarefa só acorda a cada leitura, com quantos produtos houver
     while(1)
+    {
+        vTaskDelayUntil(&xLastWakeTime, CONTADOR_PERIODO_MS / portTICK_RATE_MS);
+
+        int64_t inicio = esp_timer_get_time();
+        uint32_t n = contador_delta(&est->contador);
+        if (n > 0)
+        {
+            soma_produtos(est, n, inicio);
+        }
+        registra_job(est, (uint32_t) (esp_timer_get_time() - inicio));
+    }
+#elif INGESTAO_HABILITADA
+    // o ritmo é o da interrupção, sem época nem fase
+    (void) xLastWakeTime;
+
+    // um despertar recolhe todas as interrupções desde o anterior
+    while(1)
+    {
+        uint32_t n = ingestao_aguarda(&est->ingestao, portMAX_DELAY);
+
+        int64_t inicio = esp_timer_get_time();
+        soma_produtos(est, n, est->ingestao.evento_us);
+        registra_job(est, (uint32_t) (esp_timer_get_time() - inicio));
+    }
+#else
+	while(1)
 	{
-         // aguardar produto
-        vTaskDelayUntil(&xLastWakeTime, TEMPO_EST_3 / portTICK_RATE_MS);
+        // aguardar produto
+        vTaskDelayUntil(&xLastWakeTime, est->periodo_ms / portTICK_RATE_MS);
 
 	    // somar produto
-        soma_produto(PESO_EST_3);
+        int64_t inicio = esp_timer_get_time();
+        soma_produto(est, auditoria_sequencia(est), est->peso, inicio);
+        registra_job(est, (uint32_t) (esp_timer_get_time() - inicio));
 	}
+#endif
 }
 
 
  
+void imprime_contencao()
+{
+    uint32_t pior = 0;
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        if (esteiras[i].latencia_max_us > pior)
+        {
+            pior = esteiras[i].latencia_max_us;
+        }
+    }
+
+    LOG_DIF(MSG_CONTENCAO, LOG_U(num_contencoes), LOG_D(pico_contencao), LOG_U(pior));
+}
+
+// a tabela de escalonamento_imprime pelo log diferido, para as tarefas
+// (o período não cabe nos argumentos e não muda depois da partida)
+static void registra_escalonamento(const conjunto_tarefas_t *c)
+{
+    for (int i = 0; i < c->num_tarefas; i++)
+    {
+        const tarefa_periodica_t *t = &c->tarefas[i];
+
+        LOG_DIF(MSG_ESCALONAMENTO, LOG_S(t->nome), LOG_U(t->wcet_us),
+                LOG_U(escalonamento_bloqueio(c, i)), LOG_U(t->prioridade), LOG_D(t->core),
+                LOG_U(t->resposta_us), LOG_U(t->resposta_medida_us),
+                LOG_S(t->resposta_us == 0 ? "  PERDE DEADLINE" :
+                      t->resposta_medida_us > t->resposta_us ? "  ACIMA DO R" : ""));
+    }
+
+    for (int core = 0; core < c->num_cores; core++)
+    {
+        int n = 0;
+
+        for (int i = 0; i < c->num_tarefas; i++)
+        {
+            n += c->tarefas[i].core == core;
+        }
+
+        float limite = n > 0 ? n * (powf(2.0f, 1.0f / n) - 1.0f) : 1.0f;
+
+        LOG_DIF(MSG_ESCALONAMENTO_CORE, LOG_D(core), LOG_D(n), LOG_F(c->utilizacao[core]),
+                LOG_F(limite));
+    }
+}
+
 void display(void *pvParameter)
 {    
+    bool escalonavel = true;
+    int64_t inicio;
+    int64_t anterior = esp_timer_get_time();
+    instantaneo_t estado;
+    float taxas[NUM_ESTEIRAS];
+    serie_ponto_t minutos[2], horas[SERIE_HORAS];
+    uint32_t dia;
+    uint64_t dia_g;
+#if RECUPERACAO_TESTE
+    int64_t prazo_teste = anterior + (int64_t) (esp_random() % RECUPERACAO_TESTE_MAX_MS) * 1000;
+#endif
+
     while(1) 
     {
         vTaskDelay(TEMPO_ATUALIZACAO / portTICK_RATE_MS);
-        printf("Quantidade produtos %d\n", num_produtos);
+
+        RASTRO_INICIO(RASTRO_DISPLAY);
+        inicio = esp_timer_get_time();
+
+        // taxas do intervalo desde o refresh anterior
+        metricas_atualiza(metricas, NUM_ESTEIRAS, (uint32_t) (inicio - anterior));
+        anterior = inicio;
+
+        for (int i = 0; i < NUM_ESTEIRAS; i++)
+        {
+            taxas[i] = metricas[i].taxa_ewma;
+        }
+        instantaneo_taxas(taxas);
+
+        // cópia consistente sem tocar no mutex das esteiras
+        instantaneo_le(&estado);
+
+        // só registra; a tarefa de log formata e escreve depois
+        LOG_DIF(MSG_QUANTIDADE, LOG_D(estado.produtos_lote));
+
+        for (int i = 0; i < NUM_ESTEIRAS; i++)
+        {
+            metricas_esteira_t *m = &metricas[i];
+
+            LOG_DIF(MSG_ESTEIRA, LOG_S(esteiras[i].nome), LOG_U(estado.contagem[i]),
+                    LOG_F(m->massa), LOG_F(m->taxa_ewma), LOG_F(m->taxa_janela),
+                    LOG_F(m->taxa_nominal), LOG_F(m->massa_ewma), LOG_F(m->massa_janela));
+
+            rejeicao_t *r = &esteiras[i].rejeicao;
+
+            LOG_DIF(MSG_REJEICAO, LOG_S(esteiras[i].nome), LOG_U(r->aceitos), LOG_U(r->abaixo),
+                    LOG_U(r->acima), LOG_U(r->atrasados), LOG_U(r->atrasados_fora),
+                    LOG_U(rejeicao_percentil_us(r, 0.99f)), LOG_U(r->latencia_max_us));
+
+            // minuto anterior (fechado) e o dia até agora, direto dos anéis
+            serie_consulta(&esteiras[i].serie, SERIE_MINUTO, inicio, minutos, 2);
+            serie_consulta(&esteiras[i].serie, SERIE_HORA, inicio, horas, SERIE_HORAS);
+            dia = 0;
+            dia_g = 0;
+            for (int h = 0; h < SERIE_HORAS; h++)
+            {
+                dia += horas[h].contagem;
+                dia_g += horas[h].massa_g;
+            }
+            LOG_DIF(MSG_SERIE, LOG_S(esteiras[i].nome), LOG_U(minutos[0].contagem),
+                    LOG_F(minutos[0].massa_g / 1000.0f), LOG_U(dia), LOG_F(dia_g / 1000.0));
+#if PESAGEM_HABILITADA
+            // leitura solta: contadores de 32 bits escritos só pela esteira
+            LOG_DIF(MSG_PESAGEM, LOG_S(esteiras[i].nome),
+                    LOG_U(esteiras[i].pesagem.latencia_max * 1000 / PESAGEM_TAXA_HZ),
+                    LOG_U(esteiras[i].pesagem.falsos), LOG_U(esteiras[i].pesagem.descartados));
+#endif
+#if INGESTAO_HABILITADA
+            ingestao_t *g = &esteiras[i].ingestao;
+
+            LOG_DIF(MSG_INGESTAO, LOG_S(esteiras[i].nome), LOG_U(g->interrupcoes),
+                    LOG_F(g->despertares ? (float) g->produtos / g->despertares : 0.0f),
+                    LOG_U(g->latencia_max_us));
+#endif
+        }
+
+        LOG_DIF(MSG_ULTIMO_LOTE, LOG_U(estado.lote), LOG_F(estado.ultimo_total));
+
+        if (!instantaneo_consistente(&estado))
+        {
+            LOG_MSG(MSG_RASGADA);
+        }
+
+        imprime_contencao();
+
+#if RECUPERACAO_TESTE
+        // reinicia entre dois produtos; a partida confere a contagem
+        if (inicio >= prazo_teste)
+        {
+            xSemaphoreTake(mutual_exclusion_mutex, portMAX_DELAY);
+            recuperacao_teste_reinicia();
+        }
+#endif
+
+        // sem lote novo o relatório não grava: o prazo do checkpoint vence aqui
+        persistencia_periodica();
+
+        escalonamento_registra(tarefa_display, (uint32_t) (esp_timer_get_time() - inicio));
+        RASTRO_FIM(RASTRO_DISPLAY);
+
+        // refaz a análise só quando algum pior caso medido cresceu
+        if (escalonamento_medicao_mudou(&tarefas_sistema) &&
+            escalonamento_analisa(&tarefas_sistema, true) != escalonavel)
+        {
+            escalonavel = !escalonavel;
+            LOG_MSG(escalonavel ? MSG_ESCALONAVEL : MSG_NAO_ESCALONAVEL);
+            registra_escalonamento(&tarefas_sistema);
+        }
     }
 }
  
@@ -261,46 +870,363 @@ static void tp_example_touch_pad_init(void)
 static void tp_example_read_task(void *pvParameter)
 {
     uint16_t touch_value;    
+    int64_t inicio;
 #if TOUCH_FILTER_MODE_EN
-    printf("Touch Sensor filter mode read, the output format is: \nTouchpad num:[raw data, filtered data]\n\n");
+    formato_externo(printf("Touch Sensor filter mode read, the output format is: \nTouchpad num:[raw data, filtered data]\n\n"));
 #else
-    printf("Touch Sensor normal mode read, the output format is: \nTouchpad num:[raw data]\n\n");
+    formato_externo(printf("Touch Sensor normal mode read, the output format is: \nTouchpad num:[raw data]\n\n"));
 #endif
     while (1) 
     {
+        RASTRO_INICIO(RASTRO_TOUCH);
+        inicio = esp_timer_get_time();
 
 #if TOUCH_FILTER_MODE_EN
             // If open the filter mode, please use this API to get the touch pad count.
             touch_pad_read_raw_data(i, &touch_value);
             touch_pad_read_filtered(i, &touch_filter_value);
-            printf("T%d:[%4d,%4d] ", i, touch_value, touch_filter_value);
+            formato_externo(printf("T%d:[%4d,%4d] ", i, touch_value, touch_filter_value));
 #else
             touch_pad_read(0, &touch_value);
             if(touch_value < 1000)
             {
-                printf("Desligando\n");
-                printf("Reinicie para começar o programa novamente\n");
+                LOG_MSG(MSG_DESLIGANDO);
+
+                // o reinício perderia o que ainda não foi gravado
+                if (!persistencia_grava())
+                {
+                    LOG_MSG(MSG_CHECKPOINT_FALHOU);
+                }
+
+                LOG_MSG(MSG_REINICIE);
 
-                vTaskDelete(handler_est1);
-                vTaskDelete(handler_est2);
-                vTaskDelete(handler_est3);
+                for (int i = 0; i < NUM_ESTEIRAS; i++)
+                {
+#if INGESTAO_HABILITADA
+                    // a ISR notificaria uma tarefa apagada
+                    ingestao_para(&esteiras[i].ingestao);
+#endif
+                    vTaskDelete(esteiras[i].handler);
+                }
                 vTaskDelete(handler_display);
                 vTaskDelete(handler_touch);
             }
 #endif
+            escalonamento_registra(tarefa_touch, (uint32_t) (esp_timer_get_time() - inicio));
+            RASTRO_FIM(RASTRO_TOUCH);
+
             if(touch_value < (uint16_t)100)
             {
-                printf("\nSistema de Emergência Acinado");
+                LOG_MSG(MSG_EMERGENCIA);
                 vTaskDelay(2000/portTICK_PERIOD_MS);
             }
-        
-        vTaskDelay(200 / portTICK_PERIOD_MS);
+        vTaskDelay(TEMPO_TOUCH / portTICK_PERIOD_MS);
     }
 } 
  
 
 
 
+// distribui as fases das esteiras pelos ticks do hiperperiodo
+static void calcula_fases(void)
+{
+#if ESTEIRAS_DEFASADAS && FASE_AUTOMATICA
+    uint32_t periodos[NUM_ESTEIRAS], fases[NUM_ESTEIRAS];
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        periodos[i] = esteiras[i].periodo_ms;
+    }
+
+    escalonamento_fases(periodos, fases, NUM_ESTEIRAS, portTICK_RATE_MS);
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        esteiras[i].fase_ms = fases[i];
+    }
+#elif !ESTEIRAS_DEFASADAS
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        esteiras[i].fase_ms = 0;
+    }
+#endif
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        printf("%s: periodo %u ms, fase %u ms\n", esteiras[i].nome,
+               esteiras[i].periodo_ms, esteiras[i].fase_ms);
+    }
+}
+
+// mede o pior caso de uma repetição de func (em us)
+static uint32_t mede_wcet(void (*func)(void))
+{
+    uint32_t pior = 0;
+
+    for (int i = 0; i < ESCALONAMENTO_AMOSTRAS; i++)
+    {
+        int64_t inicio = esp_timer_get_time();
+        func();
+        uint32_t duracao = (uint32_t) (esp_timer_get_time() - inicio);
+
+        if (duracao > pior)
+        {
+            pior = duracao;
+        }
+    }
+
+    return pior * ESCALONAMENTO_MARGEM + 1;
+}
+
+// trechos medidos na partida, sem efeito no estado das esteiras
+static volatile float vetor_calibracao[NUM_MAX_PROD];
+
+static void calibra_insercao(void)
+{
+    static int i = 0;
+
+    xSemaphoreTake(mutual_exclusion_mutex, portMAX_DELAY);
+    vetor_calibracao[i] = PESO_EST_1;
+    i = (i + 1) % NUM_MAX_PROD;
+    xSemaphoreGive(mutual_exclusion_mutex);
+}
+
+static void calibra_soma(void)
+{
+    volatile float resultado = 0;
+
+    for (int j = 0; j < NUM_MAX_PROD; j++)
+    {
+        resultado += vetor_calibracao[j];
+    }
+}
+
+// quantis exatos de um lote cheio de classes embaralhadas e os pesos no
+// esboço do turno (lote_quantis)
+static void calibra_quantis(void)
+{
+    static lote_t lote;
+    static quantil_t turno;
+
+    if (turno.n == 0)
+    {
+        quantil_inicia(&turno, 1);
+    }
+    lote.num_produtos = NUM_MAX_PROD;
+    for (int j = 0; j < NUM_MAX_PROD; j++)
+    {
+        LOTE_CODIGO_GRAVA(lote.codigos, j, esteiras[(j * 7) % NUM_ESTEIRAS].classe);
+    }
+    lote_quantis(&lote, &turno);
+}
+
+static void calibra_display(void)
+{
+    char buffer[64];
+    linha_t l;
+
+    linha_inicia(&l, buffer, sizeof(buffer));
+    linha_texto(&l, "Quantidade produtos ");
+    linha_i32(&l, num_produtos);
+    linha_decimal(&l, PESO_EST_1, 3);
+    linha_nova(&l);
+}
+
+#if PESAGEM_HABILITADA
+static void calibra_pesagem(void)
+{
+    static pesagem_t p;
+    static pesagem_gerador_t g;
+    static float amostras[PESAGEM_BLOCO];
+    pesagem_produto_t produtos[PESAGEM_MAX_PRODUTOS];
+
+    if (g.periodo == 0)
+    {
+        pesagem_inicia(&p, PESAGEM_TAXA_HZ);
+        pesagem_gerador_inicia(&g, PESAGEM_TAXA_HZ, TEMPO_EST_3, 0, PESO_EST_3, 1);
+    }
+
+    pesagem_gera(&g, amostras, PESAGEM_BLOCO);
+    pesagem_processa(&p, amostras, PESAGEM_BLOCO, produtos, PESAGEM_MAX_PRODUTOS);
+}
+#endif
+
+static void calibra_touch(void)
+{
+    uint16_t touch_value;
+
+    touch_pad_read(0, &touch_value);
+}
+
+#if PESAGEM_HABILITADA
+// fonte de amostras da esteira i; cai no gerador sintético (mesmo ritmo
+// e fase da esteira) se a fonte configurada não estiver disponível
+static void inicia_sensor(esteira_t *est, int i)
+{
+    bool ok = false;
+
+#if SENSOR_FONTE == SENSOR_ADC_DMA
+    if (i == 0)
+    {
+        ok = sensor_inicia_adc(&est->sensor, PESAGEM_TAXA_HZ, PESAGEM_BLOCO);
+    }
+#elif SENSOR_FONTE == SENSOR_REPLAY
+    // cada esteira começa em um ponto diferente do mesmo traço
+    ok = sensor_inicia_traco(&est->sensor, PESAGEM_TAXA_HZ, i * 7919 * PESAGEM_BLOCO);
+    if (!ok)
+    {
+        printf("%s: sem traço válido a %d Hz na partição, usando o gerador\n",
+               est->nome, PESAGEM_TAXA_HZ);
+    }
+#endif
+
+    if (!ok)
+    {
+        sensor_inicia_sintetico(&est->sensor, PESAGEM_TAXA_HZ, est->periodo_ms, est->fase_ms,
+                                est->peso, i + 1);
+    }
+}
+#endif
+
+#if CONTADOR_HABILITADO || INGESTAO_HABILITADA
+// fotocélulas das esteiras (entrada do PCNT ou das interrupções)
+static const int gpio_fotocelula[NUM_ESTEIRAS] = {25, 26, 27};
+#endif
+
+// ejetores da rejeição (REJEICAO_ATUADOR)
+static const int gpio_ejetor[NUM_ESTEIRAS] = {19, 21, 22};
+
+#if CONTADOR_HABILITADO
+// uma unidade do PCNT por esteira; sem ela, o simulador no ritmo da esteira
+static void inicia_contador(esteira_t *est, int i)
+{
+#if !CONTADOR_SIMULADO
+    if (contador_inicia_pcnt(&est->contador, i, gpio_fotocelula[i]))
+    {
+        return;
+    }
+    printf("%s: PCNT %d não configurou, usando o simulador\n", est->nome, i);
+#endif
+
+    contador_inicia_simulado(&est->contador, est->periodo_ms, i + 1);
+}
+#endif
+
+#if INGESTAO_HABILITADA
+// interrupções para a tarefa já criada da esteira i; um timer por esteira
+// no modo simulado (o ESP32 tem 4)
+static void inicia_ingestao(esteira_t *est, int i)
+{
+    bool ok;
+
+#if INGESTAO_SIMULADA
+    ok = ingestao_inicia_simulada(&est->ingestao, i, est->periodo_ms * 1000, est->handler);
+#else
+    ok = ingestao_inicia_gpio(&est->ingestao, gpio_fotocelula[i], est->handler);
+#endif
+
+    if (!ok)
+    {
+        printf("%s: interrupção não configurou, esteira parada\n", est->nome);
+    }
+}
+#endif
+
+// entrada nova na análise; sem espaço a partida não tem como seguir
+static tarefa_periodica_t *adiciona_tarefa(const char *nome, uint32_t periodo_us, uint32_t wcet_us,
+                                           uint32_t secao_critica_us, bool usa_recurso)
+{
+    tarefa_periodica_t *t = escalonamento_adiciona(&tarefas_sistema, nome, periodo_us, wcet_us,
+                                                   secao_critica_us, usa_recurso);
+
+    if (t == NULL)
+    {
+        printf("Erro: %s não cabe nas %d tarefas da análise de escalonamento\n", nome,
+               ESCALONAMENTO_MAX_TAREFAS);
+        exit(0);
+    }
+
+    return t;
+}
+
+// monta o conjunto de tarefas, atribui prioridades e cores
+static bool analisa_escalonamento(void)
+{
+    uint32_t insercao = mede_wcet(calibra_insercao);
+    uint32_t soma = mede_wcet(calibra_soma);
+    uint32_t quantis = mede_wcet(calibra_quantis);
+
+    escalonamento_inicia(&tarefas_sistema, portNUM_PROCESSORS);
+
+    // a soma do lote saiu do job da esteira: a inserção só segura o mutex
+    // para gravar o peso e, ao fechar o lote, trocar o buffer
+    float produtos_por_s = 0;
+
+#if PESAGEM_HABILITADA
+    // job = um bloco da célula mais, no pior caso, todos os produtos que ele pode emitir
+    uint32_t bloco = mede_wcet(calibra_pesagem);
+#endif
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+#if PESAGEM_HABILITADA
+        esteiras[i].tarefa = adiciona_tarefa(esteiras[i].nome,
+                                             PESAGEM_PERIODO_BLOCO_MS * 1000,
+                                             bloco + PESAGEM_MAX_PRODUTOS * insercao,
+                                             insercao, true);
+#elif CONTADOR_HABILITADO
+        // uma leitura por periodo; a seção cresce com os produtos acumulados
+        uint32_t por_leitura = CONTADOR_PERIODO_MS / esteiras[i].periodo_ms + 1;
+
+        esteiras[i].tarefa = adiciona_tarefa(esteiras[i].nome,
+                                             CONTADOR_PERIODO_MS * 1000,
+                                             por_leitura * insercao,
+                                             por_leitura * insercao, true);
+#else
+        esteiras[i].tarefa = adiciona_tarefa(esteiras[i].nome,
+                                             esteiras[i].periodo_ms * 1000,
+                                             insercao, insercao, true);
+#endif
+        produtos_por_s += 1000.0f / esteiras[i].periodo_ms;
+    }
+
+    // redução e relatório são esporádicos, no máximo um lote por periodo de enchimento
+    uint32_t periodo_lote_us = (uint32_t) (NUM_MAX_PROD * 1000000.0f / produtos_por_s);
+
+#if REDUCAO_TRABALHADORES
+    tarefa_reducao = adiciona_tarefa("reducao", periodo_lote_us,
+                                     soma / REDUCAO_NUM_TRABALHADORES + 1 + quantis, 0, false);
+    tarefa_reducao->core_fixo = APP_CPU_NUM;
+
+    // cada trabalhador soma no máximo um pedaço por lote no seu core
+    for (int i = 0; i < REDUCAO_NUM_TRABALHADORES; i++)
+    {
+        tarefa_periodica_t *t = adiciona_tarefa(reducao_nome(i), periodo_lote_us, soma, 0, false);
+        t->core_fixo = i % portNUM_PROCESSORS;
+    }
+#else
+    // sem trabalhadores o estágio só percorre as classes, menos que somar o
+    // lote, e ordena os pesos para os quantis do lote e do turno
+    tarefa_reducao = adiciona_tarefa("reducao", periodo_lote_us, soma + quantis, 0, false);
+    tarefa_reducao->core_fixo = APP_CPU_NUM;
+#endif
+    tarefa_relatorio = adiciona_tarefa("relatorio", periodo_lote_us,
+                                       mede_wcet(calibra_display), 0, false);
+
+    tarefa_touch = adiciona_tarefa("touch", TEMPO_TOUCH * 1000,
+                                   mede_wcet(calibra_touch), 0, false);
+    tarefa_display = adiciona_tarefa("display", TEMPO_ATUALIZACAO * 1000,
+                                     mede_wcet(calibra_display), 0, false);
+
+    escalonamento_atribui_rm(&tarefas_sistema, PRIORIDADE_MIN, PRIORIDADE_MAX);
+
+    bool escalonavel = escalonamento_particiona(&tarefas_sistema);
+
+    escalonamento_imprime(&tarefas_sistema);
+
+    return escalonavel;
+}
+
 /*
 
 MAIN FUNCTION
@@ -308,11 +1234,43 @@ MAIN FUNCTION
 */ 
 void app_main()
 {
-    nvs_flash_init();
+    persistencia_estatisticas_t persistencia;
+    recuperacao_info_t recuperacao;
+    esp_err_t erro = nvs_flash_init();
+
+    // partição cheia ou de outra versão da NVS: apaga e recomeça
+    if (erro == ESP_ERR_NVS_NO_FREE_PAGES || erro == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        nvs_flash_erase();
+        nvs_flash_init();
+    }
+
+    // console pelo driver da UART, escrita do display sem bloquear
+    formato_inicia();
+
+#if FORMATO_BENCHMARK
+    formato_benchmark();
+#endif
+
+    // mensagens das tarefas passam pelo anel do log diferido
+    if (!log_inicia())
+    {
+        printf("Erro na criação da tarefa de log\n");
+        exit(0);
+    }
+
+    if (!rastro_inicia())
+    {
+        printf("Erro na criação da tarefa do rastro\n");
+        exit(0);
+    }
+
+#if LOG_BENCHMARK
+    log_benchmark();
+#endif
 
     // inicializa semáforo
     mutual_exclusion_mutex = xSemaphoreCreateMutex();
-    mutual_exclusion_mutex_soma = xSemaphoreCreateMutex();
 
     if( mutual_exclusion_mutex == NULL )
     {
@@ -320,12 +1278,89 @@ void app_main()
         exit(0);
     }
     
-    if( mutual_exclusion_mutex_soma == NULL )
+    grupo_eventos = xEventGroupCreate();
+    if( grupo_eventos == NULL )
     {
-        printf("Erro na criação do mutex\n");
+        printf("Erro na criação do grupo de eventos\n");
+        exit(0);
+    }
+
+    if( !lote_inicia_pipeline() )
+    {
+        printf("Erro na criação do pipeline de lotes\n");
         exit(0);
     }
 
+    lote_atual = lote_obtem_livre(0);
+    if (lote_atual == NULL)
+    {
+        printf("Erro: pool de lotes vazio na partida\n");
+        exit(0);
+    }
+
+    // checkpoint da NVS; a RTC o substitui se o reset a preservou
+    if (!persistencia_inicia(&checkpoint_base))
+    {
+        // segue sem checkpoint: as contagens recomeçam do zero a cada partida
+        printf("AVISO: NVS indisponível, checkpoint desligado\n");
+    }
+    persistencia_estatisticas(&persistencia);
+    printf("Checkpoint: %u lotes, %.3f kg acumulados, %s em %u us\n",
+           checkpoint_base.lotes, checkpoint_base.peso_acumulado,
+           persistencia.restaurado ? "restaurado" : "nenhum", persistencia.restauracao_us);
+
+    // dicionário dos lotes: uma classe por peso de esteira
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        esteiras[i].classe = lote_classe(esteiras[i].peso);
+        if (esteiras[i].classe < 0)
+        {
+            printf("Erro: mais de %d pesos distintos nas esteiras\n", LOTE_MAX_CLASSES);
+            exit(0);
+        }
+    }
+
+    recuperacao_inicia(&checkpoint_base, &recuperacao);
+    if (recuperacao.retomado)
+    {
+        printf("Retomada pela RTC (reset %d) em %u us: %u produtos, %u em %u lotes não relatados\n",
+               recuperacao.motivo, recuperacao.tempo_us, recuperacao.produtos,
+               recuperacao.produtos_pendentes, recuperacao.lotes_pendentes);
+    }
+
+    if (recuperacao.teste)
+    {
+        printf("Teste de retomada: esperado %u, restaurado %u: %s\n", recuperacao.esperado,
+               recuperacao.produtos, recuperacao.esperado == recuperacao.produtos ? "OK" : "DIVERGE");
+    }
+
+    // continua os totais dos lotes relatados; a auditoria parte do primeiro
+    // produto não relatado, então um lote do diário que se perdeu aparece
+    // como lacuna no relatório
+    lote_inicial = checkpoint_base.lotes;
+    if (lote_inicial > 0)
+    {
+        instantaneo_lote(lote_inicial - 1, checkpoint_base.ultimo_total);
+    }
+    auditoria_inicia(checkpoint_base.contagem);
+
+    historico_ativo = historico_inicia();
+
+    if (historico_ativo)
+    {
+        historico_estatisticas_t historico;
+
+#if HISTORICO_BENCHMARK
+        historico_benchmark();
+#endif
+
+        historico_estatisticas(&historico);
+        printf("Histórico: %u registros em %u setores, varredura em %u us\n",
+               historico.registros, historico.setores, historico.varredura_us);
+    } else
+    {
+        printf("Partição de histórico não encontrada, lotes não serão gravados\n");
+    }
 
     // Inicializa o touch
     touch_pad_init();
@@ -337,23 +1372,150 @@ void app_main()
         touch_pad_filter_start(TOUCHPAD_FILTER_TOUCH_PERIOD);
     #endif
 
+    // análise rate-monotonic antes de criar as tarefas
+    if (!analisa_escalonamento())
+    {
+        printf("Conjunto de tarefas não escalonável\n");
+#if ESCALONAMENTO_RECUSAR_INICIO
+        return;
+#endif
+    }
+
     // Start task to read values sensed by pads
-    xTaskCreate(&tp_example_read_task, "touch_pad_read_task", 2048, NULL, 5, &handler_touch);
+    xTaskCreatePinnedToCore(&tp_example_read_task, "touch_pad_read_task", 2048, NULL,
+                            tarefa_touch->prioridade, &handler_touch, tarefa_touch->core);
     configASSERT(handler_touch);
 
-    xTaskCreate(&esteira_1, "esteira_1", 2048, NULL, 3, &handler_est1);
-    configASSERT(handler_est1);
+    calcula_fases();
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        metricas_inicia(&metricas[i], esteiras[i].periodo_ms);
+        serie_inicia(&esteiras[i].serie, esp_timer_get_time());
+
+        if (!rejeicao_inicia(&esteiras[i].rejeicao, esteiras[i].peso, REJEICAO_TOLERANCIA,
+                             REJEICAO_PRAZO_US, gpio_ejetor[i]))
+        {
+            printf("%s: ejetor no GPIO %d não configurou, só contando\n", esteiras[i].nome, gpio_ejetor[i]);
+            rejeicao_inicia(&esteiras[i].rejeicao, esteiras[i].peso, REJEICAO_TOLERANCIA,
+                            REJEICAO_PRAZO_US, -1);
+        }
+    }
+
+#if METRICAS_BENCHMARK
+    metricas_benchmark();
+#endif
+
+#if PESAGEM_BENCHMARK
+    pesagem_benchmark();
+#endif
+
+#if SENSOR_BENCHMARK
+    sensor_benchmark();
+#endif
+
+#if CONTADOR_BENCHMARK
+    contador_benchmark();
+#endif
+
+#if INGESTAO_BENCHMARK
+    ingestao_benchmark();
+#endif
+
+#if ESTATISTICA_BENCHMARK
+    estatistica_benchmark();
+#endif
+
+#if QUANTIL_BENCHMARK
+    quantil_benchmark();
+#endif
+
+#if REJEICAO_BENCHMARK
+    rejeicao_benchmark();
+#endif
+
+#if SERIE_BENCHMARK
+    serie_benchmark();
+#endif
+
+#if REDUCAO_TRABALHADORES
+    // trabalhadores da redução na mesma prioridade do estágio
+    if (!reducao_inicia(REDUCAO_NUM_TRABALHADORES, tarefa_reducao->prioridade))
+    {
+        printf("Erro na criação dos trabalhadores da redução\n");
+        exit(0);
+    }
+#endif
+
+#if REDUCAO_BENCHMARK
+    reducao_benchmark();
+#endif
+
+#if LOTE_BENCHMARK
+    lote_benchmark();
+#endif
+
+#if COMPRESSAO_BENCHMARK
+    compressao_benchmark();
+#endif
 
-    xTaskCreate(&esteira_2, "esteira_2", 2048, NULL, 3, &handler_est2);
-    configASSERT(handler_est2);
+    // estágios de redução (core de redução) e relatório
+    xTaskCreatePinnedToCore(&reducao, "reducao", 2048, NULL, tarefa_reducao->prioridade,
+                            &handler_reducao, tarefa_reducao->core);
+    configASSERT(handler_reducao);
 
-    xTaskCreate(&esteira_3, "esteira_3", 2048, NULL, 3, &handler_est3);
-    configASSERT(handler_est2);
+    xTaskCreatePinnedToCore(&relatorio, "relatorio", 3072, NULL, tarefa_relatorio->prioridade,
+                            &handler_relatorio, tarefa_relatorio->core);
+    configASSERT(handler_relatorio);
 
-    // tempo atual
+    // tempo atual (o relatório dos lotes devolvidos já mede a vazão)
     start_soma = esp_timer_get_time();
-    
-    xTaskCreate(&display, "display", 2048, NULL, 1, &handler_display);
+
+    // lotes fechados que o relatório não somou antes do reset voltam ao
+    // pipeline antes das esteiras partirem; com o pool cheio espera o
+    // relatório liberar um buffer (as esteiras ainda não tomam o mutex)
+    while (recuperacao_lote(lote_atual))
+    {
+        lote_atual->inicio_us = lote_atual->fechado_us = esp_timer_get_time();
+        lote_envia_reducao(lote_atual);
+        lote_atual = lote_obtem_livre(portMAX_DELAY);
+    }
+
+    // continua a numeração e o lote interrompido; a sequência de cada
+    // esteira é o índice do produto desde a primeira partida
+    num_lotes = lote_atual->numero;
+    num_produtos = lote_atual->num_produtos;
+    lote_atual->inicio_us = esp_timer_get_time();
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        seq_esperada[i] = lote_atual->seq_fim[i];
+        esteiras[i].sequencia = lote_atual->seq_fim[i];
+    }
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+#if PESAGEM_HABILITADA
+        pesagem_inicia(&esteiras[i].pesagem, PESAGEM_TAXA_HZ);
+        inicia_sensor(&esteiras[i], i);
+#endif
+#if CONTADOR_HABILITADO
+        inicia_contador(&esteiras[i], i);
+#endif
+        xTaskCreatePinnedToCore(&esteira, esteiras[i].nome, PILHA_ESTEIRA, &esteiras[i],
+                                esteiras[i].tarefa->prioridade, &esteiras[i].handler,
+                                esteiras[i].tarefa->core);
+        configASSERT(esteiras[i].handler);
+#if INGESTAO_HABILITADA
+        inicia_ingestao(&esteiras[i], i);
+#endif
+    }
+
+    xTaskCreatePinnedToCore(&display, "display", 4096, NULL, tarefa_display->prioridade,
+                            &handler_display, tarefa_display->core);
     configASSERT(handler_display);        
 
+    // libera todas as esteiras a partir da mesma época
+    epoca_partida = xTaskGetTickCount();
+    xEventGroupSetBits(grupo_eventos, EVENTO_PARTIDA);
+
 }
\ No newline at end of file
@@ -0,0 +1,344 @@
+/*
+Arquivo: historico.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Anel de registros de lote na partição "historico". Cada
+        setor começa com um cabeçalho de sequência crescente; o
+        setor de maior sequência é o atual e o seguinte no anel
+        é o mais antigo, então os setores são apagados sempre na
+        mesma ordem e o desgaste fica uniforme.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "esp_partition.h"
+#include "esp_spi_flash.h"
+#include "esp_timer.h"
+#include "esp32/rom/crc.h"
+#include "historico.h"
+
+#define HISTORICO_MAGICO 0x32534948     // "HIS2" (registro com sequências)
+#define HISTORICO_LIVRE 0xFFFFFFFF      // flash apagada
+#define REGISTROS_SETOR (SPI_FLASH_SEC_SIZE / HISTORICO_REGISTRO)  // sobra do setor fica sem uso
+
+typedef struct __attribute__((packed))
+{
+    uint32_t magico;
+    uint32_t sequencia;         // cresce a cada setor aberto
+    uint32_t reservado[HISTORICO_REGISTRO / 4 - 3];
+    uint32_t crc;
+} cabecalho_t;
+
+_Static_assert(sizeof(cabecalho_t) == HISTORICO_REGISTRO, "cabeçalho ocupa um registro");
+
+static const esp_partition_t *particao = NULL;
+static const uint8_t *mapa = NULL;
+static spi_flash_mmap_handle_t handle_mapa;
+
+// posição de escrita (só a tarefa de relatório acrescenta)
+static uint32_t setor_atual;
+static uint32_t posicao;           // próximo registro livre no setor atual
+static uint32_t sequencia;
+
+static historico_estatisticas_t estatisticas;
+
+static uint32_t crc_registro(const void *r)
+{
+    return crc32_le(0, (const uint8_t *) r, HISTORICO_REGISTRO - sizeof(uint32_t));
+}
+
+static const cabecalho_t *cabecalho(uint32_t setor)
+{
+    return (const cabecalho_t *) (mapa + setor * SPI_FLASH_SEC_SIZE);
+}
+
+static const historico_registro_t *registro(uint32_t setor, uint32_t i)
+{
+    return (const historico_registro_t *) (mapa + setor * SPI_FLASH_SEC_SIZE + i * HISTORICO_REGISTRO);
+}
+
+static bool cabecalho_valido(const cabecalho_t *c)
+{
+    return c->magico == HISTORICO_MAGICO && c->crc == crc_registro(c);
+}
+
+static bool registro_valido(const historico_registro_t *r)
+{
+    return r->lote != HISTORICO_LIVRE && r->crc == crc_registro(r);
+}
+
+// apaga o setor e grava o cabeçalho com a próxima sequência
+static bool abre_setor(uint32_t setor)
+{
+    cabecalho_t c;
+
+    if (esp_partition_erase_range(particao, setor * SPI_FLASH_SEC_SIZE, SPI_FLASH_SEC_SIZE) != ESP_OK)
+    {
+        return false;
+    }
+    estatisticas.apagamentos++;
+
+    memset(&c, 0xFF, sizeof(c));
+    c.magico = HISTORICO_MAGICO;
+    c.sequencia = ++sequencia;
+    c.crc = crc_registro(&c);
+
+    if (esp_partition_write(particao, setor * SPI_FLASH_SEC_SIZE, &c, sizeof(c)) != ESP_OK)
+    {
+        return false;
+    }
+
+    setor_atual = setor;
+    posicao = 1;
+
+    return true;
+}
+
+// acha o setor de maior sequência e a primeira posição livre nele
+static bool localiza(void)
+{
+    bool achou = false;
+
+    estatisticas.registros = 0;
+
+    for (uint32_t s = 0; s < estatisticas.setores; s++)
+    {
+        const cabecalho_t *c = cabecalho(s);
+
+        if (!cabecalho_valido(c))
+        {
+            continue;
+        }
+
+        if (!achou || c->sequencia > sequencia)
+        {
+            sequencia = c->sequencia;
+            setor_atual = s;
+            achou = true;
+        }
+    }
+
+    if (!achou)
+    {
+        // partição nova ou apagada
+        sequencia = 0;
+        return abre_setor(0);
+    }
+
+    for (posicao = 1; posicao < REGISTROS_SETOR; posicao++)
+    {
+        if (registro(setor_atual, posicao)->lote == HISTORICO_LIVRE)
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+static bool conta(const historico_registro_t *r, void *contexto)
+{
+    return true;
+}
+
+bool historico_inicia(void)
+{
+    int64_t inicio = esp_timer_get_time();
+
+    memset(&estatisticas, 0, sizeof(estatisticas));
+
+    particao = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, HISTORICO_SUBTIPO, NULL);
+    if (particao == NULL)
+    {
+        return false;
+    }
+
+    // a leitura é toda pela flash mapeada; escritas passam pela API
+    // da partição, que invalida o cache da faixa alterada
+    if (esp_partition_mmap(particao, 0, particao->size, SPI_FLASH_MMAP_DATA,
+                           (const void **) &mapa, &handle_mapa) != ESP_OK)
+    {
+        particao = NULL;
+        return false;
+    }
+
+    estatisticas.setores = particao->size / SPI_FLASH_SEC_SIZE;
+
+    if (!localiza())
+    {
+        return false;
+    }
+
+    estatisticas.registros = historico_percorre(conta, NULL);
+    estatisticas.varredura_us = (uint32_t) (esp_timer_get_time() - inicio);
+
+    return true;
+}
+
+bool historico_acrescenta(historico_registro_t *r)
+{
+    int64_t inicio = esp_timer_get_time();
+    bool ok = true;
+
+    if (particao == NULL)
+    {
+        return false;
+    }
+
+    // setor cheio: o próximo do anel é o mais antigo
+    // (apagar leva dezenas de ms, mas só a cada REGISTROS_SETOR - 1 lotes)
+    if (posicao >= REGISTROS_SETOR)
+    {
+        uint32_t proximo = (setor_atual + 1) % estatisticas.setores;
+        uint32_t perdidos = 0;
+
+        if (cabecalho_valido(cabecalho(proximo)))
+        {
+            for (uint32_t i = 1; i < REGISTROS_SETOR; i++)
+            {
+                perdidos += registro_valido(registro(proximo, i));
+            }
+        }
+
+        ok = abre_setor(proximo);
+        estatisticas.registros -= perdidos;
+    }
+
+    if (ok)
+    {
+        r->crc = crc_registro(r);
+        ok = esp_partition_write(particao, setor_atual * SPI_FLASH_SEC_SIZE + posicao * HISTORICO_REGISTRO,
+                                 r, sizeof(*r)) == ESP_OK;
+        // mesmo com falha a posição avança: o CRC descarta o registro na leitura
+        posicao++;
+    }
+
+    if (ok)
+    {
+        estatisticas.acrescimos++;
+        estatisticas.registros++;
+    } else
+    {
+        estatisticas.falhas++;
+    }
+
+    estatisticas.ultimo_us = (uint32_t) (esp_timer_get_time() - inicio);
+    if (estatisticas.ultimo_us > estatisticas.pior_us)
+    {
+        estatisticas.pior_us = estatisticas.ultimo_us;
+    }
+
+    return ok;
+}
+
+uint32_t historico_percorre(bool (*visita)(const historico_registro_t *r, void *contexto),
+                            void *contexto)
+{
+    uint32_t n = 0;
+
+    if (particao == NULL)
+    {
+        return 0;
+    }
+
+    // do setor seguinte ao atual (mais antigo) até o atual
+    for (uint32_t k = 1; k <= estatisticas.setores; k++)
+    {
+        uint32_t s = (setor_atual + k) % estatisticas.setores;
+
+        if (!cabecalho_valido(cabecalho(s)))
+        {
+            continue;
+        }
+
+        for (uint32_t i = 1; i < REGISTROS_SETOR; i++)
+        {
+            const historico_registro_t *r = registro(s, i);
+
+            if (r->lote == HISTORICO_LIVRE)
+            {
+                break;
+            }
+
+            if (r->crc != crc_registro(r))
+            {
+                continue;
+            }
+
+            n++;
+            if (!visita(r, contexto))
+            {
+                return n;
+            }
+        }
+    }
+
+    return n;
+}
+
+void historico_estatisticas(historico_estatisticas_t *e)
+{
+    *e = estatisticas;
+}
+
+#if HISTORICO_BENCHMARK
+static bool soma_peso(const historico_registro_t *r, void *contexto)
+{
+    *(double *) contexto += r->peso_total;
+    return true;
+}
+
+void historico_benchmark(void)
+{
+    historico_registro_t r;
+    double soma = 0;
+    int64_t inicio;
+    uint32_t n, total;
+
+    if (particao == NULL)
+    {
+        printf("Benchmark do histórico: partição não encontrada\n");
+        return;
+    }
+
+    printf("Benchmark do histórico (%u setores, %u registros por setor)\n",
+           estatisticas.setores, REGISTROS_SETOR - 1);
+
+    // parte de um anel vazio
+    esp_partition_erase_range(particao, 0, particao->size);
+    localiza();
+
+    // enche o anel e dá mais uma volta, para incluir os apagamentos
+    total = 2 * estatisticas.setores * (REGISTROS_SETOR - 1);
+    memset(&r, 0, sizeof(r));
+
+    inicio = esp_timer_get_time();
+    for (uint32_t i = 0; i < total; i++)
+    {
+        r.lote = i;
+        r.peso_total = 1.0f;
+        historico_acrescenta(&r);
+    }
+    int64_t acrescimo = esp_timer_get_time() - inicio;
+
+    inicio = esp_timer_get_time();
+    n = historico_percorre(soma_peso, &soma);
+    int64_t varredura = esp_timer_get_time() - inicio;
+
+    printf("%u acréscimos em %lld us: %.1f acréscimos/s, pior %u us, %u setores apagados\n",
+           total, acrescimo, total * 1000000.0 / acrescimo, estatisticas.pior_us,
+           estatisticas.apagamentos);
+    printf("varredura de %u registros em %lld us (soma %.0f)\n", n, varredura, soma);
+
+    // não deixa registros falsos no histórico
+    esp_partition_erase_range(particao, 0, particao->size);
+    memset(&estatisticas, 0, sizeof(estatisticas));
+    estatisticas.setores = particao->size / SPI_FLASH_SEC_SIZE;
+    localiza();
+}
+#endif
@@ -0,0 +1,75 @@
+/*
+Arquivo: historico.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Histórico dos lotes em uma partição própria da flash:
+        anel de registros de tamanho fixo, só por acréscimo, com
+        CRC por registro e leitura direta pela flash mapeada.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esteiras.h"
+
+// subtipo da partição "historico" em partitions.csv
+#define HISTORICO_SUBTIPO 0x40
+
+// tamanho de cada registro; o primeiro de cada setor é o cabeçalho
+#define HISTORICO_REGISTRO 40
+
+// 1 = mede acréscimos por segundo e a varredura na partida
+// (APAGA o histórico antes de medir)
+#define HISTORICO_BENCHMARK 0
+
+typedef struct __attribute__((packed))
+{
+    uint32_t lote;                      // 0xFFFFFFFF = posição livre
+    uint32_t tempo_ms;                  // desde a partida
+    uint32_t seq_inicio[NUM_ESTEIRAS];  // primeira sequência de cada esteira
+    uint16_t contagem[NUM_ESTEIRAS];    // produtos de cada esteira no lote
+    uint16_t reservado;
+    float peso_total;
+    uint32_t reducao_us;
+    uint32_t crc;                       // CRC-32 dos campos acima
+} historico_registro_t;
+
+_Static_assert(sizeof(historico_registro_t) == HISTORICO_REGISTRO,
+               "ajuste os campos do registro ao tamanho fixo");
+
+typedef struct
+{
+    uint32_t setores;
+    uint32_t registros;         // válidos no anel
+    uint32_t acrescimos;        // desde a partida
+    uint32_t apagamentos;       // setores apagados desde a partida
+    uint32_t falhas;
+    uint32_t ultimo_us;         // último acréscimo (inclui apagar o setor)
+    uint32_t pior_us;
+    uint32_t varredura_us;      // localização da posição de escrita
+} historico_estatisticas_t;
+
+// localiza e mapeia a partição; retorna false se ela não existe
+bool historico_inicia(void);
+
+// acrescenta um registro (calcula o CRC); apaga o setor mais antigo
+// quando o atual enche
+bool historico_acrescenta(historico_registro_t *r);
+
+// visita os registros válidos do mais antigo ao mais novo, sem cópia
+// (o ponteiro aponta para a flash mapeada); retorna quantos visitou
+uint32_t historico_percorre(bool (*visita)(const historico_registro_t *r, void *contexto),
+                            void *contexto);
+
+void historico_estatisticas(historico_estatisticas_t *e);
+
+void historico_benchmark(void);
+
+#endif
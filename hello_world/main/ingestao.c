@@ -0,0 +1,296 @@
+/*
+Arquivo: ingestao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        ISRs de GPIO e de timer que só notificam a tarefa da esteira
+        e o recolhimento em lote dos produtos pendentes.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "esp_intr_alloc.h"
+#include "driver/gpio.h"
+#include "driver/timer.h"
+#include "ingestao.h"
+
+#define NUM_TIMERS 4
+
+static bool servico_gpio = false;
+static timer_isr_handle_t handles_timer[NUM_TIMERS];
+
+// parte comum das ISRs: marca o primeiro pendente e incrementa a notificação
+static void IRAM_ATTR registra(ingestao_t *g, BaseType_t *acordou)
+{
+    int64_t agora = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&g->mux);
+    if (g->primeiro_us == 0)
+    {
+        g->primeiro_us = agora;
+    }
+    portEXIT_CRITICAL_ISR(&g->mux);
+
+    g->interrupcoes++;
+
+    // eIncrement: o valor da notificação é a contagem ainda não recolhida
+    vTaskNotifyGiveFromISR(g->tarefa, acordou);
+}
+
+static void IRAM_ATTR isr_gpio(void *arg)
+{
+    BaseType_t acordou = pdFALSE;
+
+    registra((ingestao_t *) arg, &acordou);
+    if (acordou)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void IRAM_ATTR isr_timer(void *arg)
+{
+    ingestao_t *g = (ingestao_t *) arg;
+    timer_group_t grupo = g->timer / 2;
+    timer_idx_t indice = g->timer % 2;
+    BaseType_t acordou = pdFALSE;
+
+    // com auto-reload o contador voltou a 0 no alarme: o valor é a latência
+    uint32_t latencia = (uint32_t) timer_group_get_counter_value_in_isr(grupo, indice);
+
+    timer_group_clr_intr_status_in_isr(grupo, indice);
+    timer_group_enable_alarm_in_isr(grupo, indice);
+
+    if (latencia > g->latencia_isr_max)
+    {
+        g->latencia_isr_max = latencia;
+    }
+
+    registra(g, &acordou);
+    if (acordou)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static void limpa(ingestao_t *g, TaskHandle_t tarefa)
+{
+    memset(g, 0, sizeof(*g));
+
+    g->tarefa = tarefa;
+    g->timer = -1;
+    g->gpio = -1;
+    vPortCPUInitializeMutex(&g->mux);
+}
+
+bool ingestao_inicia_gpio(ingestao_t *g, int gpio, TaskHandle_t tarefa)
+{
+    gpio_config_t config = {
+        .pin_bit_mask = 1ULL << gpio,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_ENABLE,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+
+    limpa(g, tarefa);
+    g->gpio = gpio;
+
+    if (gpio_config(&config) != ESP_OK)
+    {
+        return false;
+    }
+
+    if (!servico_gpio)
+    {
+        if (gpio_install_isr_service(ESP_INTR_FLAG_IRAM) != ESP_OK)
+        {
+            return false;
+        }
+        servico_gpio = true;
+    }
+
+    return gpio_isr_handler_add(gpio, isr_gpio, g) == ESP_OK;
+}
+
+bool ingestao_inicia_simulada(ingestao_t *g, int timer, uint32_t periodo_us, TaskHandle_t tarefa)
+{
+    timer_group_t grupo = timer / 2;
+    timer_idx_t indice = timer % 2;
+    timer_config_t config = {
+        .alarm_en = TIMER_ALARM_EN,
+        .counter_en = TIMER_PAUSE,
+        .intr_type = TIMER_INTR_LEVEL,
+        .counter_dir = TIMER_COUNT_UP,
+        .auto_reload = TIMER_AUTORELOAD_EN,
+        .divider = INGESTAO_DIVISOR,
+    };
+
+    limpa(g, tarefa);
+
+    if (timer < 0 || timer >= NUM_TIMERS || timer_init(grupo, indice, &config) != ESP_OK)
+    {
+        return false;
+    }
+    g->timer = timer;
+
+    timer_set_counter_value(grupo, indice, 0);
+    timer_set_alarm_value(grupo, indice, periodo_us);
+    timer_enable_intr(grupo, indice);
+    if (timer_isr_register(grupo, indice, isr_timer, g, ESP_INTR_FLAG_IRAM,
+                           &handles_timer[timer]) != ESP_OK)
+    {
+        return false;
+    }
+
+    return timer_start(grupo, indice) == ESP_OK;
+}
+
+void ingestao_para(ingestao_t *g)
+{
+    if (g->timer >= 0)
+    {
+        timer_pause(g->timer / 2, g->timer % 2);
+        esp_intr_free(handles_timer[g->timer]);
+        g->timer = -1;
+    }
+
+    if (g->gpio >= 0)
+    {
+        gpio_isr_handler_remove(g->gpio);
+        g->gpio = -1;
+    }
+}
+
+uint32_t ingestao_aguarda(ingestao_t *g, TickType_t espera)
+{
+    int64_t primeiro;
+    uint32_t n;
+
+    // zera a notificação e devolve tudo o que as ISRs acumularam
+    n = ulTaskNotifyTake(pdTRUE, espera);
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    // uma ISR entre o take e esta troca marca o próximo lote como já
+    // recolhido; esse lote fica sem amostra de latência, não com uma errada
+    portENTER_CRITICAL(&g->mux);
+    primeiro = g->primeiro_us;
+    g->primeiro_us = 0;
+    portEXIT_CRITICAL(&g->mux);
+
+    // sem amostra, fica o evento do lote anterior: mais antigo que qualquer
+    // produto deste, então o prazo da rejeição é contado a mais, nunca a menos
+    if (primeiro != 0)
+    {
+        uint32_t latencia = (uint32_t) (esp_timer_get_time() - primeiro);
+
+        g->evento_us = primeiro;
+
+        if (latencia > g->latencia_max_us)
+        {
+            g->latencia_max_us = latencia;
+        }
+    }
+
+    g->despertares++;
+    g->produtos += n;
+    if (n > g->maior_lote)
+    {
+        g->maior_lote = n;
+    }
+
+    return n;
+}
+
+#if INGESTAO_BENCHMARK
+#include <stdio.h>
+#include "freertos/semphr.h"
+#include "lote.h"
+
+// timer livre para o benchmark (as esteiras usam a partir do 0)
+#define BENCHMARK_TIMER 3
+#define BENCHMARK_DURACAO_MS 1000
+
+static const uint32_t periodos_us[] = {1000, 100, 20, 10};
+
+// inserção com o mesmo mutex + código de classe do caminho real
+static SemaphoreHandle_t mutex_benchmark;
+static lote_t lote_teste;
+static ingestao_t ingestao_teste;
+
+static void consumidor(void *pvParameter)
+{
+    while (1)
+    {
+        uint32_t n = ingestao_aguarda(&ingestao_teste, portMAX_DELAY);
+
+        xSemaphoreTake(mutex_benchmark, portMAX_DELAY);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            lote_insere(&lote_teste, (ingestao_teste.produtos - n + i) % NUM_MAX_PROD, 0, 0);
+        }
+        xSemaphoreGive(mutex_benchmark);
+    }
+}
+
+void ingestao_benchmark(void)
+{
+    TaskHandle_t tarefa;
+
+    mutex_benchmark = xSemaphoreCreateMutex();
+    if (mutex_benchmark == NULL)
+    {
+        printf("Benchmark da ingestão: sem memória\n");
+        return;
+    }
+
+    printf("Benchmark da ingestão (%d ms por taxa, ISR de timer no lugar da fotocélula)\n",
+           BENCHMARK_DURACAO_MS);
+
+    for (size_t t = 0; t < sizeof(periodos_us) / sizeof(periodos_us[0]); t++)
+    {
+        // consumidor no mesmo core da ISR, acima de quem mede
+        if (xTaskCreatePinnedToCore(&consumidor, "consumidor", 2048, NULL,
+                                    uxTaskPriorityGet(NULL) + 1, &tarefa,
+                                    xPortGetCoreID()) != pdPASS)
+        {
+            printf("Benchmark da ingestão: sem memória\n");
+            break;
+        }
+
+        if (!ingestao_inicia_simulada(&ingestao_teste, BENCHMARK_TIMER, periodos_us[t], tarefa))
+        {
+            printf("  timer %d não configurou\n", BENCHMARK_TIMER);
+            vTaskDelete(tarefa);
+            break;
+        }
+
+        vTaskDelay(BENCHMARK_DURACAO_MS / portTICK_RATE_MS);
+        ingestao_para(&ingestao_teste);
+
+        // deixa o consumidor recolher o que ficou
+        vTaskDelay(10 / portTICK_RATE_MS);
+        vTaskDelete(tarefa);
+
+        ingestao_t *g = &ingestao_teste;
+
+        printf("  %6u interrupções/s: %u produtos/s recolhidos, %.1f produtos por despertar "
+               "(maior %u), latência da ISR até %u us, ISR -> tarefa até %u us\n",
+               1000000 / periodos_us[t], g->produtos * 1000 / BENCHMARK_DURACAO_MS,
+               g->despertares ? (double) g->produtos / g->despertares : 0.0, g->maior_lote,
+               g->latencia_isr_max, g->latencia_max_us);
+    }
+
+    vSemaphoreDelete(mutex_benchmark);
+}
+#endif
@@ -0,0 +1,72 @@
+/*
+Arquivo: ingestao.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Entrada de produtos por interrupção: a ISR da fotocélula só
+        incrementa a notificação direta da tarefa da esteira, que
+        recolhe todos os produtos pendentes em um único despertar.
+        Um timer de hardware pode fazer o papel da fotocélula.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef INGESTAO_H
+#define INGESTAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// 1 = esteiras acordam pelas interrupções das fotocélulas
+// 0 = uma liberação por periodo (comportamento original)
+#define INGESTAO_HABILITADA 0
+
+// 1 = timers de hardware geram as interrupções no ritmo das esteiras
+// (até 4, um por timer do ESP32), 0 = GPIO das fotocélulas
+#define INGESTAO_SIMULADA 1
+
+// timers a 1 MHz: contador e alarme em microssegundos
+#define INGESTAO_DIVISOR 80
+
+// 1 = mede latência da ISR e produtos/s sustentados na partida
+#define INGESTAO_BENCHMARK 0
+
+typedef struct
+{
+    TaskHandle_t tarefa;                // consumidor notificado pela ISR
+    int timer;                          // 0..3 no modo simulado, -1 com GPIO
+    int gpio;                           // fotocélula, -1 no modo simulado
+    portMUX_TYPE mux;
+
+    // escritos pela ISR
+    volatile uint32_t interrupcoes;
+    volatile uint32_t latencia_isr_max; // alarme do timer -> entrada da ISR (us)
+    volatile int64_t primeiro_us;       // ISR que encontrou a fila vazia (0 = nenhuma)
+
+    // escritos pelo consumidor
+    uint32_t despertares;
+    uint32_t produtos;
+    uint32_t maior_lote;
+    uint32_t latencia_max_us;           // ISR -> consumidor com o lote
+    int64_t evento_us;                  // ISR mais antiga do último lote recolhido (ou de um anterior)
+} ingestao_t;
+
+// ISR na borda de subida do GPIO da fotocélula
+bool ingestao_inicia_gpio(ingestao_t *g, int gpio, TaskHandle_t tarefa);
+
+// ISR do alarme periódico do timer (0..3)
+bool ingestao_inicia_simulada(ingestao_t *g, int timer, uint32_t periodo_us, TaskHandle_t tarefa);
+
+void ingestao_para(ingestao_t *g);
+
+// só a tarefa notificada: bloqueia até haver produtos e devolve todos
+// os pendentes de uma vez (0 se a espera acabou sem produtos)
+uint32_t ingestao_aguarda(ingestao_t *g, TickType_t espera);
+
+void ingestao_benchmark(void);
+
+#endif
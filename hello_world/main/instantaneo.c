@@ -0,0 +1,83 @@
+/*
+Arquivo: instantaneo.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Seqlock: o escritor torna a sequência ímpar, altera os
+        dados e a torna par de novo; o leitor copia os dados e
+        descarta a cópia se a sequência mudou ou estava ímpar.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "instantaneo.h"
+
+static portMUX_TYPE mux_escrita = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t sequencia = 0;
+static instantaneo_t dados;
+
+static void escrita_inicio(void)
+{
+    portENTER_CRITICAL(&mux_escrita);
+    __atomic_store_n(&sequencia, sequencia + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void escrita_fim(void)
+{
+    __atomic_store_n(&sequencia, sequencia + 1, __ATOMIC_RELEASE);
+    portEXIT_CRITICAL(&mux_escrita);
+}
+
+void instantaneo_produto(int esteira, int produtos_lote)
+{
+    escrita_inicio();
+    dados.contagem[esteira]++;
+    dados.produtos_total++;
+    dados.produtos_lote = produtos_lote;
+    escrita_fim();
+}
+
+void instantaneo_lote(uint32_t lote, float total)
+{
+    escrita_inicio();
+    dados.lote = lote;
+    dados.ultimo_total = total;
+    escrita_fim();
+}
+
+void instantaneo_taxas(const float *taxas)
+{
+    escrita_inicio();
+    memcpy(dados.taxa, taxas, sizeof(dados.taxa));
+    escrita_fim();
+}
+
+void instantaneo_le(instantaneo_t *copia)
+{
+    uint32_t antes, depois;
+
+    do
+    {
+        antes = __atomic_load_n(&sequencia, __ATOMIC_ACQUIRE);
+        memcpy(copia, &dados, sizeof(*copia));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        depois = __atomic_load_n(&sequencia, __ATOMIC_RELAXED);
+    } while ((antes & 1) || antes != depois);
+}
+
+bool instantaneo_consistente(const instantaneo_t *copia)
+{
+    uint32_t soma = 0;
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        soma += copia->contagem[i];
+    }
+
+    return soma == copia->produtos_total;
+}
@@ -0,0 +1,42 @@
+/*
+Arquivo: instantaneo.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Retrato consistente do estado das esteiras publicado por
+        seqlock: os leitores nunca bloqueiam os produtores.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef INSTANTANEO_H
+#define INSTANTANEO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esteiras.h"
+
+typedef struct
+{
+    uint32_t contagem[NUM_ESTEIRAS];    // produtos desde a partida, por esteira
+    uint32_t produtos_total;            // soma de contagem[], para conferência
+    int produtos_lote;                  // posições preenchidas no lote atual
+    uint32_t lote;                      // número do último lote reduzido
+    float ultimo_total;                 // peso total do último lote
+    float taxa[NUM_ESTEIRAS];           // produtos por segundo, por esteira
+} instantaneo_t;
+
+// escritores (serializados entre si por um spinlock curto)
+void instantaneo_produto(int esteira, int produtos_lote);
+void instantaneo_lote(uint32_t lote, float total);
+void instantaneo_taxas(const float *taxas);
+
+// leitor sem bloqueio: repete a cópia se um escritor estava no meio
+void instantaneo_le(instantaneo_t *copia);
+
+// confere se a cópia não está rasgada
+bool instantaneo_consistente(const instantaneo_t *copia);
+
+#endif
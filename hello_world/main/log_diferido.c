@@ -0,0 +1,310 @@
+/*
+Arquivo: log_diferido.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Anel limitado multi-produtor sem trava (cada célula tem
+        um número de sequência que diz se está livre ou cheia) e
+        a tarefa consumidora que formata as mensagens.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "xtensa/hal.h"
+#include "formato.h"
+#include "log_diferido.h"
+
+#define MASCARA (LOG_TAMANHO - 1)
+
+typedef struct
+{
+    uint32_t sequencia;     // pos: livre para escrita, pos + 1: pronta para leitura
+    uint16_t id;
+    uint8_t nargs;
+    uint32_t args[LOG_MAX_ARGS];
+} celula_t;
+
+#define MENSAGEM_FORMATO(id, formato) formato,
+
+static const char *formatos[NUM_MENSAGENS] = {
+    MENSAGENS(MENSAGEM_FORMATO)
+};
+
+static celula_t anel[LOG_TAMANHO];
+static uint32_t pos_escrita = 0;
+static uint32_t pos_leitura = 0;
+static uint32_t descartadas = 0;
+
+bool log_registra(mensagem_t id, int nargs, const uint32_t *args)
+{
+    celula_t *c;
+    uint32_t pos = __atomic_load_n(&pos_escrita, __ATOMIC_RELAXED);
+
+    // reserva uma célula: só avança pos_escrita se a célula estiver livre
+    while (1)
+    {
+        c = &anel[pos & MASCARA];
+        int32_t diferenca = (int32_t) (__atomic_load_n(&c->sequencia, __ATOMIC_ACQUIRE) - pos);
+
+        if (diferenca == 0)
+        {
+            if (__atomic_compare_exchange_n(&pos_escrita, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        } else if (diferenca < 0)
+        {
+            // cheio: conta e segue sem bloquear
+            __atomic_fetch_add(&descartadas, 1, __ATOMIC_RELAXED);
+            return false;
+        } else
+        {
+            pos = __atomic_load_n(&pos_escrita, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (nargs > LOG_MAX_ARGS)
+    {
+        nargs = LOG_MAX_ARGS;
+    }
+
+    c->id = id;
+    c->nargs = nargs;
+    if (nargs > 0)
+    {
+        memcpy(c->args, args, nargs * sizeof(uint32_t));
+    }
+
+    __atomic_store_n(&c->sequencia, pos + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+uint32_t log_descartadas(void)
+{
+    return __atomic_load_n(&descartadas, __ATOMIC_RELAXED);
+}
+
+// interpreta o formato da mensagem com os argumentos guardados
+static void formata(linha_t *l, const celula_t *c)
+{
+    const char *f = c->id < NUM_MENSAGENS ? formatos[c->id] : "mensagem desconhecida";
+    int arg = 0;
+
+    while (*f != '\0')
+    {
+        const char *inicio = f;
+
+        while (*f != '\0' && *f != '%')
+        {
+            f++;
+        }
+
+        linha_bytes(l, inicio, f - inicio);
+
+        if (*f == '\0')
+        {
+            break;
+        }
+
+        f++;
+
+        int casas = 3;
+
+        if (*f == '.' && f[1] >= '0' && f[1] <= '9')
+        {
+            casas = f[1] - '0';
+            f += 2;
+        }
+
+        if (*f == '%')
+        {
+            linha_texto(l, "%");
+            f++;
+            continue;
+        }
+
+        uint32_t v = arg < c->nargs ? c->args[arg] : 0;
+        arg++;
+
+        switch (*f)
+        {
+            case 'u':
+                linha_u32(l, v);
+                break;
+            case 'd':
+                linha_i32(l, (int32_t) v);
+                break;
+            case 's':
+                linha_texto(l, (const char *) (uintptr_t) v);
+                break;
+            case 'f':
+            {
+                union { uint32_t u; float f; } conv = { .u = v };
+                linha_decimal(l, conv.f, casas);
+                break;
+            }
+            default:
+                linha_texto(l, "?");
+                break;
+        }
+
+        if (*f != '\0')
+        {
+            f++;
+        }
+    }
+
+    linha_nova(l);
+}
+
+// consome tudo o que estiver pronto; uma escrita por buffer cheio
+static int esvazia(linha_t *l)
+{
+    int n = 0;
+
+    while (1)
+    {
+        celula_t *c = &anel[pos_leitura & MASCARA];
+
+        if (__atomic_load_n(&c->sequencia, __ATOMIC_ACQUIRE) != pos_leitura + 1)
+        {
+            break;
+        }
+
+        // garante espaço para uma linha inteira
+        if (l->tam - l->pos < 192)
+        {
+            linha_escreve(l);
+        }
+
+        formata(l, c);
+        __atomic_store_n(&c->sequencia, pos_leitura + LOG_TAMANHO, __ATOMIC_RELEASE);
+        pos_leitura++;
+        n++;
+    }
+
+    if (l->pos > 0)
+    {
+        linha_escreve(l);
+    }
+
+    return n;
+}
+
+static void tarefa_log(void *pvParameter)
+{
+    static char buffer[1024];
+    uint32_t avisadas = 0;
+    uint32_t avisadas_console = 0;
+    linha_t l;
+
+    linha_inicia(&l, buffer, sizeof(buffer));
+
+    while (1)
+    {
+        vTaskDelay(LOG_PERIODO_MS / portTICK_PERIOD_MS);
+
+        esvazia(&l);
+
+        // avisa as perdas sem passar pelo anel
+        uint32_t perdidas = log_descartadas();
+        if (perdidas != avisadas)
+        {
+            celula_t aviso = { .id = MSG_DESCARTADAS, .nargs = 1, .args = { perdidas - avisadas } };
+
+            formata(&l, &aviso);
+            linha_escreve(&l);
+            avisadas = perdidas;
+        }
+
+        // linhas que não couberam na UART: o aviso sai no próximo esvaziamento
+        uint32_t cheias = formato_descartadas();
+        if (cheias != avisadas_console)
+        {
+            LOG_DIF(MSG_CONSOLE_CHEIO, LOG_U(cheias - avisadas_console));
+            avisadas_console = cheias;
+        }
+    }
+}
+
+bool log_inicia(void)
+{
+    TaskHandle_t handler = NULL;
+
+    for (uint32_t i = 0; i < LOG_TAMANHO; i++)
+    {
+        anel[i].sequencia = i;
+    }
+
+    xTaskCreate(&tarefa_log, "log", 3072, NULL, tskIDLE_PRIORITY, &handler);
+
+    return handler != NULL;
+}
+
+// produtor do estresse: taxa/2 msgs/s por core durante 1 s
+static volatile uint32_t enviadas_estresse[2];
+
+static void produtor_estresse(void *pvParameter)
+{
+    int core = (int) (intptr_t) pvParameter;
+    TickType_t ultimo = xTaskGetTickCount();
+
+    // 5000 msgs/s por core em rajadas de um tick
+    for (int t = 0; t < configTICK_RATE_HZ; t++)
+    {
+        for (int k = 0; k < 5000 / configTICK_RATE_HZ; k++)
+        {
+            LOG_DIF(MSG_TESTE, LOG_U(k));
+            enviadas_estresse[core]++;
+        }
+        vTaskDelayUntil(&ultimo, 1);
+    }
+
+    vTaskDelete(NULL);
+}
+
+void log_benchmark(void)
+{
+    const int chamadas = 1000;
+    uint32_t inicio, ciclos;
+    uint32_t descartadas_antes;
+
+    // custo por chamada com o anel vazio (esvaziado entre rodadas)
+    ciclos = 0;
+    for (int k = 0; k < chamadas; k++)
+    {
+        inicio = xthal_get_ccount();
+        LOG_DIF(MSG_TESTE, LOG_U(k));
+        ciclos += xthal_get_ccount() - inicio;
+
+        if ((k & (LOG_TAMANHO / 2 - 1)) == 0)
+        {
+            vTaskDelay(LOG_PERIODO_MS / portTICK_PERIOD_MS + 1);
+        }
+    }
+
+    printf("Log diferido: %u ciclos por registro\n", ciclos / chamadas);
+
+    // estresse: 10k msgs/s somando os dois cores
+    descartadas_antes = log_descartadas();
+    enviadas_estresse[0] = enviadas_estresse[1] = 0;
+
+    for (int core = 0; core < portNUM_PROCESSORS && core < 2; core++)
+    {
+        xTaskCreatePinnedToCore(&produtor_estresse, "estresse", 2048, (void *) (intptr_t) core,
+                                configMAX_PRIORITIES - 2, NULL, core);
+    }
+
+    vTaskDelay(2000 / portTICK_PERIOD_MS);
+
+    printf("Estresse: %u registros, %u descartados\n",
+           enviadas_estresse[0] + enviadas_estresse[1], log_descartadas() - descartadas_antes);
+}
@@ -0,0 +1,69 @@
+/*
+Arquivo: log_diferido.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Log diferido: as tarefas só gravam o id da mensagem e os
+        argumentos binários num anel sem trava; uma tarefa de
+        prioridade mínima formata e escreve depois.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef LOG_DIFERIDO_H
+#define LOG_DIFERIDO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "mensagens.h"
+
+// registros no anel (potência de 2)
+#define LOG_TAMANHO 256
+
+// argumentos por registro
+#define LOG_MAX_ARGS 8
+
+// intervalo entre esvaziamentos do anel: a 10k msgs/s entram ~100
+// registros por esvaziamento, folga para a tarefa de log atrasar um período
+#define LOG_PERIODO_MS 10
+
+// 1 = mede o custo por registro e roda o estresse de 10k msgs/s na partida
+#define LOG_BENCHMARK 0
+
+// conversão dos argumentos para 32 bits
+static inline uint32_t log_float(float f)
+{
+    union { float f; uint32_t u; } v = { .f = f };
+    return v.u;
+}
+
+#define LOG_U(x) ((uint32_t) (x))
+#define LOG_D(x) ((uint32_t) (int32_t) (x))
+#define LOG_F(x) log_float(x)
+#define LOG_S(x) ((uint32_t) (uintptr_t) (x))   // só strings estáticas
+
+// registra uma mensagem sem argumentos
+#define LOG_MSG(id) log_registra((id), 0, NULL)
+
+// registra uma mensagem com argumentos já convertidos por LOG_U/D/F/S
+#define LOG_DIF(id, ...) \
+    do \
+    { \
+        const uint32_t _args[] = { __VA_ARGS__ }; \
+        log_registra((id), sizeof(_args) / sizeof(_args[0]), _args); \
+    } while (0)
+
+// cria a tarefa que esvazia o anel
+bool log_inicia(void);
+
+// grava o registro; nunca bloqueia, retorna false e conta se o anel estiver cheio
+bool log_registra(mensagem_t id, int nargs, const uint32_t *args);
+
+// mensagens descartadas por anel cheio desde a partida
+uint32_t log_descartadas(void);
+
+void log_benchmark(void);
+
+#endif
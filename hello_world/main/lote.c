@@ -0,0 +1,275 @@
+/*
+Arquivo: lote.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Pool de buffers de lote passados por ponteiro entre os
+        estágios do pipeline através de filas.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "lote.h"
+#include "reducao.h"
+
+// pool estático, nada é alocado depois da partida
+static lote_t buffers[LOTE_NUM_BUFFERS];
+
+// filas de ponteiros entre os estágios
+static QueueHandle_t fila_livres;
+static QueueHandle_t fila_reducao;
+static QueueHandle_t fila_relatorio;
+
+// dicionário classe -> peso
+static float peso_classe[LOTE_MAX_CLASSES];
+static int num_classes = 0;
+
+bool lote_inicia_pipeline(void)
+{
+    // cada fila comporta o pool inteiro, então um envio nunca bloqueia
+    fila_livres = xQueueCreate(LOTE_NUM_BUFFERS, sizeof(lote_t *));
+    fila_reducao = xQueueCreate(LOTE_NUM_BUFFERS, sizeof(lote_t *));
+    fila_relatorio = xQueueCreate(LOTE_NUM_BUFFERS, sizeof(lote_t *));
+
+    if (fila_livres == NULL || fila_reducao == NULL || fila_relatorio == NULL)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < LOTE_NUM_BUFFERS; i++)
+    {
+        lote_t *lote = &buffers[i];
+        xQueueSend(fila_livres, &lote, 0);
+    }
+
+    return true;
+}
+
+lote_t *lote_obtem_livre(TickType_t espera)
+{
+    lote_t *lote = NULL;
+
+    if (xQueueReceive(fila_livres, &lote, espera) != pdTRUE)
+    {
+        return NULL;
+    }
+
+    lote->num_produtos = 0;
+    lote->peso_total = 0;
+    memset(lote->contagem_classe, 0, sizeof(lote->contagem_classe));
+    memset(lote->desvio_classe, 0, sizeof(lote->desvio_classe));
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        estatistica_zera(&lote->estatistica[i]);
+    }
+
+    return lote;
+}
+
+void lote_envia_reducao(lote_t *lote)
+{
+    xQueueSend(fila_reducao, &lote, portMAX_DELAY);
+}
+
+lote_t *lote_aguarda_reducao(void)
+{
+    lote_t *lote = NULL;
+
+    xQueueReceive(fila_reducao, &lote, portMAX_DELAY);
+
+    return lote;
+}
+
+void lote_envia_relatorio(lote_t *lote)
+{
+    xQueueSend(fila_relatorio, &lote, portMAX_DELAY);
+}
+
+lote_t *lote_aguarda_relatorio(void)
+{
+    lote_t *lote = NULL;
+
+    xQueueReceive(fila_relatorio, &lote, portMAX_DELAY);
+
+    return lote;
+}
+
+void lote_libera(lote_t *lote)
+{
+    xQueueSend(fila_livres, &lote, portMAX_DELAY);
+}
+
+int lote_classe(float peso)
+{
+    for (int c = 0; c < num_classes; c++)
+    {
+        if (peso_classe[c] == peso)
+        {
+            return c;
+        }
+    }
+
+    if (num_classes == LOTE_MAX_CLASSES)
+    {
+        return -1;
+    }
+
+    peso_classe[num_classes] = peso;
+
+    return num_classes++;
+}
+
+float lote_peso_classe(int classe)
+{
+    return peso_classe[classe];
+}
+
+float lote_total(const lote_t *lote)
+{
+    double total = 0;
+
+    // ordem fixa das classes: o mesmo lote sempre dá o mesmo total
+    for (int c = 0; c < num_classes; c++)
+    {
+        total += (double) lote->contagem_classe[c] * peso_classe[c] + lote->desvio_classe[c];
+    }
+
+    return (float) total;
+}
+
+void lote_decodifica(const lote_t *lote, float *pesos)
+{
+    for (int i = 0; i < lote->num_produtos; i++)
+    {
+        pesos[i] = peso_classe[LOTE_CODIGO_LE(lote->codigos, i)];
+    }
+}
+
+static int compara(const void *a, const void *b)
+{
+    float x = *(const float *) a, y = *(const float *) b;
+
+    return (x > y) - (x < y);
+}
+
+void lote_quantis(lote_t *lote, quantil_t *turno)
+{
+    static const int percentis[LOTE_NUM_QUANTIS] = {1, 50, 99};
+    static const float q[LOTE_NUM_QUANTIS] = {0.01f, 0.5f, 0.99f};
+
+    // só a redução chama: fora da pilha dela
+    static float pesos[NUM_MAX_PROD];
+    int n = lote->num_produtos;
+
+    for (int i = 0; i < n; i++)
+    {
+        pesos[i] = peso_classe[LOTE_CODIGO_LE(lote->codigos, i)] +
+                   (float) lote_desvio(lote, i) / LOTE_ESCALA_DESVIO;
+        quantil_acrescenta(turno, pesos[i]);
+    }
+
+    // no máximo NUM_MAX_PROD pesos: ordenar custa menos que o esboço
+    qsort(pesos, n, sizeof(float), compara);
+
+    // posto mais próximo: o menor peso com pelo menos p% dos produtos até ele
+    for (int j = 0; j < LOTE_NUM_QUANTIS; j++)
+    {
+        int posto = (percentis[j] * n + 99) / 100;
+
+        lote->quantis[j] = n == 0 ? 0 : pesos[posto < 1 ? 0 : posto - 1];
+    }
+
+    quantil_valores(turno, q, lote->quantis_turno, LOTE_NUM_QUANTIS);
+    lote->produtos_turno = turno->n;
+}
+
+#if LOTE_BENCHMARK
+void lote_benchmark(void)
+{
+    const int n = 1500;
+    float *pesos = malloc(n * sizeof(float));
+    uint8_t *codigos = malloc((n + 1) / 2);
+    uint16_t contagem[LOTE_MAX_CLASSES] = {0};
+    int *classes = malloc(n * sizeof(int));
+    volatile float resultado;
+    double total;
+    int64_t inicio;
+
+    if (pesos == NULL || codigos == NULL || classes == NULL || num_classes == 0)
+    {
+        printf("Benchmark do lote: sem memória ou sem classes\n");
+        free(pesos);
+        free(codigos);
+        free(classes);
+        return;
+    }
+
+    // mistura parecida com a das esteiras (1 : 2 : 10 produtos)
+    for (int i = 0; i < n; i++)
+    {
+        int r = i % 13;
+        classes[i] = (r == 0 ? 0 : r < 3 ? 1 : 2) % num_classes;
+    }
+
+    printf("Benchmark do lote (%d produtos, %d classes)\n", n, num_classes);
+    printf("memória: floats %u bytes, códigos %u + contagens %u + dicionário %u bytes\n",
+           (unsigned) (n * sizeof(float)), (unsigned) ((n + 1) / 2),
+           (unsigned) sizeof(contagem), (unsigned) sizeof(peso_classe));
+    printf("lote_t: %u bytes (%d produtos, %s desvios)\n", (unsigned) sizeof(lote_t),
+           NUM_MAX_PROD, LOTE_DESVIOS ? "com" : "sem");
+
+    inicio = esp_timer_get_time();
+    for (int i = 0; i < n; i++)
+    {
+        pesos[i] = peso_classe[classes[i]];
+    }
+    int64_t insere_float = esp_timer_get_time() - inicio;
+
+    inicio = esp_timer_get_time();
+    for (int i = 0; i < n; i++)
+    {
+        LOTE_CODIGO_GRAVA(codigos, i, classes[i]);
+        contagem[classes[i]]++;
+    }
+    int64_t insere_codigo = esp_timer_get_time() - inicio;
+
+    // fechamento: soma sequencial e redução paralela contra Σ contagem × peso
+    inicio = esp_timer_get_time();
+    total = 0;
+    for (int i = 0; i < n; i++)
+    {
+        total += pesos[i];
+    }
+    resultado = total;
+    int64_t fecha_sequencial = esp_timer_get_time() - inicio;
+
+    inicio = esp_timer_get_time();
+    resultado = reducao_soma(pesos, n);
+    int64_t fecha_reducao = esp_timer_get_time() - inicio;
+
+    inicio = esp_timer_get_time();
+    total = 0;
+    for (int c = 0; c < num_classes; c++)
+    {
+        total += (double) contagem[c] * peso_classe[c];
+    }
+    resultado = total;
+    int64_t fecha_dicionario = esp_timer_get_time() - inicio;
+
+    printf("inserção: float %lld us, código %lld us\n", insere_float, insere_codigo);
+    printf("fechamento: sequencial %lld us, redução %lld us, dicionário %lld us (total %.1f)\n",
+           fecha_sequencial, fecha_reducao, fecha_dicionario, resultado);
+
+    free(pesos);
+    free(codigos);
+    free(classes);
+}
+#endif
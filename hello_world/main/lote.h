@@ -0,0 +1,155 @@
+/*
+Arquivo: lote.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Buffers de lote e filas do pipeline de processamento
+        (preenchimento -> redução -> relatório). O lote guarda
+        códigos de classe de 4 bits e um dicionário classe -> peso.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esteiras.h"
+#include "estatistica.h"
+#include "quantil.h"
+
+// NUM máximo de produto
+#define NUM_MAX_PROD 200
+
+// buffers em circulação: um em cada estágio mais uma folga
+#define LOTE_NUM_BUFFERS 4
+
+// cada produto guarda só o código da sua classe de peso (4 bits);
+// o peso de cada classe fica no dicionário compartilhado
+#define LOTE_BITS_CLASSE 4
+#define LOTE_MAX_CLASSES (1 << LOTE_BITS_CLASSE)
+
+// 1 = confere o total do dicionário com a redução paralela dos pesos decodificados
+#define LOTE_CONFERE_REDUCAO 0
+
+// 1 = compara memória e fechamento do lote com o vetor de floats na partida
+#define LOTE_BENCHMARK 0
+
+// 1 = guarda o desvio de cada produto (400 B por lote) para o arquivo e a
+// telemetria; sem pesagem todo produto tem o peso da classe
+#ifndef LOTE_DESVIOS
+#define LOTE_DESVIOS PESAGEM_HABILITADA
+#endif
+
+// grava o código c na posição i de um vetor de códigos de 4 bits
+// desvio de cada produto guardado em gramas (±32 kg)
+#define LOTE_ESCALA_DESVIO 1000
+
+#define LOTE_CODIGO_GRAVA(codigos, i, c) \
+    ((codigos)[(i) / 2] = ((codigos)[(i) / 2] & (0xF0 >> (4 * ((i) & 1)))) | ((c) << (4 * ((i) & 1))))
+
+#define LOTE_CODIGO_LE(codigos, i) (((codigos)[(i) / 2] >> (4 * ((i) & 1))) & 0x0F)
+
+// quantis do relatório: p1, p50 e p99
+#define LOTE_NUM_QUANTIS 3
+
+typedef struct
+{
+    uint32_t numero;                // número sequencial do lote
+    int num_produtos;               // posições preenchidas
+    uint8_t codigos[(NUM_MAX_PROD + 1) / 2];    // classe de cada produto
+    uint16_t contagem_classe[LOTE_MAX_CLASSES];
+    float desvio_classe[LOTE_MAX_CLASSES];      // Σ (medido - peso da classe)
+    float peso_total;               // Σ contagem × peso das classes + desvios
+#if LOTE_DESVIOS
+    int16_t desvio[NUM_MAX_PROD];   // peso medido - peso da classe, em g, para o arquivo
+#endif
+    uint16_t contagem[NUM_ESTEIRAS]; // produtos de cada esteira no lote
+    estatistica_t estatistica[NUM_ESTEIRAS];    // pesos medidos de cada esteira
+    float quantis[LOTE_NUM_QUANTIS];        // exatos, pesos de todas as esteiras
+    float quantis_turno[LOTE_NUM_QUANTIS];  // esboço do turno depois deste lote
+    uint32_t produtos_turno;
+
+    // sequências de cada esteira cobertas pelo lote: [inicio, fim)
+    uint32_t seq_inicio[NUM_ESTEIRAS];
+    uint32_t seq_fim[NUM_ESTEIRAS];
+
+    // tempos de cada estágio
+    int64_t inicio_us;              // primeiro produto
+    int64_t fechado_us;             // lote cheio
+    int64_t inicio_reducao_us;
+    int64_t fim_reducao_us;
+} lote_t;
+
+// cria o pool de buffers e as filas entre os estágios
+bool lote_inicia_pipeline(void);
+
+// preenchimento: pega um buffer livre (bloqueia até espera ticks)
+lote_t *lote_obtem_livre(TickType_t espera);
+
+// preenchimento -> redução
+void lote_envia_reducao(lote_t *lote);
+
+// redução: aguarda o próximo lote cheio
+lote_t *lote_aguarda_reducao(void);
+
+// redução -> relatório
+void lote_envia_relatorio(lote_t *lote);
+
+// relatório: aguarda o próximo lote reduzido
+lote_t *lote_aguarda_relatorio(void);
+
+// relatório -> pool de livres
+void lote_libera(lote_t *lote);
+
+// código da classe de peso (cria a classe se for nova; -1 se o dicionário
+// encheu). Só na partida: o dicionário não muda com as esteiras rodando
+int lote_classe(float peso);
+
+float lote_peso_classe(int classe);
+
+// produto da classe na posição do lote; desvio é o peso medido menos o
+// da classe (0 com peso fixo)
+static inline void lote_insere(lote_t *lote, int posicao, int classe, float desvio)
+{
+    LOTE_CODIGO_GRAVA(lote->codigos, posicao, classe);
+    lote->contagem_classe[classe]++;
+    lote->desvio_classe[classe] += desvio;
+
+#if LOTE_DESVIOS
+    float g = desvio * LOTE_ESCALA_DESVIO;
+
+    // arredondado e saturado; o total usa desvio_classe, sem quantizar
+    lote->desvio[posicao] = g >= INT16_MAX ? INT16_MAX : g <= INT16_MIN ? INT16_MIN :
+                            (int16_t) (g + (g >= 0 ? 0.5f : -0.5f));
+#endif
+}
+
+// desvio do produto em gramas (0 sem LOTE_DESVIOS: peso da classe)
+static inline int16_t lote_desvio(const lote_t *lote, int posicao)
+{
+#if LOTE_DESVIOS
+    return lote->desvio[posicao];
+#else
+    return 0;
+#endif
+}
+
+// total do lote em O(classes)
+float lote_total(const lote_t *lote);
+
+// pesos individuais pelo dicionário (sem os desvios), só quando alguém precisa deles
+void lote_decodifica(const lote_t *lote, float *pesos);
+
+// p1/p50/p99 exatos (posto mais próximo) do lote fechado, pelos pesos
+// decodificados das classes e dos desvios; cada peso entra também no
+// esboço do turno, que fica só com a redução. Fora do mutex do preenchimento
+void lote_quantis(lote_t *lote, quantil_t *turno);
+
+void lote_benchmark(void);
+
+#endif
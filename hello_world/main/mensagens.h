@@ -0,0 +1,57 @@
+/*
+Arquivo: mensagens.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Tabela das mensagens do firmware registradas pelo log
+        diferido. Formatos aceitos: %d %u %s %f %.Nf e %%.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef MENSAGENS_H
+#define MENSAGENS_H
+
+#define MENSAGENS(X) \
+    X(MSG_QUANTIDADE,       "Quantidade produtos %d") \
+    X(MSG_ESTEIRA,          "  %s: %u produtos, %.1f kg | %.2f prod/s (janela %.2f, nominal %.2f) | %.3f kg/s (janela %.3f)") \
+    X(MSG_ULTIMO_LOTE,      "Último lote %u: %.3f") \
+    X(MSG_RASGADA,          "AVISO: leitura rasgada do estado") \
+    X(MSG_CONTENCAO,        "Contenção: %u esperas, pico %d esteiras, pior inserção %u us") \
+    X(MSG_PESO_TOTAL,       "Peso total dos produtos = %.3f") \
+    X(MSG_TEMPO_SOMA,       "Tempo consumido para realizar a soma dos produtos nas esteiras: %u us") \
+    X(MSG_LOTE,             "Lote %u: preenchimento %u ms, produtos/s %.2f, esperas por buffer %u") \
+    X(MSG_TELEMETRIA,       "Telemetria: %d bytes/lote em %u us (relatório em texto registrado em %u us)") \
+    X(MSG_NAO_ESCALONAVEL,  "AVISO: conjunto de tarefas não escalonável com WCET medido") \
+    X(MSG_ESCALONAVEL,      "Escalonamento voltou a ser viável") \
+    X(MSG_ESCALONAMENTO,    "  %s: C %u us, B %u us, prio %u, core %d, R %u us, Rmed %u us%s") \
+    X(MSG_ESCALONAMENTO_CORE, "Core %d: %d tarefas, utilização %.3f (limite RM %.3f)") \
+    X(MSG_DESLIGANDO,       "Desligando") \
+    X(MSG_REINICIE,         "Reinicie para começar o programa novamente") \
+    X(MSG_EMERGENCIA,       "Sistema de Emergência Acinado") \
+    X(MSG_CHECKPOINT,       "Checkpoint: lote %u gravado em %u us (pior %u us, %u gravações/h, %u falhas)") \
+    X(MSG_CHECKPOINT_FALHOU, "AVISO: checkpoint final não gravado") \
+    X(MSG_HISTORICO_FALHOU, "AVISO: lote %u não gravado no histórico") \
+    X(MSG_AUDITORIA,        "Auditoria no lote %u: %u lacunas, %u repetidas, %u rejeitadas na inserção (injetadas: %u lacunas, %u repetidas)") \
+    X(MSG_CONFERENCIA,      "AVISO: lote %u: dicionário %.3f, redução %.3f") \
+    X(MSG_PESAGEM,          "  %s: identificação em até %u ms após a chegada, %u subidas descartadas, %u produtos além do bloco") \
+    X(MSG_INGESTAO,         "  %s: %u interrupções, %.1f produtos por despertar, ISR -> tarefa até %u us") \
+    X(MSG_ESTATISTICA,      "  %s: %u produtos, média %.3f kg, desvio %.4f, faixa %.3f a %.3f | desde a partida: média %.4f, desvio %.4f") \
+    X(MSG_QUANTIS,          "Lote %u: p1 %.3f, p50 %.3f, p99 %.3f kg | turno (%u produtos): p1 %.3f, p50 %.3f, p99 %.3f") \
+    X(MSG_REJEICAO,         "  %s: %u aceitos, %u abaixo, %u acima, %u atrasados (%u fora da faixa) | decisão p99 < %u us, máx %u us") \
+    X(MSG_SERIE,            "  %s: minuto anterior %u produtos (%.2f kg), últimas 24 h %u produtos (%.1f kg)") \
+    X(MSG_CONSOLE_CHEIO,    "Console: %u escritas descartadas com o buffer da UART cheio") \
+    X(MSG_DESCARTADAS,      "Log: %u mensagens descartadas") \
+    X(MSG_TESTE,            "teste %u")
+
+#define MENSAGEM_ENUM(id, formato) id,
+
+typedef enum
+{
+    MENSAGENS(MENSAGEM_ENUM)
+    NUM_MENSAGENS
+} mensagem_t;
+
+#endif
@@ -0,0 +1,133 @@
+/*
+Arquivo: metricas.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Atualização incremental das taxas: cada produto só
+        incrementa contadores e cada refresh do display consome
+        o delta desde o refresh anterior.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "metricas.h"
+
+void metricas_inicia(metricas_esteira_t *m, uint32_t periodo_ms)
+{
+    memset(m, 0, sizeof(*m));
+    m->taxa_nominal = periodo_ms > 0 ? 1000.0f / periodo_ms : 0;
+}
+
+void metricas_produto(metricas_esteira_t *m, float peso)
+{
+    m->contagem++;
+    m->gramas += (uint32_t) (peso * 1000.0f + 0.5f);
+}
+
+void metricas_atualiza(metricas_esteira_t *v, int n, uint32_t dt_us)
+{
+    if (dt_us == 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        metricas_esteira_t *m = &v[i];
+
+        // delta desde a última atualização (sem sinal: atravessa a volta dos contadores)
+        uint32_t contagem = m->contagem;
+        uint32_t gramas = m->gramas;
+        uint32_t produtos = contagem - m->contagem_anterior;
+        uint32_t g = gramas - m->gramas_anterior;
+
+        m->contagem_anterior = contagem;
+        m->gramas_anterior = gramas;
+        m->massa += g / 1000.0;
+
+        // janela deslizante: o intervalo novo ocupa o lugar do mais antigo e
+        // as somas saem do anel inteiro, sem acumular erro entre atualizações
+        int p = m->posicao;
+        uint32_t soma_produtos = 0, soma_gramas = 0, soma_us = 0;
+
+        m->janela_produtos[p] = produtos;
+        m->janela_gramas[p] = g;
+        m->janela_us[p] = dt_us;
+        m->posicao = (p + 1) % METRICAS_JANELA;
+
+        for (int k = 0; k < METRICAS_JANELA; k++)
+        {
+            soma_produtos += m->janela_produtos[k];
+            soma_gramas += m->janela_gramas[k];
+            soma_us += m->janela_us[k];
+        }
+
+        m->taxa_janela = soma_produtos * 1000000.0f / soma_us;
+        m->massa_janela = soma_gramas * 1000.0f / soma_us;
+
+        // EWMA da taxa do intervalo
+        float taxa = produtos * 1000000.0f / dt_us;
+        float taxa_massa = g * 1000.0f / dt_us;
+
+        if (m->taxa_ewma == 0 && m->massa_ewma == 0)
+        {
+            m->taxa_ewma = taxa;
+            m->massa_ewma = taxa_massa;
+        } else
+        {
+            m->taxa_ewma += METRICAS_ALFA * (taxa - m->taxa_ewma);
+            m->massa_ewma += METRICAS_ALFA * (taxa_massa - m->massa_ewma);
+        }
+    }
+}
+
+void metricas_benchmark(void)
+{
+    static const int tamanhos[] = {3, 64};
+    const int produtos = 10000;
+
+    printf("Benchmark das métricas\n");
+
+    for (int t = 0; t < 2; t++)
+    {
+        int n = tamanhos[t];
+        metricas_esteira_t *v = malloc(n * sizeof(metricas_esteira_t));
+
+        if (v == NULL)
+        {
+            printf("%d esteiras: sem memória\n", n);
+            continue;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            metricas_inicia(&v[i], 100);
+        }
+
+        int64_t inicio = esp_timer_get_time();
+        for (int k = 0; k < produtos; k++)
+        {
+            metricas_produto(&v[k % n], 0.5f);
+        }
+        int64_t por_produto = esp_timer_get_time() - inicio;
+
+        inicio = esp_timer_get_time();
+        for (int k = 0; k < 100; k++)
+        {
+            metricas_atualiza(v, n, 2000000);
+        }
+        int64_t por_atualizacao = esp_timer_get_time() - inicio;
+
+        printf("%2d esteiras: %f us/produto, %f us/atualização (%f us/esteira)\n", n,
+               (double) por_produto / produtos, (double) por_atualizacao / 100,
+               (double) por_atualizacao / 100 / n);
+
+        free(v);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+Arquivo: metricas.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Vazão por esteira (produtos/s e kg/s) em janela deslizante
+        e média móvel exponencial (EWMA), mais totais acumulados.
+        A massa anda em gramas inteiras: somar kg em float perderia
+        os produtos leves depois de algumas horas.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include <stdint.h>
+
+// atualizações que formam a janela deslizante
+#define METRICAS_JANELA 5
+
+// peso da amostra nova na EWMA
+#define METRICAS_ALFA 0.3f
+
+// 1 = mede o custo por produto e por atualização na partida
+#define METRICAS_BENCHMARK 0
+
+typedef struct
+{
+    // escritos pela esteira, um escritor por entrada
+    volatile uint32_t contagem;     // produtos desde a partida
+    volatile uint32_t gramas;       // g desde a partida, módulo 2^32 (só o delta é usado)
+
+    // escritos só na atualização do display
+    uint32_t contagem_anterior;
+    uint32_t gramas_anterior;
+    double massa;                   // kg desde a partida, somada delta a delta
+    uint32_t janela_produtos[METRICAS_JANELA];
+    uint32_t janela_gramas[METRICAS_JANELA];
+    uint32_t janela_us[METRICAS_JANELA];
+    int posicao;
+
+    float taxa_janela;              // produtos/s na janela
+    float massa_janela;             // kg/s na janela
+    float taxa_ewma;                // produtos/s
+    float massa_ewma;               // kg/s
+    float taxa_nominal;             // produtos/s esperados pelo periodo
+} metricas_esteira_t;
+
+// zera a entrada e guarda a taxa nominal
+void metricas_inicia(metricas_esteira_t *m, uint32_t periodo_ms);
+
+// O(1) por produto
+void metricas_produto(metricas_esteira_t *m, float peso);
+
+// O(n × METRICAS_JANELA) por atualização; dt_us desde a atualização anterior
+void metricas_atualiza(metricas_esteira_t *v, int n, uint32_t dt_us);
+
+// custo por produto e por atualização para 3 e 64 esteiras
+void metricas_benchmark(void);
+
+#endif
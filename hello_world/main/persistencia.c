@@ -0,0 +1,197 @@
+/*
+Arquivo: persistencia.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Checkpoint das contagens e totais em um blob da NVS.
+        O estado mais recente fica em RAM e só é gravado a cada
+        PERSISTENCIA_LOTES lotes ou PERSISTENCIA_PERIODO_MS.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "persistencia.h"
+
+#define PERSISTENCIA_NAMESPACE "esteiras"
+#define PERSISTENCIA_CHAVE "checkpoint"
+
+static nvs_handle_t nvs;
+static bool aberta = false;
+
+// serializa relatório e touch, que podem pedir commit ao mesmo tempo
+static SemaphoreHandle_t mutex_persistencia;
+
+static checkpoint_t pendente;
+static bool sujo = false;
+static uint32_t lotes_gravados = 0;
+static int64_t ultimo_commit = 0;
+static int64_t partida = 0;
+
+static persistencia_estatisticas_t estatisticas;
+
+bool persistencia_inicia(checkpoint_t *restaurado)
+{
+    size_t tamanho = sizeof(*restaurado);
+    int64_t inicio = esp_timer_get_time();
+    bool valido = false;
+
+    partida = inicio;
+    ultimo_commit = inicio;
+    memset(restaurado, 0, sizeof(*restaurado));
+    memset(&estatisticas, 0, sizeof(estatisticas));
+
+    mutex_persistencia = xSemaphoreCreateMutex();
+    aberta = mutex_persistencia != NULL &&
+             nvs_open(PERSISTENCIA_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK;
+
+    if (aberta && nvs_get_blob(nvs, PERSISTENCIA_CHAVE, restaurado, &tamanho) == ESP_OK)
+    {
+        // tamanho ou versão diferentes: checkpoint de outro firmware
+        valido = tamanho == sizeof(*restaurado) && restaurado->versao == PERSISTENCIA_VERSAO;
+    }
+
+    if (!valido)
+    {
+        memset(restaurado, 0, sizeof(*restaurado));
+    }
+
+    restaurado->versao = PERSISTENCIA_VERSAO;
+    pendente = *restaurado;
+    lotes_gravados = restaurado->lotes;
+
+    estatisticas.restauracao_us = (uint32_t) (esp_timer_get_time() - inicio);
+    estatisticas.restaurado = valido;
+
+    return aberta;
+}
+
+// chamada com o mutex tomado
+static bool prazo_vencido(void)
+{
+    return esp_timer_get_time() - ultimo_commit >= (int64_t) PERSISTENCIA_PERIODO_MS * 1000;
+}
+
+// chamada com o mutex tomado
+static bool commit(void)
+{
+    int64_t inicio = esp_timer_get_time();
+    bool ok;
+
+    ok = aberta && nvs_set_blob(nvs, PERSISTENCIA_CHAVE, &pendente, sizeof(pendente)) == ESP_OK
+                && nvs_commit(nvs) == ESP_OK;
+
+    ultimo_commit = esp_timer_get_time();
+
+    estatisticas.ultimo_commit_us = (uint32_t) (ultimo_commit - inicio);
+    if (estatisticas.ultimo_commit_us > estatisticas.pior_commit_us)
+    {
+        estatisticas.pior_commit_us = estatisticas.ultimo_commit_us;
+    }
+
+    if (ok)
+    {
+        estatisticas.gravacoes++;
+        lotes_gravados = pendente.lotes;
+        sujo = false;
+    } else
+    {
+        // mantém sujo para tentar de novo no próximo lote ou prazo
+        estatisticas.falhas++;
+    }
+
+    return ok;
+}
+
+bool persistencia_atualiza(const checkpoint_t *estado)
+{
+    bool gravou = false;
+
+    if (!aberta)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(mutex_persistencia, portMAX_DELAY);
+
+    pendente = *estado;
+    pendente.versao = PERSISTENCIA_VERSAO;
+    sujo = true;
+
+    if (pendente.lotes - lotes_gravados >= PERSISTENCIA_LOTES || prazo_vencido())
+    {
+        gravou = commit();
+    }
+
+    xSemaphoreGive(mutex_persistencia);
+
+    return gravou;
+}
+
+bool persistencia_periodica(void)
+{
+    bool gravou = false;
+
+    if (!aberta)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(mutex_persistencia, portMAX_DELAY);
+
+    // sem lote novo desde o último commit não há nada a gravar
+    if (sujo && prazo_vencido())
+    {
+        gravou = commit();
+    }
+
+    xSemaphoreGive(mutex_persistencia);
+
+    return gravou;
+}
+
+bool persistencia_grava(void)
+{
+    bool ok = true;
+
+    if (!aberta)
+    {
+        return false;
+    }
+
+    xSemaphoreTake(mutex_persistencia, portMAX_DELAY);
+
+    if (sujo)
+    {
+        ok = commit();
+    }
+
+    xSemaphoreGive(mutex_persistencia);
+
+    return ok;
+}
+
+void persistencia_estatisticas(persistencia_estatisticas_t *e)
+{
+    int64_t decorrido = esp_timer_get_time() - partida;
+
+    if (mutex_persistencia == NULL)
+    {
+        *e = estatisticas;
+        return;
+    }
+
+    xSemaphoreTake(mutex_persistencia, portMAX_DELAY);
+
+    *e = estatisticas;
+    e->gravacoes_hora = decorrido > 0 ?
+        (uint32_t) ((uint64_t) estatisticas.gravacoes * 3600000000ULL / decorrido) : 0;
+
+    xSemaphoreGive(mutex_persistencia);
+}
@@ -0,0 +1,68 @@
+/*
+Arquivo: persistencia.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Checkpoint periódico das contagens e totais na NVS, com
+        gravações agrupadas e restauração na partida.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef PERSISTENCIA_H
+#define PERSISTENCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esteiras.h"
+
+// grava depois de PERSISTENCIA_LOTES lotes ou PERSISTENCIA_PERIODO_MS,
+// o que vier primeiro (cada commit gasta uma entrada da página NVS)
+#define PERSISTENCIA_LOTES 4
+#define PERSISTENCIA_PERIODO_MS 60000
+
+// muda quando o layout de checkpoint_t muda; versões antigas são ignoradas
+#define PERSISTENCIA_VERSAO 2
+
+typedef struct
+{
+    uint32_t versao;
+    uint32_t lotes;                     // lotes fechados desde a primeira partida
+    uint32_t contagem[NUM_ESTEIRAS];    // produtos por esteira, acumulado
+    double massa[NUM_ESTEIRAS];         // kg por esteira nos lotes relatados, acumulado
+    double peso_acumulado;              // soma dos totais de todos os lotes
+    float ultimo_total;                 // peso total do último lote
+} checkpoint_t;
+
+typedef struct
+{
+    uint32_t gravacoes;         // commits desde a partida
+    uint32_t falhas;            // commits que retornaram erro
+    uint32_t ultimo_commit_us;
+    uint32_t pior_commit_us;
+    uint32_t restauracao_us;    // leitura do checkpoint na partida
+    uint32_t gravacoes_hora;    // commits por hora desde a partida
+    bool restaurado;            // havia um checkpoint válido na partida
+} persistencia_estatisticas_t;
+
+// abre a NVS e lê o último checkpoint (restaurado fica zerado se não havia
+// um válido). Retorna false se a NVS não abriu: aí as demais funções não
+// gravam nada e as contagens recomeçam do zero a cada partida
+bool persistencia_inicia(checkpoint_t *restaurado);
+
+// guarda o estado mais recente e grava se o lote ou o prazo venceu;
+// retorna true se houve commit (nunca chamar no caminho das esteiras)
+bool persistencia_atualiza(const checkpoint_t *estado);
+
+// grava o estado pendente se o prazo venceu sem lote novo; chamada
+// periodicamente fora do relatório. Retorna true se houve commit
+bool persistencia_periodica(void);
+
+// grava agora o último estado pendente (por exemplo, antes de desligar)
+bool persistencia_grava(void);
+
+void persistencia_estatisticas(persistencia_estatisticas_t *e);
+
+#endif
@@ -0,0 +1,310 @@
+/*
+Arquivo: pesagem.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Filtro biquad em blocos e máquina de estados da detecção:
+        vazia -> chegando (espera o sinal estabilizar) -> assentada
+        (emite o peso) -> vazia quando o produto sai.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "pesagem.h"
+
+// amostras filtradas de cada vez (o bloco de entrada pode ser maior)
+#define PEDACO 64
+
+// deriva da tara acompanhada só com a balança vazia e parada. A saída do
+// produto faz o filtro passar do zero por umas 20 amostras e a chegada sobe
+// algumas abaixo do limiar; os dois transitórios puxariam a tara a cada
+// produto, então ela espera a saída assentar e aprende com amostras de
+// PESAGEM_ATRASO_TARA atrás, descartadas se um produto chegou nesse meio
+#define TARA_ALFA 0.005f
+#define TARA_ESPERA (2 * PESAGEM_JANELA)
+
+void pesagem_inicia(pesagem_t *p, float taxa_hz)
+{
+    // passa-baixas Butterworth (Q = 1/√2), fórmulas do RBJ cookbook
+    float w0 = 2.0f * (float) M_PI * PESAGEM_CORTE_HZ / taxa_hz;
+    float alfa = sinf(w0) / (2.0f * (float) M_SQRT1_2);
+    float a0 = 1.0f + alfa;
+    float c = cosf(w0);
+
+    memset(p, 0, sizeof(*p));
+
+    p->b0 = (1.0f - c) / 2.0f / a0;
+    p->b1 = (1.0f - c) / a0;
+    p->b2 = p->b0;
+    p->a1 = -2.0f * c / a0;
+    p->a2 = (1.0f - alfa) / a0;
+
+    p->estado = PESAGEM_VAZIA;
+}
+
+// filtra n amostras; coeficientes e estado ficam em registradores no laço
+static void filtra(pesagem_t *p, const float *x, float *y, int n)
+{
+    float b0 = p->b0, b1 = p->b1, b2 = p->b2, a1 = p->a1, a2 = p->a2;
+    float z1 = p->z1, z2 = p->z2;
+
+    for (int i = 0; i < n; i++)
+    {
+        float saida = b0 * x[i] + z1;
+
+        z1 = b1 * x[i] - a1 * saida + z2;
+        z2 = b2 * x[i] - a2 * saida;
+        y[i] = saida;
+    }
+
+    p->z1 = z1;
+    p->z2 = z2;
+}
+
+int pesagem_processa(pesagem_t *p, const float *amostras, int n,
+                     pesagem_produto_t *produtos, int max)
+{
+    float y[PEDACO];
+    int emitidos = 0;
+
+    if (p->amostras == 0 && n > 0)
+    {
+        // zero na partida: balança vazia, filtro já em regime na primeira leitura
+        p->z1 = amostras[0] * (1.0f - p->b0);
+        p->z2 = amostras[0] * (p->b2 - p->a2);
+        p->tara = amostras[0];
+    }
+
+    for (int inicio = 0; inicio < n; inicio += PEDACO)
+    {
+        int k = n - inicio < PEDACO ? n - inicio : PEDACO;
+
+        filtra(p, &amostras[inicio], y, k);
+
+        for (int i = 0; i < k; i++, p->amostras++)
+        {
+            float carga = y[i] - p->tara;
+
+            switch (p->estado)
+            {
+            case PESAGEM_VAZIA:
+                if (carga > PESAGEM_LIMIAR)
+                {
+                    p->estado = PESAGEM_CHEGANDO;
+                    p->chegada = p->amostras;
+                    p->referencia = y[i];
+                    p->soma = 0;
+                    p->estaveis = 0;
+                } else
+                {
+                    float *recente = &p->recentes[p->amostras % PESAGEM_ATRASO_TARA];
+
+                    if (++p->vazia > TARA_ESPERA + PESAGEM_ATRASO_TARA)
+                    {
+                        p->tara += TARA_ALFA * *recente;
+                    }
+                    *recente = carga;
+                }
+                break;
+
+            case PESAGEM_CHEGANDO:
+                if (carga < PESAGEM_LIMIAR / 2)
+                {
+                    // saiu antes de assentar (batida, vibração)
+                    p->estado = PESAGEM_VAZIA;
+                    p->vazia = 0;
+                    p->falsos++;
+                    break;
+                }
+
+                if (fabsf(y[i] - p->referencia) > PESAGEM_TOLERANCIA)
+                {
+                    // ainda oscilando: recomeça a sequência estável daqui
+                    p->referencia = y[i];
+                    p->soma = 0;
+                    p->estaveis = 0;
+                }
+
+                p->soma += y[i];
+                p->estaveis++;
+
+                if (p->estaveis >= PESAGEM_JANELA)
+                {
+                    uint32_t latencia = p->amostras - p->chegada;
+
+                    if (latencia > p->latencia_max)
+                    {
+                        p->latencia_max = latencia;
+                    }
+
+                    if (emitidos < max)
+                    {
+                        produtos[emitidos].peso = p->soma / p->estaveis - p->tara;
+                        produtos[emitidos].latencia = latencia;
+                        produtos[emitidos].amostra = p->amostras;
+                        emitidos++;
+                    } else
+                    {
+                        p->descartados++;
+                    }
+
+                    p->estado = PESAGEM_ASSENTADA;
+                }
+                break;
+
+            case PESAGEM_ASSENTADA:
+                // histerese: só considera saída bem abaixo do limiar de chegada
+                if (carga < PESAGEM_LIMIAR / 2)
+                {
+                    p->estado = PESAGEM_VAZIA;
+                    p->vazia = 0;
+                }
+                break;
+            }
+        }
+    }
+
+    return emitidos;
+}
+
+void pesagem_gerador_inicia(pesagem_gerador_t *g, float taxa_hz, uint32_t periodo_ms,
+                            uint32_t fase_ms, float peso, uint32_t semente)
+{
+    memset(g, 0, sizeof(*g));
+
+    g->periodo = (uint32_t) (periodo_ms * taxa_hz / 1000);
+    g->presenca = g->periodo * 7 / 10;
+    // o primeiro produto chega depois de um intervalo vazio (zero na partida)
+    g->fase = (uint32_t) (fase_ms * taxa_hz / 1000) % g->periodo + g->periodo - g->presenca;
+    g->peso = peso;
+    g->tara = 0.250f;
+    g->ruido = 0.002f;
+    g->aleatorio = semente;
+}
+
+void pesagem_gera(pesagem_gerador_t *g, float *amostras, int n)
+{
+    // produto chega na amostra fase + k * periodo: subida de 5 amostras e
+    // oscilação de 10% a 40 Hz, amortecida em ~8 ms
+    // (constantes em amostras de 1 kHz; o gerador não se ajusta à taxa)
+    for (int i = 0; i < n; i++, g->amostra++)
+    {
+        uint32_t t = (g->amostra - g->fase) % g->periodo;
+        float carga = 0;
+
+        if (g->amostra >= g->fase && t < g->presenca)
+        {
+            if (t < 5)
+            {
+                carga = g->peso * (t + 1) / 5.0f;
+            } else
+            {
+                float s = (t - 5) / 1000.0f;
+                carga = g->peso * (1.0f + 0.1f * expf(-s / 0.008f) * cosf(2.0f * (float) M_PI * 40.0f * s));
+            }
+        }
+
+        g->aleatorio = g->aleatorio * 1103515245 + 12345;
+        amostras[i] = g->tara + carga + g->ruido * (((g->aleatorio >> 16) & 0x7FFF) / 16383.5f - 1.0f);
+    }
+}
+
+#if PESAGEM_BENCHMARK
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_timer.h"
+
+// segundos de sinal por esteira
+#define BENCHMARK_SEGUNDOS 10
+
+// produto que chega nas últimas amostras do traço pode não assentar
+#define BENCHMARK_ASSENTA 100
+
+static bool mede(int esteiras)
+{
+    int n = BENCHMARK_SEGUNDOS * PESAGEM_TAXA_HZ;
+    float *traco = malloc(n * sizeof(float));
+    pesagem_t *p = malloc(esteiras * sizeof(pesagem_t));
+    pesagem_gerador_t g;
+    pesagem_produto_t produtos[PESAGEM_MAX_PRODUTOS];
+    uint32_t detectados = 0, esperados = 0, chegadas = 0, latencia = 0;
+    double erro = 0;
+    float erro_max = 0;
+    int64_t tempo = 0;
+    bool ok;
+
+    if (traco == NULL || p == NULL)
+    {
+        printf("%d esteiras: sem memória\n", esteiras);
+        free(traco);
+        free(p);
+        return false;
+    }
+
+    for (int e = 0; e < esteiras; e++)
+    {
+        // periodos de 100 ms a ~2.4 s, como no benchmark da compressão
+        uint32_t periodo_ms = 100 + 37 * e;
+        float peso = 0.5f + 0.25f * (e % 16);
+
+        // o traço é gerado antes: só filtro e detecção entram no tempo
+        pesagem_gerador_inicia(&g, PESAGEM_TAXA_HZ, periodo_ms, 7 * e, peso, e + 1);
+        pesagem_gera(&g, traco, n);
+        pesagem_inicia(&p[e], PESAGEM_TAXA_HZ);
+        chegadas += (uint32_t) n > g.fase ? (n - g.fase - 1) / g.periodo + 1 : 0;
+        esperados += (uint32_t) n > g.fase + BENCHMARK_ASSENTA ?
+                     (n - BENCHMARK_ASSENTA - g.fase - 1) / g.periodo + 1 : 0;
+
+        int64_t inicio = esp_timer_get_time();
+        for (int b = 0; b < n; b += PESAGEM_BLOCO)
+        {
+            int k = pesagem_processa(&p[e], &traco[b], PESAGEM_BLOCO, produtos, PESAGEM_MAX_PRODUTOS);
+
+            for (int j = 0; j < k; j++)
+            {
+                erro += fabsf(produtos[j].peso - peso);
+                erro_max = fmaxf(erro_max, fabsf(produtos[j].peso - peso));
+            }
+            detectados += k;
+        }
+        tempo += esp_timer_get_time() - inicio;
+
+        if (p[e].latencia_max > latencia)
+        {
+            latencia = p[e].latencia_max;
+        }
+    }
+
+    double vazao = (double) n * esteiras * 1000000 / tempo;
+
+    // o peso assentado é média da janela estável: não passa da tolerância
+    ok = detectados >= esperados && detectados <= chegadas && erro_max <= PESAGEM_TOLERANCIA;
+
+    printf("%2d esteiras: %.0f amostras/s em um core (%.0f esteiras a %d Hz), "
+           "%u produtos (%u a %u), erro médio %.4f kg (pior %.4f), pior latência %u ms %s\n",
+           esteiras, vazao, vazao / PESAGEM_TAXA_HZ, PESAGEM_TAXA_HZ,
+           detectados, esperados, chegadas, detectados ? erro / detectados : 0.0, erro_max,
+           latencia * 1000 / PESAGEM_TAXA_HZ, ok ? "ok" : "ERRO");
+
+    free(traco);
+    free(p);
+
+    return ok;
+}
+
+bool pesagem_benchmark(void)
+{
+    bool ok = true;
+
+    printf("Benchmark da pesagem (%d Hz, blocos de %d amostras)\n", PESAGEM_TAXA_HZ, PESAGEM_BLOCO);
+
+    ok &= mede(3);
+    ok &= mede(64);
+
+    return ok;
+}
+#endif
@@ -0,0 +1,109 @@
+/*
+Arquivo: pesagem.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Pesagem por célula de carga: filtro passa-baixas em blocos
+        de amostras, detecção da chegada e saída do produto e peso
+        assentado como evento de produto. Inclui um gerador de
+        sinal sintético para rodar sem a célula.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef PESAGEM_H
+#define PESAGEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 1 = as esteiras detectam os produtos no sinal da célula de carga
+// 0 = produtos de peso fixo a cada periodo (comportamento original)
+#define PESAGEM_HABILITADA 0
+
+// amostragem por esteira e tamanho do bloco processado de cada vez
+#define PESAGEM_TAXA_HZ 1000
+#define PESAGEM_BLOCO 50
+#define PESAGEM_PERIODO_BLOCO_MS (PESAGEM_BLOCO * 1000 / PESAGEM_TAXA_HZ)
+
+// produtos que cabem em um bloco (saída mais rápida que o assentamento)
+#define PESAGEM_MAX_PRODUTOS 4
+
+// parâmetros da detecção
+#define PESAGEM_CORTE_HZ 50.0f          // passa-baixas de 2ª ordem
+#define PESAGEM_LIMIAR 0.1f             // kg acima da tara = produto presente
+#define PESAGEM_TOLERANCIA 0.005f       // variação máxima do peso assentado
+#define PESAGEM_JANELA 15               // amostras estáveis para aceitar o peso
+#define PESAGEM_ATRASO_TARA 4           // a tara aprende com amostras desta idade
+
+// 1 = mede amostras/s por core com 3 e 64 esteiras na partida
+#ifndef PESAGEM_BENCHMARK
+#define PESAGEM_BENCHMARK 0
+#endif
+
+typedef enum
+{
+    PESAGEM_VAZIA,
+    PESAGEM_CHEGANDO,                   // produto na balança, ainda oscilando
+    PESAGEM_ASSENTADA                   // peso emitido, aguardando a saída
+} pesagem_estado_t;
+
+typedef struct
+{
+    // biquad passa-baixas (forma direta II transposta)
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+
+    pesagem_estado_t estado;
+    float tara;                         // leitura sem produto (acompanha a deriva)
+    float referencia;                   // início da sequência estável atual
+    float soma;
+    int estaveis;
+    int vazia;                          // amostras desde que a balança esvaziou
+    float recentes[PESAGEM_ATRASO_TARA]; // cargas ainda não usadas pela tara
+
+    uint32_t amostras;                  // processadas desde a partida
+    uint32_t chegada;                   // amostra em que o produto chegou
+    uint32_t latencia_max;              // pior chegada -> peso, em amostras
+    uint32_t falsos;                    // subidas que voltaram sem assentar
+    uint32_t descartados;               // assentados além do max de um bloco
+} pesagem_t;
+
+typedef struct
+{
+    float peso;
+    uint32_t latencia;                  // amostras entre a chegada e o peso
+    uint32_t amostra;                   // índice (desde a partida) em que o peso saiu
+} pesagem_produto_t;
+
+// célula de carga simulada: degrau com oscilação amortecida e ruído
+typedef struct
+{
+    uint32_t amostra;
+    uint32_t periodo;                   // amostras entre produtos
+    uint32_t fase;
+    uint32_t presenca;                  // amostras com o produto na balança
+    float peso;
+    float tara;
+    float ruido;                        // amplitude do ruído uniforme (kg)
+    uint32_t aleatorio;
+} pesagem_gerador_t;
+
+void pesagem_inicia(pesagem_t *p, float taxa_hz);
+
+// filtra o bloco e detecta; retorna quantos produtos foram emitidos (os
+// que passam de max no bloco ficam só em descartados)
+int pesagem_processa(pesagem_t *p, const float *amostras, int n,
+                     pesagem_produto_t *produtos, int max);
+
+void pesagem_gerador_inicia(pesagem_gerador_t *g, float taxa_hz, uint32_t periodo_ms,
+                            uint32_t fase_ms, float peso, uint32_t semente);
+
+void pesagem_gera(pesagem_gerador_t *g, float *amostras, int n);
+
+// retorna false se algum produto se perdeu ou saiu com o peso errado
+bool pesagem_benchmark(void);
+
+#endif
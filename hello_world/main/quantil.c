@@ -0,0 +1,483 @@
+/*
+Arquivo: quantil.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Compactação, junção e consulta do esboço KLL, e o benchmark de
+        custo e erro de posto.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "quantil.h"
+
+// capacidade do nível h com niveis níveis: K no topo, 2/3 a cada nível abaixo
+static uint32_t capacidade(int h, int niveis)
+{
+    uint32_t c = QUANTIL_K;
+
+    for (int d = niveis - 1 - h; d > 0 && c > QUANTIL_LARGURA_MIN; d--)
+    {
+        c = (2 * c + 2) / 3;
+    }
+
+    return c > QUANTIL_LARGURA_MIN ? c : QUANTIL_LARGURA_MIN;
+}
+
+static uint32_t capacidade_total(int niveis)
+{
+    uint32_t total = 0;
+
+    for (int h = 0; h < niveis; h++)
+    {
+        total += capacidade(h, niveis);
+    }
+
+    return total;
+}
+
+static uint32_t usados(const quantil_t *s)
+{
+    return QUANTIL_CAPACIDADE - s->inicio[0];
+}
+
+static uint32_t tamanho(const quantil_t *s, int h)
+{
+    return s->inicio[h + 1] - s->inicio[h];
+}
+
+static int compara(const void *a, const void *b)
+{
+    float x = *(const float *) a, y = *(const float *) b;
+
+    return (x > y) - (x < y);
+}
+
+// novo nível vazio no topo; os itens já estão encostados no fim do vetor
+static bool adiciona_nivel(quantil_t *s)
+{
+    if (s->niveis == QUANTIL_MAX_NIVEIS)
+    {
+        return false;
+    }
+
+    s->niveis++;
+    s->inicio[s->niveis] = QUANTIL_CAPACIDADE;
+
+    return true;
+}
+
+// metade dos itens do nível h (um sim, um não, a partir de um deslocamento
+// sorteado) sobe para h + 1 com peso dobrado; o que sobrou abaixo anda
+// para ocupar o espaço liberado
+static bool compacta(quantil_t *s, int h)
+{
+    uint32_t inicio = s->inicio[h], fim = s->inicio[h + 1];
+    uint32_t impar = (fim - inicio) & 1;
+    uint32_t base = inicio + impar;
+    uint32_t metade = (fim - base) / 2;
+    uint32_t acima, deslocamento, a, b, saida;
+
+    if (metade == 0 || (h + 1 == s->niveis && !adiciona_nivel(s)))
+    {
+        return false;
+    }
+
+    acima = s->inicio[h + 2] - fim;
+
+    if (h == 0)
+    {
+        qsort(&s->itens[base], fim - base, sizeof(float), compara);
+    }
+
+    s->aleatorio = s->aleatorio * 1664525 + 1013904223;
+    deslocamento = s->aleatorio >> 31;
+
+    if (acima == 0)
+    {
+        // nível de cima vazio: os escolhidos vão para a metade de cima
+        for (int j = metade - 1; j >= 0; j--)
+        {
+            s->itens[base + metade + j] = s->itens[base + 2 * j + deslocamento];
+        }
+    } else
+    {
+        // escolhidos para o começo e intercalados com o nível de cima; a
+        // saída nunca passa à frente do que ainda vai ser lido
+        for (uint32_t j = 0; j < metade; j++)
+        {
+            s->itens[base + j] = s->itens[base + 2 * j + deslocamento];
+        }
+
+        a = base;
+        b = fim;
+        saida = base + metade;
+        while (a < base + metade && b < fim + acima)
+        {
+            s->itens[saida++] = s->itens[a] <= s->itens[b] ? s->itens[a++] : s->itens[b++];
+        }
+        while (a < base + metade)
+        {
+            s->itens[saida++] = s->itens[a++];
+        }
+    }
+
+    // níveis 0..h (com o item ímpar de h) sobem metade posições
+    memmove(&s->itens[s->inicio[0] + metade], &s->itens[s->inicio[0]],
+            (base - s->inicio[0]) * sizeof(float));
+    for (int i = 0; i <= h; i++)
+    {
+        s->inicio[i] += metade;
+    }
+    s->inicio[h + 1] = base + metade;
+
+    return true;
+}
+
+// compacta o nível cheio mais baixo até sobrar espaço na capacidade atual
+static void comprime(quantil_t *s)
+{
+    while (usados(s) >= capacidade_total(s->niveis))
+    {
+        int h = 0;
+
+        while (h < s->niveis - 1 && tamanho(s, h) < capacidade(h, s->niveis))
+        {
+            h++;
+        }
+
+        if (!compacta(s, h))
+        {
+            return;
+        }
+    }
+}
+
+void quantil_inicia(quantil_t *s, uint32_t semente)
+{
+    s->n = 0;
+    s->niveis = 1;
+    s->inicio[0] = QUANTIL_CAPACIDADE;
+    s->inicio[1] = QUANTIL_CAPACIDADE;
+    s->aleatorio = semente;
+    s->min = 0;
+    s->max = 0;
+}
+
+static void insere_nivel_0(quantil_t *s, float x)
+{
+    if (usados(s) >= capacidade_total(s->niveis))
+    {
+        comprime(s);
+    }
+
+    s->itens[--s->inicio[0]] = x;
+}
+
+void quantil_acrescenta(quantil_t *s, float x)
+{
+    if (s->n == 0)
+    {
+        s->min = x;
+        s->max = x;
+    } else
+    {
+        s->min = x < s->min ? x : s->min;
+        s->max = x > s->max ? x : s->max;
+    }
+
+    insere_nivel_0(s, x);
+    s->n++;
+}
+
+// intercala m itens ordenados no nível h (h >= 1) de s
+static void insere_nivel(quantil_t *s, int h, const float *itens, uint32_t m)
+{
+    int maior;
+    int32_t a, b, saida;
+
+    // abre espaço compactando o maior nível se a folga não bastar
+    while (s->inicio[0] < m)
+    {
+        maior = 0;
+        for (int i = 1; i < s->niveis; i++)
+        {
+            maior = tamanho(s, i) > tamanho(s, maior) ? i : maior;
+        }
+        if (!compacta(s, maior))
+        {
+            return;
+        }
+    }
+
+    // níveis 0..h descem m posições e deixam o espaço no fim do nível h
+    memmove(&s->itens[s->inicio[0] - m], &s->itens[s->inicio[0]],
+            (s->inicio[h + 1] - s->inicio[0]) * sizeof(float));
+    for (int i = 0; i <= h; i++)
+    {
+        s->inicio[i] -= m;
+    }
+
+    // intercala de trás para frente
+    a = s->inicio[h + 1] - m - 1;
+    b = m - 1;
+    saida = s->inicio[h + 1] - 1;
+    while (b >= 0)
+    {
+        if (a >= (int32_t) s->inicio[h] && s->itens[a] > itens[b])
+        {
+            s->itens[saida--] = s->itens[a--];
+        } else
+        {
+            s->itens[saida--] = itens[b--];
+        }
+    }
+}
+
+void quantil_junta(quantil_t *s, const quantil_t *outro)
+{
+    if (outro->n == 0)
+    {
+        return;
+    }
+
+    if (s->n == 0)
+    {
+        s->min = outro->min;
+        s->max = outro->max;
+    } else
+    {
+        s->min = outro->min < s->min ? outro->min : s->min;
+        s->max = outro->max > s->max ? outro->max : s->max;
+    }
+
+    while (s->niveis < outro->niveis && adiciona_nivel(s))
+    {
+    }
+
+    // níveis ordenados de cima para baixo, compactando entre um e outro
+    for (int h = outro->niveis - 1; h >= 1; h--)
+    {
+        if (tamanho(outro, h) > 0)
+        {
+            insere_nivel(s, h, &outro->itens[outro->inicio[h]], tamanho(outro, h));
+            comprime(s);
+        }
+    }
+
+    for (uint32_t i = outro->inicio[0]; i < outro->inicio[1]; i++)
+    {
+        insere_nivel_0(s, outro->itens[i]);
+    }
+
+    s->n += outro->n;
+}
+
+void quantil_valores(quantil_t *s, const float *q, float *valores, int n)
+{
+    uint32_t posicao[QUANTIL_MAX_NIVEIS];
+    uint64_t acumulado = 0;
+    int k = 0;
+
+    qsort(&s->itens[s->inicio[0]], tamanho(s, 0), sizeof(float), compara);
+
+    for (int h = 0; h < s->niveis; h++)
+    {
+        posicao[h] = s->inicio[h];
+    }
+
+    // intercala os níveis em ordem, cada item pesando 2^nível
+    while (k < n)
+    {
+        int menor = -1;
+
+        for (int h = 0; h < s->niveis; h++)
+        {
+            if (posicao[h] < s->inicio[h + 1] &&
+                (menor < 0 || s->itens[posicao[h]] < s->itens[posicao[menor]]))
+            {
+                menor = h;
+            }
+        }
+
+        if (menor < 0)
+        {
+            break;
+        }
+
+        acumulado += (uint64_t) 1 << menor;
+        while (k < n && acumulado >= q[k] * s->n)
+        {
+            valores[k++] = s->itens[posicao[menor]];
+        }
+        posicao[menor]++;
+    }
+
+    while (k < n)
+    {
+        valores[k++] = s->max;
+    }
+}
+
+#if QUANTIL_BENCHMARK
+#include <stdio.h>
+#include "esp_timer.h"
+#include "lote.h"
+
+#define BENCHMARK_QUANTIS 5
+
+// erro de posto aceito: o limite de 99% de confiança com QUANTIL_K 64
+#define BENCHMARK_ERRO_MAX 0.04f
+
+static const float quantis[BENCHMARK_QUANTIS] = {0.01f, 0.1f, 0.5f, 0.9f, 0.99f};
+
+static quantil_t direto, lote_teste, turno;
+
+// peso variável: ~N(2 kg, 30 g) pela soma de 4 uniformes, com 2% de
+// produtos mal cheios perto de 1,8 kg na cauda de baixo
+static float amostra(uint32_t *aleatorio)
+{
+    float soma = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        *aleatorio = *aleatorio * 1664525 + 1013904223;
+        soma += (*aleatorio >> 8) * (1.0f / (1 << 24));
+    }
+
+    *aleatorio = *aleatorio * 1664525 + 1013904223;
+    if ((*aleatorio >> 24) < 5)
+    {
+        return 1.8f + 0.05f * (soma - 2);
+    }
+
+    return 2.0f + 0.052f * (soma - 2);
+}
+
+// erro de posto normalizado: distância de q·n ao intervalo de postos de v
+static float erros(const float *valores, float *erro)
+{
+    uint32_t menores[BENCHMARK_QUANTIS] = {0}, iguais[BENCHMARK_QUANTIS] = {0};
+    uint32_t aleatorio = 1;
+    uint32_t n = QUANTIL_AMOSTRAS_BENCHMARK;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float x = amostra(&aleatorio);
+
+        for (int k = 0; k < BENCHMARK_QUANTIS; k++)
+        {
+            menores[k] += x < valores[k];
+            iguais[k] += x == valores[k];
+        }
+    }
+
+    float pior = 0;
+
+    for (int k = 0; k < BENCHMARK_QUANTIS; k++)
+    {
+        double alvo = (double) quantis[k] * n;
+        double d = 0;
+
+        if (alvo < menores[k])
+        {
+            d = menores[k] - alvo;
+        } else if (alvo > menores[k] + iguais[k])
+        {
+            d = alvo - menores[k] - iguais[k];
+        }
+        erro[k] = d / n;
+        pior = erro[k] > pior ? erro[k] : pior;
+    }
+
+    return pior;
+}
+
+// quantis de um esboço e o erro de cada um
+static float mostra(const char *nome, quantil_t *s)
+{
+    float valores[BENCHMARK_QUANTIS], erro[BENCHMARK_QUANTIS];
+    float pior;
+
+    quantil_valores(s, quantis, valores, BENCHMARK_QUANTIS);
+    pior = erros(valores, erro);
+    printf("  %s (%d níveis):", nome, s->niveis);
+    for (int k = 0; k < BENCHMARK_QUANTIS; k++)
+    {
+        printf(" p%g %.4f (erro %.2f%%)", quantis[k] * 100, valores[k], erro[k] * 100);
+    }
+    printf("\n");
+
+    return pior;
+}
+
+bool quantil_benchmark(void)
+{
+    uint32_t aleatorio = 1;
+    uint32_t n = QUANTIL_AMOSTRAS_BENCHMARK;
+    int64_t inicio, acrescenta_us, junta_us = 0, gera_us, lote_us;
+    int64_t pior_lote_us = 0;
+    uint32_t juntas = 0;
+    volatile float descarte;
+    float erro_direto, erro_turno;
+
+    // custo de gerar as amostras, descontado da atualização
+    inicio = esp_timer_get_time();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        descarte = amostra(&aleatorio);
+    }
+    gera_us = esp_timer_get_time() - inicio;
+    (void) descarte;
+
+    // um esboço só, todas as amostras
+    quantil_inicia(&direto, 1);
+    aleatorio = 1;
+    inicio = esp_timer_get_time();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        quantil_acrescenta(&direto, amostra(&aleatorio));
+    }
+    acrescenta_us = esp_timer_get_time() - inicio - gera_us;
+
+    // caminho do firmware: a redução monta o esboço do lote de NUM_MAX_PROD
+    // de uma vez (as compactações caem todas nela) e o relatório junta no turno
+    quantil_inicia(&turno, 2);
+    aleatorio = 1;
+    for (uint32_t i = 0; i < n; i += NUM_MAX_PROD)
+    {
+        uint32_t m = n - i < NUM_MAX_PROD ? n - i : NUM_MAX_PROD;
+
+        quantil_inicia(&lote_teste, 3 + juntas);
+        inicio = esp_timer_get_time();
+        for (uint32_t j = 0; j < m; j++)
+        {
+            quantil_acrescenta(&lote_teste, amostra(&aleatorio));
+        }
+        // com a geração das amostras: limite por cima do que a redução gasta
+        lote_us = esp_timer_get_time() - inicio;
+        pior_lote_us = lote_us > pior_lote_us ? lote_us : pior_lote_us;
+
+        inicio = esp_timer_get_time();
+        quantil_junta(&turno, &lote_teste);
+        junta_us += esp_timer_get_time() - inicio;
+        juntas++;
+    }
+
+    printf("Benchmark dos quantis (K %d, %u bytes por esboço, %u amostras): "
+           "acrescenta %.3f us, esboço de um lote no pior caso %lld us, junta de um lote %.1f us\n",
+           QUANTIL_K, (unsigned) sizeof(quantil_t), n, (double) acrescenta_us / n,
+           (long long) pior_lote_us, (double) junta_us / juntas);
+
+    erro_direto = mostra("direto", &direto);
+    erro_turno = mostra("lotes juntados", &turno);
+
+    return direto.n == n && turno.n == n && erro_direto <= BENCHMARK_ERRO_MAX &&
+           erro_turno <= BENCHMARK_ERRO_MAX;
+}
+#endif
@@ -0,0 +1,75 @@
+/*
+Arquivo: quantil.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Esboço de quantis KLL em memória fixa: cada produto entra em
+        O(1) amortizado, esboços de esteiras e lotes diferentes se
+        juntam, e p1/p50/p99 saem com erro de posto limitado por
+        QUANTIL_K, sem guardar nem ordenar todos os pesos.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef QUANTIL_H
+#define QUANTIL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// capacidade do nível mais alto; o erro de posto normalizado fica perto
+// de 2,3 / K^0,97 (99% de confiança): ~3,9% com 64, ~2,6% com 100
+#define QUANTIL_K 64
+
+// nenhum nível guarda menos que isso
+#define QUANTIL_LARGURA_MIN 8
+
+// cada nível vale o dobro do anterior: 26 níveis passam dos 2^32 produtos de n
+#define QUANTIL_MAX_NIVEIS 26
+
+// Σ capacidades ≤ 3K + (LARGURA_MIN + 1) por nível, mais K de folga
+// para a junção inserir um nível inteiro antes de compactar
+#define QUANTIL_CAPACIDADE (4 * QUANTIL_K + (QUANTIL_LARGURA_MIN + 1) * QUANTIL_MAX_NIVEIS)
+
+// o esboço do turno recomeça a cada 8 h
+#define QUANTIL_TURNO_MS (8 * 3600 * 1000)
+
+// 1 = mede custo e erro contra os quantis exatos na partida
+#ifndef QUANTIL_BENCHMARK
+#define QUANTIL_BENCHMARK 0
+#endif
+
+// amostras do benchmark; o posto exato é contado regerando a sequência, sem guardá-la
+#define QUANTIL_AMOSTRAS_BENCHMARK 10000000u
+
+// itens do nível h em itens[inicio[h] .. inicio[h + 1]); o nível 0 fica
+// logo depois do espaço livre e está fora de ordem, os outros ordenados
+typedef struct
+{
+    uint32_t n;                     // produtos representados
+    uint8_t niveis;
+    uint16_t inicio[QUANTIL_MAX_NIVEIS + 1];
+    uint32_t aleatorio;             // escolhe a metade que sobe em cada compactação
+    float min;
+    float max;
+    float itens[QUANTIL_CAPACIDADE];
+} quantil_t;
+
+void quantil_inicia(quantil_t *s, uint32_t semente);
+
+// só compacta quando o nível 0 enche: O(1) amortizado
+void quantil_acrescenta(quantil_t *s, float x);
+
+// s passa a representar também os produtos de outro (que não muda)
+void quantil_junta(quantil_t *s, const quantil_t *outro);
+
+// valores dos quantis q[0..n) (crescentes, 0..1) em uma passada;
+// ordena o nível 0 de s, por isso não é const
+void quantil_valores(quantil_t *s, const float *q, float *valores, int n);
+
+// true se os quantis do esboço direto e do turno ficam dentro do erro de posto
+bool quantil_benchmark(void);
+
+#endif
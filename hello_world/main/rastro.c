@@ -0,0 +1,151 @@
+/*
+Arquivo: rastro.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Anéis de eventos por core. Cada core só escreve no seu
+        anel; ciclos e posição saem juntos numa seção crítica, para
+        uma preempção entre os dois não gravar um evento mais novo
+        antes de um mais velho. O despejo roda numa tarefa de baixa
+        prioridade, soma os bytes do printf à conta do console e
+        amostra (ciclos, tempo) em cada core para o conversor alinhar
+        os dois relógios.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include "rastro.h"
+
+#if RASTRO_HABILITADO
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_ipc.h"
+#include "xtensa/hal.h"
+#include "formato.h"
+
+typedef struct
+{
+    uint32_t ciclos;
+    uint32_t tarefa;        // handle da tarefa, vira o tid no conversor
+    uint8_t regiao;
+    char fase;              // 'B' início, 'E' fim
+} evento_t;
+
+static const char *nomes[RASTRO_NUM_REGIOES] = {
+    "soma_produto", "espera_mutex", "soma_pesos", "soma_paralela",
+    "relatorio", "display", "touch",
+};
+
+static evento_t aneis[portNUM_PROCESSORS][RASTRO_TAMANHO];
+static uint32_t indices[portNUM_PROCESSORS];
+static volatile bool pausado = false;
+static portMUX_TYPE mux_rastro = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t tarefa_despejo = NULL;
+
+// referência (ciclos, us) amostrada em cada core
+static uint32_t ref_ciclos[portNUM_PROCESSORS];
+static int64_t ref_us[portNUM_PROCESSORS];
+
+void rastro_evento(rastro_regiao_t regiao, char fase)
+{
+    if (pausado)
+    {
+        return;
+    }
+
+    uint32_t tarefa = (uint32_t) (uintptr_t) xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&mux_rastro);
+    int core = xPortGetCoreID();
+    evento_t *e = &aneis[core][indices[core]++ & (RASTRO_TAMANHO - 1)];
+
+    e->ciclos = xthal_get_ccount();
+    e->tarefa = tarefa;
+    e->regiao = regiao;
+    e->fase = fase;
+    portEXIT_CRITICAL(&mux_rastro);
+}
+
+static void amostra_referencia(void *arg)
+{
+    int core = xPortGetCoreID();
+
+    ref_ciclos[core] = xthal_get_ccount();
+    ref_us[core] = esp_timer_get_time();
+}
+
+void rastro_despeja(void)
+{
+    pausado = true;
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        esp_ipc_call_blocking(core, &amostra_referencia, NULL);
+    }
+
+    formato_externo(printf("RASTRO INICIO %d\n", CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ));
+
+    for (int r = 0; r < RASTRO_NUM_REGIOES; r++)
+    {
+        formato_externo(printf("RASTRO NOME %d %s\n", r, nomes[r]));
+    }
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        uint32_t fim = indices[core];
+        uint32_t inicio = fim > RASTRO_TAMANHO ? fim - RASTRO_TAMANHO : 0;
+
+        formato_externo(printf("RASTRO REF %d %u %lld\n", core, ref_ciclos[core],
+                               (long long) ref_us[core]));
+
+        // mais antigo primeiro
+        for (uint32_t i = inicio; i < fim; i++)
+        {
+            evento_t *e = &aneis[core][i & (RASTRO_TAMANHO - 1)];
+
+            formato_externo(printf("RASTRO EV %d %c %u %u %08x\n", core, e->fase, e->regiao,
+                                   e->ciclos, e->tarefa));
+        }
+
+        portENTER_CRITICAL(&mux_rastro);
+        indices[core] = 0;
+        portEXIT_CRITICAL(&mux_rastro);
+    }
+
+    formato_externo(printf("RASTRO FIM\n"));
+
+    pausado = false;
+}
+
+// o printf do despejo bloqueia enquanto a UART escoa: fica longe do pipeline
+static void tarefa_rastro(void *pvParameter)
+{
+    while (1)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        rastro_despeja();
+    }
+}
+
+bool rastro_inicia(void)
+{
+    xTaskCreate(&tarefa_rastro, "rastro", 2048, NULL, tskIDLE_PRIORITY, &tarefa_despejo);
+
+    return tarefa_despejo != NULL;
+}
+
+void rastro_pede_despejo(void)
+{
+    if (tarefa_despejo != NULL)
+    {
+        xTaskNotifyGive(tarefa_despejo);
+    }
+}
+
+#endif
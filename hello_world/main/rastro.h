@@ -0,0 +1,71 @@
+/*
+Arquivo: rastro.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Rastro de execução em anéis por core: eventos de início e
+        fim com o contador de ciclos, despejados pela serial e
+        convertidos para o formato Chrome/Perfetto em tools/.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef RASTRO_H
+#define RASTRO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 1 = grava os eventos nos pontos instrumentados (o teste no host liga)
+#ifndef RASTRO_HABILITADO
+#define RASTRO_HABILITADO 0
+#endif
+
+// eventos por core (potência de 2)
+#define RASTRO_TAMANHO 512
+
+// despeja o rastro a cada N lotes
+#define RASTRO_DESPEJO_LOTES 4
+
+// regiões instrumentadas
+typedef enum
+{
+    RASTRO_SOMA_PRODUTO,
+    RASTRO_ESPERA_MUTEX,
+    RASTRO_SOMA_PESOS,
+    RASTRO_SOMA_PARALELA,
+    RASTRO_RELATORIO,
+    RASTRO_DISPLAY,
+    RASTRO_TOUCH,
+    RASTRO_NUM_REGIOES
+} rastro_regiao_t;
+
+#if RASTRO_HABILITADO
+
+void rastro_evento(rastro_regiao_t regiao, char fase);
+
+// imprime os anéis pela serial e recomeça a gravação
+void rastro_despeja(void);
+
+// cria a tarefa de despejo, na prioridade da ociosa
+bool rastro_inicia(void);
+
+// acorda a tarefa de despejo sem esperar o printf
+void rastro_pede_despejo(void);
+
+#define RASTRO_INICIO(r) rastro_evento((r), 'B')
+#define RASTRO_FIM(r) rastro_evento((r), 'E')
+
+#else
+
+#define RASTRO_INICIO(r) do { } while (0)
+#define RASTRO_FIM(r) do { } while (0)
+#define rastro_despeja() do { } while (0)
+#define rastro_inicia() true
+#define rastro_pede_despejo() do { } while (0)
+
+#endif
+
+#endif
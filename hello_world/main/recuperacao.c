@@ -0,0 +1,341 @@
+/*
+Arquivo: recuperacao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Estado de retomada rápida na RTC. Os totais dos lotes já
+        relatados ficam em duas cópias com sequência e CRC (a gravação
+        interrompida estraga só a cópia mais velha); os produtos de
+        cada lote ainda não relatado ficam no diário desse lote,
+        confirmados por uma palavra de selo escrita por último, então
+        um produto conta uma vez ou nenhuma. Um lote só sai do diário
+        para a base depois do relatório: um reset com lotes na fila
+        da redução ou do relatório os devolve ao pipeline.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "esp_attr.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp32/rom/crc.h"
+#include "recuperacao.h"
+
+// as duas primeiras palavras de cada cópia são crc e sequência
+typedef struct
+{
+    uint32_t crc;                       // cobre o restante da cópia
+    uint32_t sequencia;
+    uint32_t lotes;                     // lotes relatados
+    uint32_t contagem[NUM_ESTEIRAS];    // produtos desses lotes
+    double massa[NUM_ESTEIRAS];
+    float ultimo_total;
+    double peso_acumulado;
+} copia_base_t;
+
+typedef struct
+{
+    uint32_t lote;                      // vale só se igual ao número do lote
+    uint32_t selo;                      // produtos confirmados | (~produtos << 16)
+    float pesos[NUM_MAX_PROD];
+    uint8_t esteira[NUM_MAX_PROD];
+    uint8_t classe[NUM_MAX_PROD];       // o peso medido não identifica a classe
+} diario_t;
+
+static RTC_NOINIT_ATTR copia_base_t rtc_base[2];
+static RTC_NOINIT_ATTR diario_t rtc_diario[RECUPERACAO_DIARIOS];
+static RTC_NOINIT_ATTR uint32_t rtc_teste[2];   // total e ~total
+
+// cópia de trabalho em RAM (só o relatório escreve depois da partida)
+static copia_base_t base;
+static int ativa_base;
+
+// lote cujo diário recebe os produtos (só com o mutex das esteiras)
+static uint32_t lote_diario;
+
+// partida: sequência do próximo produto de cada esteira nos lotes devolvidos
+static uint32_t seq_diario[NUM_ESTEIRAS];
+
+static uint32_t selo(uint32_t produtos)
+{
+    return produtos | ((~produtos & 0xFFFF) << 16);
+}
+
+static uint32_t crc_copia(const void *copia, size_t tamanho)
+{
+    return crc32_le(0, (const uint8_t *) copia + sizeof(uint32_t), tamanho - sizeof(uint32_t));
+}
+
+// índice da cópia válida de maior sequência, -1 se nenhuma
+static int copia_valida(const void *copias, size_t tamanho)
+{
+    int melhor = -1;
+    uint32_t sequencia = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        const uint32_t *c = (const uint32_t *) ((const uint8_t *) copias + i * tamanho);
+
+        if (c[0] == crc_copia(c, tamanho) && (melhor < 0 || c[1] > sequencia))
+        {
+            melhor = i;
+            sequencia = c[1];
+        }
+    }
+
+    return melhor;
+}
+
+// grava nova por cima da cópia inativa e a torna ativa
+static void grava_copia(void *copias, size_t tamanho, void *nova, int *ativa)
+{
+    uint32_t *n = (uint32_t *) nova;
+
+    n[1]++;
+    n[0] = crc_copia(n, tamanho);
+
+    *ativa = 1 - *ativa;
+    memcpy((uint8_t *) copias + *ativa * tamanho, nova, tamanho);
+}
+
+static diario_t *diario(uint32_t lote)
+{
+    return &rtc_diario[lote % RECUPERACAO_DIARIOS];
+}
+
+// diário vazio para lote_diario: o selo zera antes do número do lote
+// mudar, senão os produtos do lote que usou o diário antes valeriam de novo
+static void abre_diario(void)
+{
+    diario_t *d = diario(lote_diario);
+
+    __atomic_store_n(&d->selo, selo(0), __ATOMIC_RELEASE);
+    __atomic_store_n(&d->lote, lote_diario, __ATOMIC_RELEASE);
+}
+
+// produtos confirmados no diário do lote; 0 se o diário é de outro lote ou
+// está corrompido (aí o lote recomeça vazio)
+static uint32_t produtos_diario(uint32_t lote)
+{
+    const diario_t *d = diario(lote);
+    uint32_t produtos = d->selo & 0xFFFF;
+
+    if (d->lote != lote || d->selo != selo(produtos) || produtos > NUM_MAX_PROD)
+    {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < produtos; i++)
+    {
+        if (d->esteira[i] >= NUM_ESTEIRAS || d->classe[i] >= LOTE_MAX_CLASSES)
+        {
+            return 0;
+        }
+    }
+
+    return produtos;
+}
+
+// produtos nos diários dos lotes não relatados, do mais antigo ao primeiro
+// que não fechou; lotes recebe quantos diários têm produtos
+static uint32_t produtos_pendentes(uint32_t *lotes)
+{
+    uint32_t total = 0, n = 0, produtos;
+
+    do
+    {
+        produtos = produtos_diario(base.lotes + n);
+        total += produtos;
+        n += produtos > 0;
+    } while (produtos == NUM_MAX_PROD && n < RECUPERACAO_DIARIOS);
+
+    if (lotes != NULL)
+    {
+        *lotes = n;
+    }
+
+    return total;
+}
+
+static bool restaura(checkpoint_t *c)
+{
+    ativa_base = copia_valida(rtc_base, sizeof(copia_base_t));
+    if (ativa_base < 0)
+    {
+        return false;
+    }
+    base = rtc_base[ativa_base];
+
+    c->lotes = base.lotes;
+    c->ultimo_total = base.ultimo_total;
+    c->peso_acumulado = base.peso_acumulado;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        // a massa dos lotes do diário entra quando o relatório os somar
+        c->contagem[i] = base.contagem[i];
+        c->massa[i] = base.massa[i];
+    }
+
+    return true;
+}
+
+// semeia a RTC com o checkpoint da NVS
+static void semeia(const checkpoint_t *c)
+{
+    memset(&base, 0, sizeof(base));
+    ativa_base = 0;
+
+    base.lotes = c->lotes;
+    base.ultimo_total = c->ultimo_total;
+    base.peso_acumulado = c->peso_acumulado;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        base.contagem[i] = c->contagem[i];
+        base.massa[i] = c->massa[i];
+    }
+    grava_copia(rtc_base, sizeof(copia_base_t), &base, &ativa_base);
+
+    lote_diario = base.lotes;
+    abre_diario();
+}
+
+void recuperacao_inicia(checkpoint_t *c, recuperacao_info_t *info)
+{
+    int64_t inicio = esp_timer_get_time();
+    bool preservada;
+
+    memset(info, 0, sizeof(*info));
+
+    // depois de falta de energia a RTC tem lixo; o CRC recusaria,
+    // mas não vale arriscar uma colisão
+    info->motivo = esp_reset_reason();
+    preservada = info->motivo != ESP_RST_POWERON && info->motivo != ESP_RST_BROWNOUT &&
+                 info->motivo != ESP_RST_UNKNOWN;
+
+    info->retomado = preservada && restaura(c);
+    if (!info->retomado)
+    {
+        semeia(c);
+    }
+
+    // recuperacao_lote percorre os diários a partir do primeiro não relatado
+    lote_diario = base.lotes;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        seq_diario[i] = base.contagem[i];
+    }
+
+    info->teste = preservada && rtc_teste[1] == ~rtc_teste[0];
+    info->esperado = rtc_teste[0];
+    rtc_teste[0] = rtc_teste[1] = 0;
+
+    info->produtos_pendentes = produtos_pendentes(&info->lotes_pendentes);
+    info->produtos = info->produtos_pendentes;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        info->produtos += c->contagem[i];
+    }
+
+    info->tempo_us = (uint32_t) (esp_timer_get_time() - inicio);
+}
+
+bool recuperacao_lote(lote_t *lote)
+{
+    const diario_t *d = diario(lote_diario);
+    uint32_t produtos = produtos_diario(lote_diario);
+    int i;
+
+    lote->numero = lote_diario;
+    for (i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        lote->contagem[i] = 0;
+        lote->seq_inicio[i] = seq_diario[i];
+        lote->seq_fim[i] = seq_diario[i];
+    }
+
+    for (i = 0; i < (int) produtos; i++)
+    {
+        lote_insere(lote, i, d->classe[i], d->pesos[i] - lote_peso_classe(d->classe[i]));
+        estatistica_acrescenta(&lote->estatistica[d->esteira[i]], d->pesos[i]);
+        lote->contagem[d->esteira[i]]++;
+        lote->seq_fim[d->esteira[i]]++;
+    }
+    lote->num_produtos = produtos;
+
+    if (produtos < NUM_MAX_PROD)
+    {
+        // lote em preenchimento: os próximos produtos seguem no mesmo diário
+        if (produtos == 0)
+        {
+            abre_diario();
+        }
+        return false;
+    }
+
+    // fechado antes do reset: o seguinte continua as sequências dele
+    for (i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        seq_diario[i] = lote->seq_fim[i];
+    }
+    lote_diario++;
+
+    return true;
+}
+
+void recuperacao_produto(int posicao, int esteira, int classe, float peso)
+{
+    diario_t *d = diario(lote_diario);
+
+    d->pesos[posicao] = peso;
+    d->esteira[posicao] = esteira;
+    d->classe[posicao] = classe;
+
+    // confirma o produto depois que os dados estão na RTC
+    __atomic_store_n(&d->selo, selo(posicao + 1), __ATOMIC_RELEASE);
+}
+
+void recuperacao_fecha_lote(void)
+{
+    // o diário que abre é o de um lote já relatado: o pool tem um buffer a
+    // menos que os diários, e os lotes são relatados em ordem
+    lote_diario++;
+    abre_diario();
+}
+
+void recuperacao_relatado(const checkpoint_t *c)
+{
+    copia_base_t nova = base;
+
+    nova.lotes = c->lotes;
+    nova.ultimo_total = c->ultimo_total;
+    nova.peso_acumulado = c->peso_acumulado;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        nova.contagem[i] = c->contagem[i];
+        nova.massa[i] = c->massa[i];
+    }
+
+    // com a base nova valendo, o diário do lote fica para trás de base.lotes
+    // e nenhuma partida o lê; um reset no meio da gravação deixa a cópia
+    // anterior, e o lote volta do diário para ser relatado de novo
+    grava_copia(rtc_base, sizeof(copia_base_t), &nova, &ativa_base);
+    base = nova;
+}
+
+void recuperacao_teste_reinicia(void)
+{
+    uint32_t total = produtos_pendentes(NULL);
+
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        total += base.contagem[i];
+    }
+
+    rtc_teste[0] = total;
+    rtc_teste[1] = ~total;
+
+    esp_restart();
+}
@@ -0,0 +1,70 @@
+/*
+Arquivo: recuperacao.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Espelho das contagens dos lotes relatados e dos produtos dos
+        lotes ainda não relatados na memória RTC (não inicializada),
+        para retomar depois de um reset por software ou watchdog sem
+        ler a flash e sem perder os lotes que estavam no pipeline.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef RECUPERACAO_H
+#define RECUPERACAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esteiras.h"
+#include "lote.h"
+#include "persistencia.h"
+
+// 1 = reinicia em instantes aleatórios e confere a retomada na partida
+#define RECUPERACAO_TESTE 0
+#define RECUPERACAO_TESTE_MAX_MS 30000
+
+// um diário por lote não relatado: os do pool mais o que abre quando o
+// lote fecha, antes de o relatório liberar um buffer (~1,2 kB cada)
+#define RECUPERACAO_DIARIOS (LOTE_NUM_BUFFERS + 1)
+
+typedef struct
+{
+    bool retomado;          // estado veio da RTC (senão, do checkpoint da NVS)
+    int motivo;             // esp_reset_reason()
+    uint32_t tempo_us;      // validação e restauração
+    uint32_t produtos;      // total de produtos restaurado, relatados ou não
+    uint32_t lotes_pendentes;       // lotes do diário ainda não relatados
+    uint32_t produtos_pendentes;    // produtos desses lotes
+    bool teste;             // o reset anterior foi do modo de teste
+    uint32_t esperado;      // total registrado pelo teste antes do reset
+} recuperacao_info_t;
+
+// na partida: se o reset preservou a RTC e a base confere, sobrescreve c
+// com os lotes, contagens, massas e totais dos lotes já relatados; senão
+// semeia a RTC com c. Os lotes não relatados saem por recuperacao_lote
+void recuperacao_inicia(checkpoint_t *c, recuperacao_info_t *info);
+
+// na partida, depois de recuperacao_inicia, com um buffer livre: devolve em
+// lote o próximo lote do diário, com número e sequências. Retorna true se
+// ele tinha fechado (vai para a redução, e a função é chamada de novo com
+// outro buffer); false para o lote em preenchimento, parcial ou vazio
+bool recuperacao_lote(lote_t *lote);
+
+// dentro do mutex das esteiras: produto na posição do lote atual
+void recuperacao_produto(int posicao, int esteira, int classe, float peso);
+
+// dentro do mutex das esteiras: o lote atual fechou; o diário dele fica até
+// o relatório e o do lote seguinte começa vazio
+void recuperacao_fecha_lote(void);
+
+// relatório, depois de somar o lote: c (totais até o fim dele) passa a ser a
+// base da retomada e o diário do lote deixa de valer
+void recuperacao_relatado(const checkpoint_t *c);
+
+// teste: registra o total atual e reinicia (chamar com o mutex tomado)
+void recuperacao_teste_reinicia(void);
+
+#endif
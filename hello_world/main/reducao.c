@@ -0,0 +1,322 @@
+/*
+Arquivo: reducao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Divide um vetor de tamanho arbitrário em K pedaços,
+        soma cada pedaço num trabalhador persistente e combina
+        as parciais sempre na mesma ordem de árvore. No modo
+        reprodutível os pedaços são blocos de posição fixa, então
+        o resultado não depende de K.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "reducao.h"
+#include "rastro.h"
+
+static const char *nomes[REDUCAO_MAX_TRABALHADORES] = {
+    "soma_0", "soma_1", "soma_2", "soma_3", "soma_4", "soma_5", "soma_6", "soma_7",
+};
+
+static TaskHandle_t trabalhadores[REDUCAO_MAX_TRABALHADORES];
+static int num_trabalhadores = 0;
+
+// trabalho corrente, protegido por mutex_reducao
+static SemaphoreHandle_t mutex_reducao;
+static EventGroupHandle_t grupo_reducao;
+static const float *vetor;
+static int tamanho;
+static int partes;
+static bool por_blocos;
+static int tamanho_bloco;
+static int num_blocos;
+static float parciais[REDUCAO_MAX_TRABALHADORES];
+static float somas_blocos[REDUCAO_MAX_BLOCOS];
+
+// limites do pedaço i de k; cobre todo [0, n) mesmo com n ímpar
+static int limite(int i, int n, int k)
+{
+    return (int) (((int64_t) i * n) / k);
+}
+
+// soma em árvore de pares, em ordem que depende só de n
+static float soma_arvore(float *v, int n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    for (int passo = 1; passo < n; passo *= 2)
+    {
+        for (int i = 0; i + passo < n; i += 2 * passo)
+        {
+            v[i] += v[i + passo];
+        }
+    }
+
+    return v[0];
+}
+
+static void soma_pedaco(int ID)
+{
+    float resultado = 0;
+    int fim = limite(ID + 1, tamanho, partes);
+
+    for (int j = limite(ID, tamanho, partes); j < fim; j++)
+    {
+        resultado += vetor[j];
+    }
+
+    parciais[ID] = resultado;
+}
+
+// cada trabalhador recebe blocos inteiros; a soma de um bloco é
+// sempre sequencial, então não importa quem o somou
+static void soma_blocos(int ID)
+{
+    int fim = limite(ID + 1, num_blocos, partes);
+
+    for (int b = limite(ID, num_blocos, partes); b < fim; b++)
+    {
+        int j = b * tamanho_bloco;
+        int fim_bloco = j + tamanho_bloco < tamanho ? j + tamanho_bloco : tamanho;
+        float resultado = 0;
+
+        for (; j < fim_bloco; j++)
+        {
+            resultado += vetor[j];
+        }
+
+        somas_blocos[b] = resultado;
+    }
+}
+
+static void trabalhador(void *pvParameter)
+{
+    int ID = (int) (intptr_t) pvParameter;
+
+    while(1)
+    {
+        // aguarda um pedaço
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        RASTRO_INICIO(RASTRO_SOMA_PARALELA);
+
+        if (por_blocos)
+        {
+            soma_blocos(ID);
+        } else
+        {
+            soma_pedaco(ID);
+        }
+
+        RASTRO_FIM(RASTRO_SOMA_PARALELA);
+
+        xEventGroupSetBits(grupo_reducao, 1 << ID);
+    }
+}
+
+bool reducao_inicia(int k, UBaseType_t prioridade)
+{
+    if (k < 1 || k > REDUCAO_MAX_TRABALHADORES)
+    {
+        printf("Número de trabalhadores inválido: %d\n", k);
+        return false;
+    }
+
+    mutex_reducao = xSemaphoreCreateMutex();
+    grupo_reducao = xEventGroupCreate();
+
+    if (mutex_reducao == NULL || grupo_reducao == NULL)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < k; i++)
+    {
+        xTaskCreatePinnedToCore(&trabalhador, nomes[i], 2048, (void *) (intptr_t) i, prioridade,
+                                &trabalhadores[i], i % portNUM_PROCESSORS);
+        if (trabalhadores[i] == NULL)
+        {
+            return false;
+        }
+    }
+
+    num_trabalhadores = k;
+
+    return true;
+}
+
+// distribui o trabalho, espera todos e combina
+static float executa(const float *v, int n, int k, bool blocos)
+{
+    EventBits_t todos;
+    float resultado;
+
+    if (k > num_trabalhadores)
+    {
+        k = num_trabalhadores;
+    }
+
+    xSemaphoreTake(mutex_reducao, portMAX_DELAY);
+
+    // sem trabalhadores a máscara seria 0, que o FreeRTOS recusa no assert:
+    // o chamador soma sozinho, na mesma ordem de blocos
+    vetor = v;
+    tamanho = n;
+    partes = k > 0 ? k : 1;
+    por_blocos = blocos;
+    todos = (1 << k) - 1;
+
+    if (blocos)
+    {
+        // menor potência de 2 que mantém o número de blocos no limite
+        tamanho_bloco = REDUCAO_BLOCO_MIN;
+        while ((int64_t) tamanho_bloco * REDUCAO_MAX_BLOCOS < n)
+        {
+            tamanho_bloco *= 2;
+        }
+        num_blocos = (n + tamanho_bloco - 1) / tamanho_bloco;
+    }
+
+    if (k > 0)
+    {
+        for (int i = 0; i < k; i++)
+        {
+            xTaskNotifyGive(trabalhadores[i]);
+        }
+
+        xEventGroupWaitBits(grupo_reducao, todos, pdTRUE, pdTRUE, portMAX_DELAY);
+    } else if (blocos)
+    {
+        soma_blocos(0);
+    } else
+    {
+        soma_pedaco(0);
+    }
+
+    // árvore fixa: (0+1) + (2+3), ... independente de quem terminou antes
+    if (blocos)
+    {
+        resultado = soma_arvore(somas_blocos, num_blocos);
+    } else
+    {
+        resultado = soma_arvore(parciais, partes);
+    }
+
+    xSemaphoreGive(mutex_reducao);
+
+    return resultado;
+}
+
+float reducao_soma_k(const float *v, int n, int k)
+{
+    return executa(v, n, k, false);
+}
+
+float reducao_soma_reprodutivel_k(const float *v, int n, int k)
+{
+    return executa(v, n, k, true);
+}
+
+float reducao_soma(const float *v, int n)
+{
+    return executa(v, n, num_trabalhadores, REDUCAO_REPRODUTIVEL);
+}
+
+const char *reducao_nome(int i)
+{
+    return nomes[i];
+}
+
+// tempo médio de uma soma em us
+static int64_t mede(const float *v, int n, int k, bool blocos, float *resultado)
+{
+    const int repeticoes = 8;
+    int64_t inicio = esp_timer_get_time();
+
+    for (int r = 0; r < repeticoes; r++)
+    {
+        *resultado = executa(v, n, k, blocos);
+    }
+
+    return (esp_timer_get_time() - inicio) / repeticoes;
+}
+
+bool reducao_benchmark(void)
+{
+    static const int tamanhos[] = {200, 1500, 16384, 65536, 262144, 1048576};
+    bool todos_iguais = true;
+
+    printf("Benchmark da redução (us por soma, ingênua / reprodutível)\n");
+    printf("       N  sequencial");
+    for (int k = 1; k <= num_trabalhadores; k++)
+    {
+        printf("          K=%d", k);
+    }
+    printf("  reprodutível igual p/ todo K\n");
+
+    for (int t = 0; t < (int) (sizeof(tamanhos) / sizeof(tamanhos[0])); t++)
+    {
+        int n = tamanhos[t];
+        float *v = malloc(n * sizeof(float));
+
+        // vetores grandes podem não caber na RAM livre
+        if (v == NULL)
+        {
+            printf("%8d  sem memória\n", n);
+            continue;
+        }
+
+        // pesos com resto de arredondamento para a ordem fazer diferença
+        for (int j = 0; j < n; j++)
+        {
+            v[j] = (j % 3 == 0) ? 5.0f : (j % 3 == 1) ? 2.0f : 0.1f * (j % 7);
+        }
+
+        // laço ingênuo sem trabalhadores
+        int64_t inicio = esp_timer_get_time();
+        volatile float ingenua = 0;
+        for (int j = 0; j < n; j++)
+        {
+            ingenua += v[j];
+        }
+        printf("%8d %11lld", n, (long long) (esp_timer_get_time() - inicio));
+
+        float referencia = 0, resultado;
+        bool igual = true;
+
+        for (int k = 1; k <= num_trabalhadores; k++)
+        {
+            int64_t rapida = mede(v, n, k, false, &resultado);
+            int64_t reprodutivel = mede(v, n, k, true, &resultado);
+
+            if (k == 1)
+            {
+                referencia = resultado;
+            } else if (resultado != referencia)
+            {
+                igual = false;
+            }
+
+            printf(" %6lld/%-6lld", (long long) rapida, (long long) reprodutivel);
+        }
+
+        printf("  %s\n", igual ? "sim" : "NAO");
+        todos_iguais &= igual;
+        free(v);
+    }
+
+    return todos_iguais;
+}
@@ -0,0 +1,64 @@
+/*
+Arquivo: reducao.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Redução paralela em K partes com trabalhadores
+        persistentes e combinação em árvore de ordem fixa.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef REDUCAO_H
+#define REDUCAO_H
+
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+
+// limite de trabalhadores (um bit do grupo de eventos por trabalhador)
+#define REDUCAO_MAX_TRABALHADORES 8
+
+// número de trabalhadores usado pelo firmware (padrão: um por core)
+#define REDUCAO_NUM_TRABALHADORES portNUM_PROCESSORS
+
+// 1 = soma em blocos de posição fixa combinados em árvore fixa:
+//     o resultado é o mesmo bit a bit para qualquer K e escalonamento
+// 0 = cada trabalhador acumula seu pedaço (resultado depende de K)
+#define REDUCAO_REPRODUTIVEL 1
+
+// menor bloco da soma reprodutível e máximo de blocos guardados;
+// vetores maiores usam blocos maiores (dependem só de n)
+#ifndef REDUCAO_BLOCO_MIN
+#define REDUCAO_BLOCO_MIN 64
+#endif
+#define REDUCAO_MAX_BLOCOS 1024
+
+// 1 = mede a redução variando K e o tamanho do vetor na partida
+#ifndef REDUCAO_BENCHMARK
+#define REDUCAO_BENCHMARK 0
+#endif
+
+// cria k trabalhadores persistentes, o trabalhador i fica no core i % cores
+bool reducao_inicia(int k, UBaseType_t prioridade);
+
+// soma v[0..n) dividindo em todos os trabalhadores criados,
+// no modo escolhido por REDUCAO_REPRODUTIVEL
+float reducao_soma(const float *v, int n);
+
+// soma v[0..n) usando só os k primeiros trabalhadores
+float reducao_soma_k(const float *v, int n, int k);
+
+// soma reprodutível com os k primeiros trabalhadores
+float reducao_soma_reprodutivel_k(const float *v, int n, int k);
+
+// nome do trabalhador i (para a análise de escalonamento)
+const char *reducao_nome(int i);
+
+// tabela de tempo por K = 1..trabalhadores e tamanho do vetor (até 1M no
+// host; no ESP32 os que não cabem na RAM são pulados); true se a soma
+// reprodutível deu o mesmo resultado bit a bit para todo K
+bool reducao_benchmark(void);
+
+#endif
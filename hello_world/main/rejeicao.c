@@ -0,0 +1,329 @@
+/*
+Arquivo: rejeicao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Decisão de aceite/rejeição com prazo, contadores, histograma
+        de latência e acionamento do ejetor.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "driver/gpio.h"
+#include "rejeicao.h"
+
+// fim do pulso do ejetor (tarefa do esp_timer)
+static void desliga_ejetor(void *arg)
+{
+    rejeicao_t *r = (rejeicao_t *) arg;
+
+    gpio_set_level(r->gpio, 0);
+}
+
+bool rejeicao_inicia(rejeicao_t *r, float nominal, float tolerancia, uint32_t prazo_us, int gpio)
+{
+    memset(r, 0, sizeof(*r));
+    r->minimo = nominal * (1 - tolerancia);
+    r->maximo = nominal * (1 + tolerancia);
+    r->prazo_us = prazo_us;
+    r->gpio = -1;
+
+#if REJEICAO_ATUADOR
+    if (gpio >= 0)
+    {
+        gpio_config_t config = {
+            .pin_bit_mask = 1ULL << gpio,
+            .mode = GPIO_MODE_OUTPUT,
+            .pull_up_en = GPIO_PULLUP_DISABLE,
+            .pull_down_en = GPIO_PULLDOWN_DISABLE,
+            .intr_type = GPIO_INTR_DISABLE,
+        };
+        esp_timer_create_args_t pulso = {
+            .callback = desliga_ejetor,
+            .arg = r,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "ejetor",
+        };
+
+        if (gpio_config(&config) != ESP_OK || esp_timer_create(&pulso, &r->pulso) != ESP_OK)
+        {
+            return false;
+        }
+        gpio_set_level(gpio, 0);
+        r->gpio = gpio;
+    }
+#else
+    (void) desliga_ejetor;
+#endif
+
+    return true;
+}
+
+rejeicao_resultado_t rejeicao_decide(rejeicao_t *r, float peso, int64_t evento_us)
+{
+    rejeicao_resultado_t resultado = REJEICAO_ACEITO;
+    uint32_t latencia;
+    int faixa = 0;
+
+    if (peso < r->minimo)
+    {
+        resultado = REJEICAO_ABAIXO;
+    } else if (peso > r->maximo)
+    {
+        resultado = REJEICAO_ACIMA;
+    }
+
+    latencia = (uint32_t) (esp_timer_get_time() - evento_us);
+
+    for (uint32_t us = latencia; us > 1 && faixa < REJEICAO_FAIXAS - 1; us >>= 1)
+    {
+        faixa++;
+    }
+    r->faixas[faixa]++;
+    if (latencia > r->latencia_max_us)
+    {
+        r->latencia_max_us = latencia;
+    }
+
+    if (latencia > r->prazo_us)
+    {
+        // o produto já passou do ejetor: nada a acionar, só a contagem
+        r->atrasados++;
+        if (resultado != REJEICAO_ACEITO)
+        {
+            r->atrasados_fora++;
+        }
+        return REJEICAO_ATRASADO;
+    }
+
+    if (resultado == REJEICAO_ACEITO)
+    {
+        r->aceitos++;
+        return resultado;
+    }
+
+    if (resultado == REJEICAO_ABAIXO)
+    {
+        r->abaixo++;
+    } else
+    {
+        r->acima++;
+    }
+
+    if (r->gpio >= 0)
+    {
+        // pulso novo reinicia o anterior se dois rejeitados vierem colados
+        gpio_set_level(r->gpio, 1);
+        esp_timer_stop(r->pulso);
+        esp_timer_start_once(r->pulso, REJEICAO_PULSO_US);
+    }
+
+    return resultado;
+}
+
+uint32_t rejeicao_percentil_us(const rejeicao_t *r, float p)
+{
+    uint32_t total = 0, acumulado = 0;
+
+    for (int i = 0; i < REJEICAO_FAIXAS; i++)
+    {
+        total += r->faixas[i];
+    }
+
+    for (int i = 0; i < REJEICAO_FAIXAS; i++)
+    {
+        acumulado += r->faixas[i];
+        if (acumulado > 0 && acumulado >= p * total)
+        {
+            return 2u << i;
+        }
+    }
+
+    return 0;
+}
+
+#if REJEICAO_BENCHMARK
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#define BENCHMARK_ESTEIRAS 64
+#define BENCHMARK_PRODUTOS_S 1000
+#define BENCHMARK_MS 10000
+
+typedef struct
+{
+    uint8_t esteira;
+    rejeicao_resultado_t esperado;  // pela faixa, antes de qualquer atraso
+    float peso;
+    int64_t evento_us;
+} evento_t;
+
+static rejeicao_t esteiras_teste[BENCHMARK_ESTEIRAS];
+static QueueHandle_t fila_eventos;
+static uint32_t gerados, perdidos, erradas, decididos;
+static uint32_t aleatorio = 1;
+static bool sincronizadas;
+
+// pesos nominais de 0,5 a 5 kg com ±3% de variação: ~1/3 fora da faixa de ±2%
+static float nominal(int k)
+{
+    return 0.5f + 4.5f * k / (BENCHMARK_ESTEIRAS - 1);
+}
+
+static void gera(int k, int64_t agora)
+{
+    evento_t e;
+    float variacao;
+
+    aleatorio = aleatorio * 1664525 + 1013904223;
+    variacao = 0.06f * ((aleatorio >> 8) * (1.0f / (1 << 24)) - 0.5f);
+
+    e.esteira = k;
+    e.peso = nominal(k) * (1 + variacao);
+    e.evento_us = agora;
+    e.esperado = e.peso < esteiras_teste[k].minimo ? REJEICAO_ABAIXO :
+                 e.peso > esteiras_teste[k].maximo ? REJEICAO_ACIMA : REJEICAO_ACEITO;
+
+    if (xQueueSend(fila_eventos, &e, 0) != pdTRUE)
+    {
+        perdidos++;
+    }
+    gerados++;
+}
+
+// 1 produto por ms em esteiras alternadas, ou as 64 de uma vez a cada 64 ms
+static void fotocelulas(void *arg)
+{
+    static uint32_t tique;
+    int64_t agora = esp_timer_get_time();
+
+    if (!sincronizadas)
+    {
+        gera(tique % BENCHMARK_ESTEIRAS, agora);
+    } else if (tique % BENCHMARK_ESTEIRAS == 0)
+    {
+        for (int k = 0; k < BENCHMARK_ESTEIRAS; k++)
+        {
+            gera(k, agora);
+        }
+    }
+    tique++;
+}
+
+static void decisor(void *pvParameter)
+{
+    evento_t e;
+
+    while (1)
+    {
+        xQueueReceive(fila_eventos, &e, portMAX_DELAY);
+
+        rejeicao_resultado_t r = rejeicao_decide(&esteiras_teste[e.esteira], e.peso, e.evento_us);
+        if (r != REJEICAO_ATRASADO && r != e.esperado)
+        {
+            erradas++;
+        }
+        decididos++;
+    }
+}
+
+// carga de fundo no mesmo core, abaixo do decisor; cede um tick de vez
+// em quando para a tarefa ociosa não disparar o watchdog
+static void carga(void *pvParameter)
+{
+    volatile uint32_t x = 0;
+
+    while (1)
+    {
+        for (int i = 0; i < 100000; i++)
+        {
+            x++;
+        }
+        vTaskDelay(1);
+    }
+}
+
+static void rodada(bool sincronizar, const char *nome)
+{
+    esp_timer_handle_t timer;
+    esp_timer_create_args_t args = {
+        .callback = fotocelulas,
+        .arg = NULL,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "fotocelulas",
+    };
+    uint32_t aceitos = 0, rejeitados = 0, atrasados = 0, pior = 0;
+    rejeicao_t total;
+
+    memset(&total, 0, sizeof(total));
+    for (int k = 0; k < BENCHMARK_ESTEIRAS; k++)
+    {
+        rejeicao_inicia(&esteiras_teste[k], nominal(k), REJEICAO_TOLERANCIA, REJEICAO_PRAZO_US, -1);
+    }
+    gerados = perdidos = erradas = decididos = 0;
+    sincronizadas = sincronizar;
+
+    esp_timer_create(&args, &timer);
+    esp_timer_start_periodic(timer, 1000000 / BENCHMARK_PRODUTOS_S);
+    vTaskDelay(BENCHMARK_MS / portTICK_RATE_MS);
+    esp_timer_stop(timer);
+    esp_timer_delete(timer);
+
+    // espera o decisor esvaziar a fila
+    while (decididos + perdidos < gerados)
+    {
+        vTaskDelay(1);
+    }
+
+    for (int k = 0; k < BENCHMARK_ESTEIRAS; k++)
+    {
+        rejeicao_t *r = &esteiras_teste[k];
+
+        aceitos += r->aceitos;
+        rejeitados += r->abaixo + r->acima;
+        atrasados += r->atrasados;
+        pior = r->latencia_max_us > pior ? r->latencia_max_us : pior;
+        for (int i = 0; i < REJEICAO_FAIXAS; i++)
+        {
+            total.faixas[i] += r->faixas[i];
+        }
+    }
+
+    printf("  %s: %u produtos (%u perdidos), %u aceitos, %u rejeitados, %u atrasados, "
+           "%u decisões erradas; latência p50 < %u us, p99 < %u us, máx %u us (prazo %u us)\n",
+           nome, gerados, perdidos, aceitos, rejeitados, atrasados, erradas,
+           rejeicao_percentil_us(&total, 0.5f), rejeicao_percentil_us(&total, 0.99f),
+           pior, REJEICAO_PRAZO_US);
+}
+
+void rejeicao_benchmark(void)
+{
+    TaskHandle_t tarefa_decisor, tarefa_carga;
+    UBaseType_t prioridade = uxTaskPriorityGet(NULL);
+
+    fila_eventos = xQueueCreate(2 * BENCHMARK_ESTEIRAS, sizeof(evento_t));
+    if (fila_eventos == NULL ||
+        xTaskCreatePinnedToCore(&decisor, "decisor", 2048, NULL, prioridade + 1,
+                                &tarefa_decisor, xPortGetCoreID()) != pdPASS ||
+        xTaskCreatePinnedToCore(&carga, "carga", 1024, NULL, tskIDLE_PRIORITY + 1,
+                                &tarefa_carga, xPortGetCoreID()) != pdPASS)
+    {
+        printf("Benchmark da rejeição: sem memória\n");
+        return;
+    }
+
+    printf("Benchmark da rejeição: %d esteiras, %d produtos/s somados, %d s por rodada\n",
+           BENCHMARK_ESTEIRAS, BENCHMARK_PRODUTOS_S, BENCHMARK_MS / 1000);
+    rodada(false, "espalhadas");
+    rodada(true, "sincronizadas");
+
+    vTaskDelete(tarefa_carga);
+    vTaskDelete(tarefa_decisor);
+    vQueueDelete(fila_eventos);
+}
+#endif
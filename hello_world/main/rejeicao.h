@@ -0,0 +1,80 @@
+/*
+Arquivo: rejeicao.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Verificação de peso (checkweigher): cada produto pesado é
+        aceito ou rejeitado pela faixa de tolerância da esteira antes
+        de chegar ao ejetor. A decisão tem prazo a partir do evento do
+        produto; decisões fora do prazo são contadas à parte, com o
+        histograma das latências.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef REJEICAO_H
+#define REJEICAO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_timer.h"
+
+// faixa aceita: peso nominal da esteira ± essa fração
+#define REJEICAO_TOLERANCIA 0.02f
+
+// tempo que o produto leva da balança ao ejetor: a decisão precisa sair antes
+#define REJEICAO_PRAZO_US 20000
+
+// 1 = pulsa o GPIO do ejetor de cada esteira ao rejeitar; 0 = só conta
+#define REJEICAO_ATUADOR 0
+
+// duração do pulso do ejetor
+#define REJEICAO_PULSO_US 30000
+
+// faixas do histograma de latência: [2^i, 2^(i+1)) us, como na telemetria
+#define REJEICAO_FAIXAS 16
+
+// 1 = simula 64 esteiras a 1000 produtos/s somados na partida
+#define REJEICAO_BENCHMARK 0
+
+typedef enum
+{
+    REJEICAO_ACEITO,
+    REJEICAO_ABAIXO,
+    REJEICAO_ACIMA,
+    REJEICAO_ATRASADO,              // o produto já passou do ejetor
+} rejeicao_resultado_t;
+
+// escrito só pela tarefa da esteira; o display lê os contadores soltos
+typedef struct
+{
+    float minimo;
+    float maximo;
+    uint32_t prazo_us;
+    int gpio;                       // ejetor, -1 sem atuador
+    esp_timer_handle_t pulso;       // desliga o ejetor no fim do pulso
+
+    uint32_t aceitos;
+    uint32_t abaixo;
+    uint32_t acima;
+    uint32_t atrasados;
+    uint32_t atrasados_fora;        // fora da faixa e atrasados: passaram sem rejeitar
+    uint32_t latencia_max_us;       // evento -> decisão
+    uint32_t faixas[REJEICAO_FAIXAS];
+} rejeicao_t;
+
+// faixa nominal ± tolerancia; gpio < 0 ou REJEICAO_ATUADOR 0 só contam
+bool rejeicao_inicia(rejeicao_t *r, float nominal, float tolerancia, uint32_t prazo_us, int gpio);
+
+// decide o produto de peso pesado no instante evento_us (esp_timer) e
+// aciona o ejetor se for rejeitado a tempo
+rejeicao_resultado_t rejeicao_decide(rejeicao_t *r, float peso, int64_t evento_us);
+
+// limite superior do percentil p (0..1) das latências pelo histograma
+uint32_t rejeicao_percentil_us(const rejeicao_t *r, float p);
+
+void rejeicao_benchmark(void);
+
+#endif
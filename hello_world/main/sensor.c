@@ -0,0 +1,351 @@
+/*
+Arquivo: sensor.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Fontes de amostras das células de carga: gerador sintético,
+        reprodução de traço (memória ou partição) e ADC por DMA.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/i2s.h"
+#include "driver/adc.h"
+#include "esp_partition.h"
+#include "sensor.h"
+
+// 12 bits de dado; os 4 de cima trazem o canal
+#define ADC_DADO 0x0FFF
+
+// traço da partição, mapeado uma vez e compartilhado pelas esteiras
+static const sensor_traco_t *traco_mapeado = NULL;
+static spi_flash_mmap_handle_t handle_traco;
+
+void sensor_inicia_sintetico(sensor_t *s, float taxa_hz, uint32_t periodo_ms, uint32_t fase_ms,
+                             float peso, uint32_t semente)
+{
+    memset(s, 0, sizeof(*s));
+
+    s->fonte = SENSOR_SINTETICO;
+    s->taxa_hz = taxa_hz;
+    pesagem_gerador_inicia(&s->gerador, taxa_hz, periodo_ms, fase_ms, peso, semente);
+}
+
+void sensor_inicia_replay(sensor_t *s, float taxa_hz, const int16_t *traco, uint32_t tamanho,
+                          float kg_por_lsb, uint32_t inicio)
+{
+    memset(s, 0, sizeof(*s));
+
+    s->fonte = SENSOR_REPLAY;
+    s->taxa_hz = taxa_hz;
+    s->traco = traco;
+    s->tamanho = tamanho;
+    s->posicao = inicio % tamanho;
+    s->kg_por_lsb = kg_por_lsb;
+}
+
+bool sensor_inicia_traco(sensor_t *s, float taxa_hz, uint32_t inicio)
+{
+    if (traco_mapeado == NULL)
+    {
+        const esp_partition_t *particao;
+        const void *mapa;
+
+        particao = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, SENSOR_TRACO_SUBTIPO, NULL);
+        if (particao == NULL ||
+            esp_partition_mmap(particao, 0, particao->size, SPI_FLASH_MMAP_DATA,
+                               &mapa, &handle_traco) != ESP_OK)
+        {
+            return false;
+        }
+
+        const sensor_traco_t *t = mapa;
+
+        if (t->magico != SENSOR_TRACO_MAGICO || t->amostras == 0 ||
+            t->amostras > (particao->size - sizeof(*t)) / sizeof(int16_t))
+        {
+            spi_flash_munmap(handle_traco);
+            return false;
+        }
+
+        traco_mapeado = t;
+    }
+
+    // reamostrar mudaria os tempos de assentamento: só aceita a mesma taxa
+    if (traco_mapeado->taxa_hz != (uint32_t) taxa_hz)
+    {
+        return false;
+    }
+
+    sensor_inicia_replay(s, taxa_hz, (const int16_t *) (traco_mapeado + 1), traco_mapeado->amostras,
+                         traco_mapeado->kg_por_lsb, inicio);
+
+    return true;
+}
+
+bool sensor_inicia_adc(sensor_t *s, float taxa_hz, int bloco)
+{
+    int tamanho_dma = bloco < SENSOR_ADC_MAX_DMA ? bloco : SENSOR_ADC_MAX_DMA;
+    i2s_config_t config = {
+        .mode = I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN,
+        .sample_rate = (int) taxa_hz,
+        .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+        .channel_format = I2S_CHANNEL_FMT_ONLY_RIGHT,
+        .communication_format = I2S_COMM_FORMAT_I2S_MSB,
+        .intr_alloc_flags = 0,
+        .dma_buf_count = SENSOR_ADC_BUFFERS_DMA,
+        .dma_buf_len = tamanho_dma,
+        .use_apll = false,
+    };
+
+    memset(s, 0, sizeof(*s));
+
+    s->fonte = SENSOR_ADC_DMA;
+    s->taxa_hz = taxa_hz;
+    s->kg_por_lsb = SENSOR_ADC_KG_POR_LSB;
+    s->tamanho_dma = tamanho_dma;
+    s->bruto = malloc(tamanho_dma * sizeof(uint16_t));
+
+    if (s->bruto == NULL)
+    {
+        return false;
+    }
+
+    // o driver só acorda a tarefa quando um buffer de DMA inteiro chega
+    if (i2s_driver_install(I2S_NUM_0, &config, 0, NULL) != ESP_OK)
+    {
+        free(s->bruto);
+        s->bruto = NULL;
+        return false;
+    }
+
+    adc1_config_channel_atten(SENSOR_ADC_CANAL, ADC_ATTEN_DB_11);
+    i2s_set_adc_mode(ADC_UNIT_1, SENSOR_ADC_CANAL);
+    i2s_adc_enable(I2S_NUM_0);
+
+    return true;
+}
+
+void sensor_para(sensor_t *s)
+{
+    if (s->fonte == SENSOR_ADC_DMA && s->bruto != NULL)
+    {
+        i2s_adc_disable(I2S_NUM_0);
+        i2s_driver_uninstall(I2S_NUM_0);
+        free(s->bruto);
+        s->bruto = NULL;
+    }
+}
+
+static int le_adc(sensor_t *s, float *amostras, int n)
+{
+    int lidas = 0;
+
+    while (lidas < n)
+    {
+        int k = n - lidas < s->tamanho_dma ? n - lidas : s->tamanho_dma;
+        size_t bytes = 0;
+
+        s->leituras++;
+        if (i2s_read(I2S_NUM_0, s->bruto, k * sizeof(uint16_t), &bytes, portMAX_DELAY) != ESP_OK)
+        {
+            s->falhas++;
+            break;
+        }
+
+        k = bytes / sizeof(uint16_t);
+        for (int i = 0; i < k; i++)
+        {
+            amostras[lidas + i] = (s->bruto[i] & ADC_DADO) * s->kg_por_lsb;
+        }
+        lidas += k;
+    }
+
+    return lidas;
+}
+
+static void le_replay(sensor_t *s, float *amostras, int n)
+{
+    const int16_t *traco = s->traco;
+    float escala = s->kg_por_lsb;
+    uint32_t posicao = s->posicao;
+
+    for (int i = 0; i < n; )
+    {
+        // trecho contínuo até o fim do traço
+        int k = s->tamanho - posicao < (uint32_t) (n - i) ? (int) (s->tamanho - posicao) : n - i;
+
+        for (int j = 0; j < k; j++)
+        {
+            amostras[i + j] = traco[posicao + j] * escala;
+        }
+
+        i += k;
+        posicao += k;
+        if (posicao == s->tamanho)
+        {
+            posicao = 0;
+        }
+    }
+
+    s->posicao = posicao;
+}
+
+int sensor_bloco(sensor_t *s, float *amostras, int n)
+{
+    s->blocos++;
+
+    switch (s->fonte)
+    {
+    case SENSOR_ADC_DMA:
+        return le_adc(s, amostras, n);
+
+    case SENSOR_REPLAY:
+        le_replay(s, amostras, n);
+        return n;
+
+    case SENSOR_SINTETICO:
+    default:
+        pesagem_gera(&s->gerador, amostras, n);
+        return n;
+    }
+}
+
+void sensor_executa(sensor_t *s, float *amostras, int n, TickType_t epoca,
+                    sensor_bloco_cb callback, void *ctx)
+{
+    TickType_t acordar = epoca;
+    TickType_t periodo = (TickType_t) (n * 1000 / s->taxa_hz) / portTICK_RATE_MS;
+
+    while (1)
+    {
+        // o ADC tem o relógio do I2S; as outras fontes seguem o tick
+        if (s->fonte != SENSOR_ADC_DMA)
+        {
+            vTaskDelayUntil(&acordar, periodo);
+        }
+
+        if (sensor_bloco(s, amostras, n) == n)
+        {
+            callback(ctx, amostras, n);
+        }
+    }
+}
+
+#if SENSOR_BENCHMARK
+#include <stdio.h>
+#include "esp_timer.h"
+
+// amostras por medição de cada fonte
+#define BENCHMARK_AMOSTRAS 65536
+#define BENCHMARK_TRACO 16384
+#define BENCHMARK_PERIODO_MS 500
+
+// o ADC roda em tempo real: menos amostras, taxa mais alta
+#define BENCHMARK_ADC_AMOSTRAS 16384
+#define BENCHMARK_ADC_TAXA_HZ 10000
+
+static const int tamanhos[] = {64, 256, 1024, 4096};
+
+// amostras/s lendo blocos e, com pesagem != NULL, lendo e detectando
+static double mede(sensor_t *s, float *amostras, int bloco, int total, pesagem_t *pesagem)
+{
+    pesagem_produto_t produtos[PESAGEM_MAX_PRODUTOS];
+    int64_t inicio = esp_timer_get_time();
+    int lidas = 0;
+
+    while (lidas < total)
+    {
+        int k = sensor_bloco(s, amostras, bloco);
+
+        if (k <= 0)
+        {
+            break;
+        }
+        if (pesagem != NULL)
+        {
+            pesagem_processa(pesagem, amostras, k, produtos, PESAGEM_MAX_PRODUTOS);
+        }
+        lidas += k;
+    }
+
+    return (double) lidas * 1000000 / (esp_timer_get_time() - inicio);
+}
+
+void sensor_benchmark(void)
+{
+    float *amostras = malloc(tamanhos[3] * sizeof(float));
+    int16_t *traco = malloc(BENCHMARK_TRACO * sizeof(int16_t));
+    sensor_t s;
+    pesagem_t p;
+
+    if (amostras == NULL || traco == NULL)
+    {
+        printf("Benchmark do sensor: sem memória\n");
+        free(amostras);
+        free(traco);
+        return;
+    }
+
+    // traço em RAM quantizado a 1 g, a partir do gerador
+    sensor_inicia_sintetico(&s, PESAGEM_TAXA_HZ, BENCHMARK_PERIODO_MS, 0, 2.0f, 1);
+    for (int i = 0; i < BENCHMARK_TRACO; i += tamanhos[0])
+    {
+        sensor_bloco(&s, amostras, tamanhos[0]);
+        for (int j = 0; j < tamanhos[0]; j++)
+        {
+            traco[i + j] = (int16_t) (amostras[j] * 1000 + 0.5f);
+        }
+    }
+
+    printf("Benchmark do sensor (milhões de amostras/s; leitura | leitura + detecção)\n");
+
+    for (int t = 0; t < 4; t++)
+    {
+        int bloco = tamanhos[t];
+        double sintetico, sintetico_det, replay, replay_det;
+
+        sensor_inicia_sintetico(&s, PESAGEM_TAXA_HZ, BENCHMARK_PERIODO_MS, 0, 2.0f, 1);
+        sintetico = mede(&s, amostras, bloco, BENCHMARK_AMOSTRAS, NULL);
+        pesagem_inicia(&p, PESAGEM_TAXA_HZ);
+        sintetico_det = mede(&s, amostras, bloco, BENCHMARK_AMOSTRAS, &p);
+
+        sensor_inicia_replay(&s, PESAGEM_TAXA_HZ, traco, BENCHMARK_TRACO, 0.001f, 0);
+        replay = mede(&s, amostras, bloco, BENCHMARK_AMOSTRAS, NULL);
+        pesagem_inicia(&p, PESAGEM_TAXA_HZ);
+        replay_det = mede(&s, amostras, bloco, BENCHMARK_AMOSTRAS, &p);
+
+        printf("  bloco %4d: sintético %.2f | %.2f, replay %.2f | %.2f\n", bloco,
+               sintetico / 1e6, sintetico_det / 1e6, replay / 1e6, replay_det / 1e6);
+    }
+
+#if SENSOR_FONTE == SENSOR_ADC_DMA
+    // no ADC a vazão é a do relógio; o que importa é acordar uma vez por buffer
+    for (int t = 0; t < 4; t++)
+    {
+        int bloco = tamanhos[t];
+
+        if (!sensor_inicia_adc(&s, BENCHMARK_ADC_TAXA_HZ, bloco))
+        {
+            printf("  ADC bloco %4d: driver não instalou\n", bloco);
+            continue;
+        }
+
+        double taxa = mede(&s, amostras, bloco, BENCHMARK_ADC_AMOSTRAS, NULL);
+
+        printf("  ADC bloco %4d: %.0f amostras/s (nominal %d), %.2f despertares por bloco, %u falhas\n",
+               bloco, taxa, BENCHMARK_ADC_TAXA_HZ, (double) s.leituras / s.blocos, s.falhas);
+        sensor_para(&s);
+    }
+#endif
+
+    free(amostras);
+    free(traco);
+}
+#endif
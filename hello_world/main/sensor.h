@@ -0,0 +1,115 @@
+/*
+Arquivo: sensor.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Camada de entrada das células de carga: entrega blocos de
+        amostras em kg, vindos do ADC por DMA (I2S0 no modo ADC),
+        da reprodução de um traço gravado ou do gerador sintético.
+        A detecção recebe um bloco por vez, nunca amostra a amostra.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "pesagem.h"
+
+// fontes (macros, e não enum, para valerem no #if de SENSOR_FONTE)
+#define SENSOR_SINTETICO 0          // pesagem_gerador_t
+#define SENSOR_REPLAY 1             // traço int16 em memória ou na partição "traco"
+#define SENSOR_ADC_DMA 2            // ADC1 amostrado pelo I2S0 com DMA
+
+// fonte das esteiras; o ADC por DMA existe só no I2S0, então fica com a
+// primeira esteira e as outras seguem no gerador sintético
+#define SENSOR_FONTE SENSOR_SINTETICO
+
+// canal e conversão do ADC (12 bits, atenuação de 11 dB)
+#define SENSOR_ADC_CANAL ADC1_CHANNEL_0     // GPIO36
+#define SENSOR_ADC_KG_POR_LSB 0.005f        // 20 kg no fundo de escala
+#define SENSOR_ADC_BUFFERS_DMA 4
+
+// o I2S limita cada buffer de DMA a 1024 amostras
+#define SENSOR_ADC_MAX_DMA 1024
+
+// subtipo da partição "traco" em partitions.csv
+#define SENSOR_TRACO_SUBTIPO 0x41
+#define SENSOR_TRACO_MAGICO 0x31435254      // "TRC1"
+
+// 1 = mede a vazão de cada fonte com blocos de 64 a 4096 amostras na partida
+#ifndef SENSOR_BENCHMARK
+#define SENSOR_BENCHMARK 0
+#endif
+
+// cabeçalho do traço gravado (tools/traco_grava.py), seguido das amostras
+typedef struct
+{
+    uint32_t magico;
+    uint32_t taxa_hz;
+    uint32_t amostras;
+    float kg_por_lsb;
+} sensor_traco_t;
+
+typedef struct
+{
+    int fonte;
+    float taxa_hz;
+
+    // sintético
+    pesagem_gerador_t gerador;
+
+    // reprodução: volta ao início no fim do traço
+    const int16_t *traco;
+    uint32_t tamanho;
+    uint32_t posicao;
+    float kg_por_lsb;
+
+    // ADC: leituras brutas de um buffer de DMA
+    uint16_t *bruto;
+    int tamanho_dma;
+
+    uint32_t blocos;
+    uint32_t leituras;              // vezes em que a tarefa acordou para ler
+    uint32_t falhas;
+} sensor_t;
+
+// recebe cada bloco lido; roda na tarefa que chamou sensor_executa
+typedef void (*sensor_bloco_cb)(void *ctx, const float *amostras, int n);
+
+void sensor_inicia_sintetico(sensor_t *s, float taxa_hz, uint32_t periodo_ms, uint32_t fase_ms,
+                             float peso, uint32_t semente);
+
+// traco fica com quem chamou; inicio é a primeira amostra reproduzida
+void sensor_inicia_replay(sensor_t *s, float taxa_hz, const int16_t *traco, uint32_t tamanho,
+                          float kg_por_lsb, uint32_t inicio);
+
+// mapeia a partição "traco"; false se ela não existe ou não tem um traço
+// válido nessa taxa
+bool sensor_inicia_traco(sensor_t *s, float taxa_hz, uint32_t inicio);
+
+// instala o I2S0 no modo ADC com buffers de DMA do tamanho do bloco
+// (até SENSOR_ADC_MAX_DMA); false se o driver não instalou
+bool sensor_inicia_adc(sensor_t *s, float taxa_hz, int bloco);
+
+void sensor_para(sensor_t *s);
+
+// preenche n amostras em kg; o ADC bloqueia até o DMA completar os
+// buffers, as outras fontes respondem na hora. Retorna as amostras lidas
+int sensor_bloco(sensor_t *s, float *amostras, int n);
+
+// laço da tarefa dona do sensor: um bloco de n amostras por vez em
+// amostras, a partir do tick epoca; não retorna. Fontes sem relógio
+// próprio são cadenciadas pelo periodo do bloco
+void sensor_executa(sensor_t *s, float *amostras, int n, TickType_t epoca,
+                    sensor_bloco_cb callback, void *ctx);
+
+void sensor_benchmark(void);
+
+#endif
@@ -0,0 +1,72 @@
+/*
+Arquivo: serie.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Séries temporais de contagem e massa de cada esteira em anéis
+        de tamanho fixo com resolução de 1 s, 1 min e 1 h. O produto só
+        soma no segundo aberto; cada intervalo que fecha desce em
+        cascata para o nível de cima, sem reler nada.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef SERIE_H
+#define SERIE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// níveis de resolução
+#define SERIE_SEGUNDO 0
+#define SERIE_MINUTO 1
+#define SERIE_HORA 2
+#define SERIE_NIVEIS 3
+
+// intervalos guardados em cada nível: 1 min de segundos, 1 h de minutos, 1 dia de horas
+#define SERIE_SEGUNDOS 60
+#define SERIE_MINUTOS 60
+#define SERIE_HORAS 24
+
+// 1 = mede custo por produto, consulta e memória com 3 e 64 esteiras na partida
+#ifndef SERIE_BENCHMARK
+#define SERIE_BENCHMARK 0
+#endif
+
+// massa em gramas inteiros, como o desvio arquivado no lote: passando de
+// 8 t, um float de hora arredonda cada produto somado em até meio grama,
+// e a soma inteira não deriva. 32 bits dão 4294 t por intervalo
+typedef struct
+{
+    uint32_t contagem;
+    uint32_t massa_g;
+} serie_ponto_t;
+
+// um escritor (a tarefa da esteira); leitores sem trava pela sequência
+typedef struct
+{
+    uint32_t sequencia;             // ímpar durante a escrita
+    int64_t fim_segundo_us;         // caminho rápido: produto ainda no segundo aberto
+    uint32_t aberto[SERIE_NIVEIS];  // intervalo aberto de cada nível, contado desde a partida
+    serie_ponto_t segundos[SERIE_SEGUNDOS];
+    serie_ponto_t minutos[SERIE_MINUTOS];
+    serie_ponto_t horas[SERIE_HORAS];
+} serie_t;
+
+void serie_inicia(serie_t *s, int64_t agora_us);
+
+// contagem produtos somando massa (kg, arredondada ao grama) no instante
+// agora_us (esp_timer); instantes anteriores ao segundo aberto contam nele
+void serie_acrescenta(serie_t *s, uint32_t contagem, float massa, int64_t agora_us);
+
+// os n últimos intervalos do nível até o que contém agora_us (em
+// andamento, o último), do mais antigo ao mais novo; intervalos além do
+// que o anel guarda saem zerados. Retorna n
+int serie_consulta(const serie_t *s, int nivel, int64_t agora_us, serie_ponto_t *pontos, int n);
+
+// true se as horas de cada esteira somam exatamente a contagem e a massa geradas
+bool serie_benchmark(void);
+
+#endif
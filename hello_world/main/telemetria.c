@@ -0,0 +1,104 @@
+/*
+Arquivo: telemetria.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Montagem dos quadros de telemetria (CRC-16/CCITT sobre
+        tipo, tamanho, sequência e payload) e histograma de
+        latência de inserção. Decodificador em tools/.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "formato.h"
+#include "telemetria.h"
+
+static uint32_t faixas[TELEMETRIA_FAIXAS];
+static uint16_t sequencia = 0;
+static uint32_t bytes_emitidos = 0;
+
+static uint16_t crc16(const uint8_t *dados, int n)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (int i = 0; i < n; i++)
+    {
+        crc ^= (uint16_t) dados[i] << 8;
+
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+void telemetria_latencia(uint32_t us)
+{
+    int faixa = 0;
+
+    while (us > 1 && faixa < TELEMETRIA_FAIXAS - 1)
+    {
+        us >>= 1;
+        faixa++;
+    }
+
+    __atomic_fetch_add(&faixas[faixa], 1, __ATOMIC_RELAXED);
+}
+
+void telemetria_histograma_coleta(telemetria_histograma_t *h)
+{
+    for (int i = 0; i < TELEMETRIA_FAIXAS; i++)
+    {
+        uint32_t n = __atomic_exchange_n(&faixas[i], 0, __ATOMIC_RELAXED);
+
+        h->faixas[i] = n > 0xFFFF ? 0xFFFF : n;
+    }
+}
+
+int telemetria_envia(uint8_t tipo, const void *payload, uint8_t tamanho)
+{
+    uint8_t quadro[TELEMETRIA_CABECALHO + TELEMETRIA_MAX_PAYLOAD + 2];
+    int n;
+    uint16_t crc;
+
+    if (tamanho > TELEMETRIA_MAX_PAYLOAD)
+    {
+        return 0;
+    }
+
+    quadro[0] = TELEMETRIA_SINC_0;
+    quadro[1] = TELEMETRIA_SINC_1;
+    quadro[2] = tipo;
+    quadro[3] = tamanho;
+    quadro[4] = sequencia & 0xFF;
+    quadro[5] = sequencia >> 8;
+    memcpy(&quadro[TELEMETRIA_CABECALHO], payload, tamanho);
+
+    n = TELEMETRIA_CABECALHO + tamanho;
+    crc = crc16(&quadro[2], n - 2);
+    quadro[n++] = crc & 0xFF;
+    quadro[n++] = crc >> 8;
+
+    sequencia++;
+
+    // quadro inteiro ou nada: com a UART cheia o quadro é descartado e a
+    // lacuna na sequência aparece no decodificador
+    n = formato_escreve((const char *) quadro, n);
+    if (n > 0)
+    {
+        bytes_emitidos += n;
+    }
+
+    return n;
+}
+
+uint32_t telemetria_bytes(void)
+{
+    return bytes_emitidos;
+}
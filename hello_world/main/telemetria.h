@@ -0,0 +1,96 @@
+/*
+Arquivo: telemetria.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Canal binário opcional de telemetria pela UART do console:
+        quadros de tamanho fixo por tipo, com sequência e CRC.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef TELEMETRIA_H
+#define TELEMETRIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// 1 = emite os quadros binários a cada lote
+#define TELEMETRIA_HABILITADA 0
+
+// bytes de sincronismo no início de cada quadro
+#define TELEMETRIA_SINC_0 0xA5
+#define TELEMETRIA_SINC_1 0x5A
+
+// faixas do histograma de latência: [2^i, 2^(i+1)) us
+#define TELEMETRIA_FAIXAS 16
+
+// tipos de quadro
+#define TELEMETRIA_LOTE 1
+#define TELEMETRIA_ESTEIRA 2
+#define TELEMETRIA_HISTOGRAMA 3
+#define TELEMETRIA_PESOS 4          // único de tamanho variável
+
+// cabeçalho: sinc(2) tipo(1) tamanho(1) sequência(2); depois payload e CRC(2)
+#define TELEMETRIA_CABECALHO 6
+#define TELEMETRIA_MAX_PAYLOAD 64
+
+// todos os campos em little-endian, sem preenchimento
+typedef struct __attribute__((packed))
+{
+    uint32_t numero;
+    uint32_t tempo_ms;              // desde a partida
+    float peso_total;
+    uint32_t reducao_us;
+    uint32_t preenchimento_us;
+    uint16_t num_produtos;
+} telemetria_lote_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t esteira;
+    uint32_t contagem;
+    float massa;
+    float taxa;                     // produtos/s (EWMA)
+    uint32_t latencia_max_us;
+
+    // pesos da esteira no lote (estatistica.h)
+    uint16_t produtos_lote;
+    float media;
+    float desvio;
+    float min;
+    float max;
+} telemetria_esteira_t;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t faixas[TELEMETRIA_FAIXAS];   // satura em 65535
+} telemetria_histograma_t;
+
+// pedaço do vetor de pesos comprimido (compressao.h) de um lote
+#define TELEMETRIA_PESOS_CABECALHO 8
+#define TELEMETRIA_PESOS_PEDACO (TELEMETRIA_MAX_PAYLOAD - TELEMETRIA_PESOS_CABECALHO)
+
+typedef struct __attribute__((packed))
+{
+    uint32_t lote;
+    uint16_t deslocamento;          // posição do pedaço no fluxo
+    uint16_t total;                 // bytes do fluxo inteiro
+    uint8_t dados[TELEMETRIA_PESOS_PEDACO];
+} telemetria_pesos_t;
+
+// conta uma latência de inserção no histograma (seguro entre cores)
+void telemetria_latencia(uint32_t us);
+
+// copia o histograma para o quadro e zera as faixas
+void telemetria_histograma_coleta(telemetria_histograma_t *h);
+
+// monta e escreve um quadro; retorna bytes emitidos
+int telemetria_envia(uint8_t tipo, const void *payload, uint8_t tamanho);
+
+// bytes emitidos desde a partida
+uint32_t telemetria_bytes(void);
+
+#endif
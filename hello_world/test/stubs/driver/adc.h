@@ -0,0 +1,37 @@
+/*
+Arquivo: adc.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Canais e atenuação do ADC do ESP-IDF, para o I2S no modo ADC.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ADC_H
+#define STUB_ADC_H
+
+#include "esp_err.h"
+
+typedef enum
+{
+    ADC_UNIT_1 = 1,
+    ADC_UNIT_2 = 2,
+} adc_unit_t;
+
+typedef enum
+{
+    ADC1_CHANNEL_0 = 0,
+} adc1_channel_t;
+
+typedef enum
+{
+    ADC_ATTEN_DB_0 = 0,
+    ADC_ATTEN_DB_11 = 3,
+} adc_atten_t;
+
+esp_err_t adc1_config_channel_atten(adc1_channel_t canal, adc_atten_t atenuacao);
+
+#endif
@@ -0,0 +1,76 @@
+/*
+Arquivo: i2s.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Driver do I2S do ESP-IDF no modo ADC; o teste que lê o ADC
+        traz o seu DMA falso.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_I2S_H
+#define STUB_I2S_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/adc.h"
+
+typedef enum
+{
+    I2S_NUM_0,
+    I2S_NUM_1,
+} i2s_port_t;
+
+typedef enum
+{
+    I2S_MODE_MASTER = 1,
+    I2S_MODE_SLAVE = 2,
+    I2S_MODE_TX = 4,
+    I2S_MODE_RX = 8,
+    I2S_MODE_DAC_BUILT_IN = 16,
+    I2S_MODE_ADC_BUILT_IN = 32,
+} i2s_mode_t;
+
+typedef enum
+{
+    I2S_BITS_PER_SAMPLE_16BIT = 16,
+} i2s_bits_per_sample_t;
+
+typedef enum
+{
+    I2S_CHANNEL_FMT_ONLY_RIGHT = 3,
+} i2s_channel_fmt_t;
+
+typedef enum
+{
+    I2S_COMM_FORMAT_I2S_MSB = 2,
+} i2s_comm_format_t;
+
+typedef struct
+{
+    i2s_mode_t mode;
+    int sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+} i2s_config_t;
+
+esp_err_t i2s_driver_install(i2s_port_t porta, const i2s_config_t *config, int fila_tamanho,
+                             void *fila);
+esp_err_t i2s_driver_uninstall(i2s_port_t porta);
+esp_err_t i2s_set_adc_mode(adc_unit_t unidade, adc1_channel_t canal);
+esp_err_t i2s_adc_enable(i2s_port_t porta);
+esp_err_t i2s_adc_disable(i2s_port_t porta);
+esp_err_t i2s_read(i2s_port_t porta, void *destino, size_t tamanho, size_t *lidos,
+                   TickType_t espera);
+
+#endif
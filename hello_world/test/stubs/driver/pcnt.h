@@ -0,0 +1,75 @@
+/*
+Arquivo: pcnt.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Driver do contador de pulsos (PCNT) do ESP-IDF; o teste do
+        contador traz o seu PCNT simulado.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_PCNT_H
+#define STUB_PCNT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define PCNT_PIN_NOT_USED (-1)
+
+typedef int pcnt_unit_t;
+
+typedef enum
+{
+    PCNT_CHANNEL_0,
+    PCNT_CHANNEL_1,
+} pcnt_channel_t;
+
+typedef enum
+{
+    PCNT_COUNT_DIS,
+    PCNT_COUNT_INC,
+    PCNT_COUNT_DEC,
+} pcnt_count_mode_t;
+
+typedef enum
+{
+    PCNT_MODE_KEEP,
+    PCNT_MODE_REVERSE,
+    PCNT_MODE_DISABLE,
+} pcnt_ctrl_mode_t;
+
+typedef enum
+{
+    PCNT_EVT_L_LIM = 0,
+    PCNT_EVT_H_LIM = 1,
+} pcnt_evt_type_t;
+
+typedef struct
+{
+    int pulse_gpio_num;
+    int ctrl_gpio_num;
+    pcnt_ctrl_mode_t lctrl_mode;
+    pcnt_ctrl_mode_t hctrl_mode;
+    pcnt_count_mode_t pos_mode;
+    pcnt_count_mode_t neg_mode;
+    int16_t counter_h_lim;
+    int16_t counter_l_lim;
+    pcnt_unit_t unit;
+    pcnt_channel_t channel;
+} pcnt_config_t;
+
+esp_err_t pcnt_unit_config(const pcnt_config_t *config);
+esp_err_t pcnt_set_filter_value(pcnt_unit_t unidade, uint16_t valor);
+esp_err_t pcnt_filter_enable(pcnt_unit_t unidade);
+esp_err_t pcnt_event_enable(pcnt_unit_t unidade, pcnt_evt_type_t evento);
+esp_err_t pcnt_isr_service_install(int flags);
+esp_err_t pcnt_isr_handler_add(pcnt_unit_t unidade, void (*isr)(void *), void *arg);
+esp_err_t pcnt_counter_pause(pcnt_unit_t unidade);
+esp_err_t pcnt_counter_clear(pcnt_unit_t unidade);
+esp_err_t pcnt_counter_resume(pcnt_unit_t unidade);
+esp_err_t pcnt_get_counter_value(pcnt_unit_t unidade, int16_t *valor);
+
+#endif
@@ -0,0 +1,86 @@
+/*
+Arquivo: timer.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Driver dos timers de hardware do ESP-IDF; o teste da rejeição
+        traz os timers falsos, que chamam as ISRs registradas.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_TIMER_H
+#define STUB_TIMER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_intr_alloc.h"
+
+typedef enum
+{
+    TIMER_GROUP_0,
+    TIMER_GROUP_1,
+} timer_group_t;
+
+typedef enum
+{
+    TIMER_0,
+    TIMER_1,
+} timer_idx_t;
+
+typedef enum
+{
+    TIMER_PAUSE,
+    TIMER_START,
+} timer_start_t;
+
+typedef enum
+{
+    TIMER_ALARM_DIS,
+    TIMER_ALARM_EN,
+} timer_alarm_t;
+
+typedef enum
+{
+    TIMER_INTR_LEVEL,
+} timer_intr_mode_t;
+
+typedef enum
+{
+    TIMER_COUNT_DOWN,
+    TIMER_COUNT_UP,
+} timer_count_dir_t;
+
+typedef enum
+{
+    TIMER_AUTORELOAD_DIS,
+    TIMER_AUTORELOAD_EN,
+} timer_autoreload_t;
+
+typedef struct
+{
+    timer_alarm_t alarm_en;
+    timer_start_t counter_en;
+    timer_intr_mode_t intr_type;
+    timer_count_dir_t counter_dir;
+    timer_autoreload_t auto_reload;
+    uint32_t divider;
+} timer_config_t;
+
+typedef intr_handle_t timer_isr_handle_t;
+
+esp_err_t timer_init(timer_group_t grupo, timer_idx_t indice, const timer_config_t *config);
+esp_err_t timer_set_counter_value(timer_group_t grupo, timer_idx_t indice, uint64_t valor);
+esp_err_t timer_set_alarm_value(timer_group_t grupo, timer_idx_t indice, uint64_t valor);
+esp_err_t timer_enable_intr(timer_group_t grupo, timer_idx_t indice);
+esp_err_t timer_isr_register(timer_group_t grupo, timer_idx_t indice, void (*isr)(void *), void *arg,
+                             int flags, timer_isr_handle_t *handle);
+esp_err_t timer_start(timer_group_t grupo, timer_idx_t indice);
+esp_err_t timer_pause(timer_group_t grupo, timer_idx_t indice);
+void timer_group_clr_intr_status_in_isr(timer_group_t grupo, timer_idx_t indice);
+void timer_group_enable_alarm_in_isr(timer_group_t grupo, timer_idx_t indice);
+uint64_t timer_group_get_counter_value_in_isr(timer_group_t grupo, timer_idx_t indice);
+
+#endif
@@ -0,0 +1,25 @@
+/*
+Arquivo: uart.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Driver da UART do ESP-IDF; cada teste que escreve no console
+        traz a sua UART falsa.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_UART_H
+#define STUB_UART_H
+
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef int uart_port_t;
+
+esp_err_t uart_driver_install(uart_port_t porta, int rx, int tx, int fila, void *handle, int flags);
+int uart_write_bytes(uart_port_t porta, const char *dados, size_t n);
+
+#endif
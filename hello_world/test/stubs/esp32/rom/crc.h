@@ -0,0 +1,20 @@
+/*
+Arquivo: crc.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        CRC-32 da ROM do ESP32; no host, em hospedeiro.c.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ROM_CRC_H
+#define STUB_ROM_CRC_H
+
+#include <stdint.h>
+
+uint32_t crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
+
+#endif
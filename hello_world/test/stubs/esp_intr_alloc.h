@@ -0,0 +1,24 @@
+/*
+Arquivo: esp_intr_alloc.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Alocação de interrupções do ESP-IDF, só o que os timers usam.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_INTR_ALLOC_H
+#define STUB_ESP_INTR_ALLOC_H
+
+#include "esp_err.h"
+
+#define ESP_INTR_FLAG_IRAM (1 << 10)
+
+typedef void *intr_handle_t;
+
+esp_err_t esp_intr_free(intr_handle_t handle);
+
+#endif
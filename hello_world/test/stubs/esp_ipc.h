@@ -0,0 +1,21 @@
+/*
+Arquivo: esp_ipc.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Chamada em outro core: no host troca o core simulado, chama
+        e volta (hospedeiro.c).
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_IPC_H
+#define STUB_ESP_IPC_H
+
+#include "esp_err.h"
+
+esp_err_t esp_ipc_call_blocking(int core, void (*funcao)(void *), void *arg);
+
+#endif
@@ -0,0 +1,48 @@
+/*
+Arquivo: esp_partition.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        API de partições do ESP-IDF; o teste que usa a flash traz a
+        sua partição falsa em RAM.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_PARTITION_H
+#define STUB_ESP_PARTITION_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_spi_flash.h"
+
+typedef enum
+{
+    ESP_PARTITION_TYPE_APP = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef int esp_partition_subtype_t;
+
+typedef struct
+{
+    esp_partition_type_t type;
+    esp_partition_subtype_t subtype;
+    uint32_t address;
+    uint32_t size;
+    char label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t tipo,
+                                                esp_partition_subtype_t subtipo, const char *rotulo);
+esp_err_t esp_partition_mmap(const esp_partition_t *particao, size_t inicio, size_t tamanho,
+                             spi_flash_mmap_memory_t memoria, const void **ponteiro,
+                             spi_flash_mmap_handle_t *handle);
+esp_err_t esp_partition_erase_range(const esp_partition_t *particao, size_t inicio, size_t tamanho);
+esp_err_t esp_partition_write(const esp_partition_t *particao, size_t destino, const void *origem,
+                              size_t tamanho);
+
+#endif
@@ -0,0 +1,31 @@
+/*
+Arquivo: esp_spi_flash.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Tamanho de setor e mapeamento da flash do ESP-IDF.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_SPI_FLASH_H
+#define STUB_ESP_SPI_FLASH_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+typedef uint32_t spi_flash_mmap_handle_t;
+
+typedef enum
+{
+    SPI_FLASH_MMAP_DATA,
+    SPI_FLASH_MMAP_INST,
+} spi_flash_mmap_memory_t;
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle);
+
+#endif
@@ -0,0 +1,38 @@
+/*
+Arquivo: esp_system.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Motivo do reset e reinício do ESP-IDF. No host o motivo é o
+        que o teste escolheu e reiniciar encerra o processo.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_SYSTEM_H
+#define STUB_ESP_SYSTEM_H
+
+typedef enum
+{
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO,
+} esp_reset_reason_t;
+
+esp_reset_reason_t esp_reset_reason(void);
+void esp_restart(void);
+
+// só no host: motivo que esp_reset_reason devolve daqui em diante
+void hospedeiro_reset(esp_reset_reason_t motivo);
+
+#endif
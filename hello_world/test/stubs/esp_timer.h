@@ -0,0 +1,49 @@
+/*
+Arquivo: esp_timer.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Relógio em microssegundos do esp_timer. No host ele é o relógio
+        monotônico, ou um relógio simulado que o teste avança.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_TIMER_H
+#define STUB_ESP_TIMER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef void *esp_timer_handle_t;
+
+typedef enum
+{
+    ESP_TIMER_TASK,
+} esp_timer_dispatch_t;
+
+typedef struct
+{
+    void (*callback)(void *arg);
+    void *arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *name;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time(void);
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *timer);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+// só no host: a partir daqui esp_timer_get_time devolve us (relógio simulado)
+void hospedeiro_relogio(int64_t us);
+
+// só no host: volta ao relógio monotônico
+void hospedeiro_relogio_real(void);
+
+#endif
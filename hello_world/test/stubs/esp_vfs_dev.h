@@ -0,0 +1,20 @@
+/*
+Arquivo: esp_vfs_dev.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Console pelo driver da UART; não faz nada no host.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_ESP_VFS_DEV_H
+#define STUB_ESP_VFS_DEV_H
+
+static inline void esp_vfs_dev_uart_use_driver(int porta)
+{
+}
+
+#endif
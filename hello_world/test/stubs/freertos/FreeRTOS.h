@@ -0,0 +1,63 @@
+/*
+Arquivo: FreeRTOS.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Tipos e macros do FreeRTOS do ESP-IDF que os módulos de main/
+        usam, para compilar os testes no host. As seções críticas
+        viram mutexes de pthread, então continuam exclusivas de verdade.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_FREERTOS_H
+#define STUB_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "esp_attr.h"
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define portMAX_DELAY 0xffffffffu
+#define portTICK_RATE_MS 10
+#define portTICK_PERIOD_MS 10
+#define pdMS_TO_TICKS(x) ((x) / 10)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portNUM_PROCESSORS 2
+#define configMAX_PRIORITIES 25
+#define configTICK_RATE_HZ 100
+#define PRO_CPU_NUM 0
+#define APP_CPU_NUM 1
+#define tskNO_AFFINITY 0x7fffffff
+
+// sdkconfig do projeto
+#define CONFIG_ESP_CONSOLE_UART_NUM 0
+#define CONFIG_ESP_CONSOLE_UART_BAUDRATE 115200
+#define CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ 160
+
+typedef pthread_mutex_t portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED PTHREAD_MUTEX_INITIALIZER
+#define portENTER_CRITICAL(m) pthread_mutex_lock(m)
+#define portEXIT_CRITICAL(m) pthread_mutex_unlock(m)
+#define portENTER_CRITICAL_ISR(m) pthread_mutex_lock(m)
+#define portEXIT_CRITICAL_ISR(m) pthread_mutex_unlock(m)
+#define vPortCPUInitializeMutex(m) pthread_mutex_init((m), NULL)
+#define portYIELD_FROM_ISR() do {} while (0)
+
+int xPortGetCoreID(void);
+
+// só no host: core que xPortGetCoreID devolve daqui em diante na thread
+// que chama (as tarefas fixadas num core já partem nele)
+void hospedeiro_core(int core);
+
+#endif
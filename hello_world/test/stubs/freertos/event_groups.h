@@ -0,0 +1,30 @@
+/*
+Arquivo: event_groups.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Grupos de eventos do FreeRTOS implementados em hospedeiro.c.
+        Esperar uma máscara vazia para no assert, como no ESP32.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_EVENT_GROUPS_H
+#define STUB_EVENT_GROUPS_H
+
+#include "FreeRTOS.h"
+
+typedef uint32_t EventBits_t;
+typedef struct grupo_hospedeiro *EventGroupHandle_t;
+
+EventGroupHandle_t xEventGroupCreate(void);
+void vEventGroupDelete(EventGroupHandle_t grupo);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t grupo, EventBits_t bits);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t grupo, EventBits_t bits);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t grupo);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t grupo, EventBits_t bits, BaseType_t limpa,
+                                BaseType_t todos, TickType_t espera);
+
+#endif
@@ -0,0 +1,30 @@
+/*
+Arquivo: queue.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Filas do FreeRTOS implementadas em hospedeiro.c com mutex e
+        variável de condição de pthread, com a mesma espera em ticks.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_QUEUE_H
+#define STUB_QUEUE_H
+
+#include "FreeRTOS.h"
+
+#define errQUEUE_FULL 0
+#define errQUEUE_EMPTY 0
+
+typedef struct fila_hospedeiro *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t tamanho, UBaseType_t item);
+void vQueueDelete(QueueHandle_t fila);
+BaseType_t xQueueSend(QueueHandle_t fila, const void *item, TickType_t espera);
+BaseType_t xQueueReceive(QueueHandle_t fila, void *item, TickType_t espera);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t fila);
+
+#endif
@@ -0,0 +1,28 @@
+/*
+Arquivo: semphr.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Semáforos e mutexes do FreeRTOS implementados em hospedeiro.c
+        como contadores sob a trava global, com a mesma espera em ticks.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_SEMPHR_H
+#define STUB_SEMPHR_H
+
+#include "FreeRTOS.h"
+
+typedef struct semaforo_hospedeiro *SemaphoreHandle_t;
+
+// mutex começa livre; o binário, vazio (sem herança de prioridade no host)
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+void vSemaphoreDelete(SemaphoreHandle_t semaforo);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaforo);
+
+#endif
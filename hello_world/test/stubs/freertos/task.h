@@ -0,0 +1,44 @@
+/*
+Arquivo: task.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Declarações das tarefas do FreeRTOS; em hospedeiro.c cada
+        tarefa é uma thread de pthread e as esperas bloqueiam de verdade.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_TASK_H
+#define STUB_TASK_H
+
+#include "FreeRTOS.h"
+
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define tskIDLE_PRIORITY 0
+
+BaseType_t xTaskCreate(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *parametro,
+                       UBaseType_t prioridade, TaskHandle_t *tarefa);
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha,
+                                   void *parametro, UBaseType_t prioridade, TaskHandle_t *tarefa,
+                                   BaseType_t core);
+void vTaskDelete(TaskHandle_t tarefa);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *acordar, TickType_t periodo);
+TickType_t xTaskGetTickCount(void);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t tarefa);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t tarefa);
+uint32_t ulTaskNotifyTake(BaseType_t zera, TickType_t espera);
+BaseType_t xTaskNotifyGive(TaskHandle_t tarefa);
+void vTaskNotifyGiveFromISR(TaskHandle_t tarefa, BaseType_t *acordou);
+
+// só no host: tarefa que xTaskGetCurrentTaskHandle e ulTaskNotifyTake
+// enxergam na thread que chama (as criadas por xTaskCreate já têm a sua)
+void hospedeiro_tarefa(TaskHandle_t tarefa);
+
+#endif
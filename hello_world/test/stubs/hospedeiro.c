@@ -0,0 +1,625 @@
+/*
+Arquivo: hospedeiro.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Implementações no host das poucas funções do ESP-IDF que os
+        módulos testados chamam: relógio, núcleo atual e IPC, timers que
+        nunca disparam, tarefas em threads de pthread com notificações
+        diretas, filas, semáforos e grupos de eventos que bloqueiam de
+        verdade, o CRC da ROM e o motivo do reset.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_ipc.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp32/rom/crc.h"
+
+static bool simulado = false;
+static int64_t agora_simulado;
+
+int64_t esp_timer_get_time(void)
+{
+    struct timespec t;
+
+    if (simulado)
+    {
+        return agora_simulado;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return (int64_t) t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+void hospedeiro_relogio(int64_t us)
+{
+    simulado = true;
+    agora_simulado = us;
+}
+
+void hospedeiro_relogio_real(void)
+{
+    simulado = false;
+}
+
+static __thread int core_atual = 0;
+
+int xPortGetCoreID(void)
+{
+    return core_atual;
+}
+
+void hospedeiro_core(int core)
+{
+    core_atual = core;
+}
+
+// roda no core pedido e volta
+esp_err_t esp_ipc_call_blocking(int core, void (*funcao)(void *), void *arg)
+{
+    int anterior = core_atual;
+
+    core_atual = core;
+    funcao(arg);
+    core_atual = anterior;
+
+    return ESP_OK;
+}
+
+// timers do esp_timer: aceitos e ignorados
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *timer)
+{
+    *timer = (esp_timer_handle_t) args;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t us)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t us)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    return ESP_OK;
+}
+
+// tarefas e objetos de sincronização: um mutex e uma condição globais
+// guardam todos; qualquer mudança acorda todo mundo, que confere a sua
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t mudou = PTHREAD_COND_INITIALIZER;
+
+// prazo absoluto (no relógio da condição) de uma espera em ticks
+static struct timespec prazo(TickType_t espera)
+{
+    struct timespec t;
+    int64_t ns;
+
+    clock_gettime(CLOCK_REALTIME, &t);
+    ns = t.tv_nsec + (int64_t) espera * portTICK_PERIOD_MS * 1000000;
+    t.tv_sec += ns / 1000000000;
+    t.tv_nsec = ns % 1000000000;
+
+    return t;
+}
+
+// com a trava: espera alguém mudar algo; false se o prazo venceu
+static bool aguarda(TickType_t espera, const struct timespec *limite)
+{
+    if (espera == 0)
+    {
+        return false;
+    }
+
+    if (espera == portMAX_DELAY)
+    {
+        pthread_cond_wait(&mudou, &trava);
+        return true;
+    }
+
+    return pthread_cond_timedwait(&mudou, &trava, limite) == 0;
+}
+
+typedef struct
+{
+    TaskFunction_t funcao;
+    void *parametro;
+    int core;
+} tarefa_hospedeiro_t;
+
+static __thread TaskHandle_t tarefa_atual = NULL;
+
+static void *executa_tarefa(void *arg)
+{
+    tarefa_hospedeiro_t *t = (tarefa_hospedeiro_t *) arg;
+
+    tarefa_atual = t;
+    core_atual = t->core;
+    t->funcao(t->parametro);
+
+    return NULL;
+}
+
+// cada tarefa é uma thread destacada; a prioridade não é imitada
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t funcao, const char *nome, uint32_t pilha,
+                                   void *parametro, UBaseType_t prioridade, TaskHandle_t *tarefa,
+                                   BaseType_t core)
+{
+    tarefa_hospedeiro_t *t = malloc(sizeof(tarefa_hospedeiro_t));
+    pthread_t thread;
+
+    if (tarefa != NULL)
+    {
+        *tarefa = NULL;
+    }
+    if (t == NULL)
+    {
+        return pdFAIL;
+    }
+
+    t->funcao = funcao;
+    t->parametro = parametro;
+    t->core = core == tskNO_AFFINITY ? 0 : core;
+
+    // o handle já vale quando a tarefa começa a rodar
+    if (tarefa != NULL)
+    {
+        *tarefa = t;
+    }
+
+    if (pthread_create(&thread, NULL, executa_tarefa, t) != 0)
+    {
+        if (tarefa != NULL)
+        {
+            *tarefa = NULL;
+        }
+        free(t);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t funcao, const char *nome, uint32_t pilha, void *parametro,
+                       UBaseType_t prioridade, TaskHandle_t *tarefa)
+{
+    return xTaskCreatePinnedToCore(funcao, nome, pilha, parametro, prioridade, tarefa,
+                                   tskNO_AFFINITY);
+}
+
+// só a própria tarefa se apaga de verdade; as outras seguem até o fim do
+// teste (nenhum teste apaga uma tarefa que ainda vá mexer no estado dele)
+void vTaskDelete(TaskHandle_t tarefa)
+{
+    if (tarefa == NULL || tarefa == tarefa_atual)
+    {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec t = {ticks * portTICK_PERIOD_MS / 1000, ticks * portTICK_PERIOD_MS % 1000 * 1000000};
+
+    nanosleep(&t, NULL);
+}
+
+void vTaskDelayUntil(TickType_t *acordar, TickType_t periodo)
+{
+    *acordar += periodo;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t) (esp_timer_get_time() / 1000 / portTICK_PERIOD_MS);
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t tarefa)
+{
+    return 1;
+}
+
+// notificações diretas: uma contagem por tarefa, criada no primeiro uso
+#define NOTIFICADAS 128
+
+static struct
+{
+    TaskHandle_t tarefa;
+    uint32_t valor;
+} notificacoes[NOTIFICADAS];
+
+static int notificadas = 0;
+
+// com a trava
+static uint32_t *notificacao(TaskHandle_t tarefa)
+{
+    for (int i = 0; i < notificadas; i++)
+    {
+        if (notificacoes[i].tarefa == tarefa)
+        {
+            return &notificacoes[i].valor;
+        }
+    }
+
+    if (notificadas == NOTIFICADAS)
+    {
+        abort();
+    }
+    notificacoes[notificadas].tarefa = tarefa;
+
+    return &notificacoes[notificadas++].valor;
+}
+
+void hospedeiro_tarefa(TaskHandle_t tarefa)
+{
+    tarefa_atual = tarefa;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return tarefa_atual;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t tarefa)
+{
+    return 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t zera, TickType_t espera)
+{
+    struct timespec limite = prazo(espera);
+    uint32_t *valor, anterior;
+
+    pthread_mutex_lock(&trava);
+
+    valor = notificacao(tarefa_atual);
+    while (*valor == 0 && aguarda(espera, &limite))
+    {
+    }
+
+    anterior = *valor;
+    if (zera)
+    {
+        *valor = 0;
+    } else if (anterior > 0)
+    {
+        (*valor)--;
+    }
+
+    pthread_mutex_unlock(&trava);
+
+    return anterior;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t tarefa)
+{
+    pthread_mutex_lock(&trava);
+    (*notificacao(tarefa))++;
+    pthread_cond_broadcast(&mudou);
+    pthread_mutex_unlock(&trava);
+
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t tarefa, BaseType_t *acordou)
+{
+    xTaskNotifyGive(tarefa);
+    if (acordou != NULL)
+    {
+        *acordou = pdTRUE;
+    }
+}
+
+// filas: anel de itens copiados, como no FreeRTOS
+struct fila_hospedeiro
+{
+    UBaseType_t tamanho;
+    UBaseType_t item;
+    UBaseType_t inicio;
+    UBaseType_t ocupados;
+    uint8_t dados[];
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t tamanho, UBaseType_t item)
+{
+    QueueHandle_t fila = malloc(sizeof(struct fila_hospedeiro) + (size_t) tamanho * item);
+
+    if (fila != NULL)
+    {
+        fila->tamanho = tamanho;
+        fila->item = item;
+        fila->inicio = 0;
+        fila->ocupados = 0;
+    }
+
+    return fila;
+}
+
+void vQueueDelete(QueueHandle_t fila)
+{
+    free(fila);
+}
+
+BaseType_t xQueueSend(QueueHandle_t fila, const void *item, TickType_t espera)
+{
+    struct timespec limite = prazo(espera);
+    BaseType_t enviou = pdFALSE;
+
+    pthread_mutex_lock(&trava);
+
+    while (fila->ocupados == fila->tamanho && aguarda(espera, &limite))
+    {
+    }
+
+    if (fila->ocupados < fila->tamanho)
+    {
+        UBaseType_t fim = (fila->inicio + fila->ocupados) % fila->tamanho;
+
+        memcpy(&fila->dados[fim * fila->item], item, fila->item);
+        fila->ocupados++;
+        pthread_cond_broadcast(&mudou);
+        enviou = pdTRUE;
+    }
+
+    pthread_mutex_unlock(&trava);
+
+    return enviou;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t fila, void *item, TickType_t espera)
+{
+    struct timespec limite = prazo(espera);
+    BaseType_t recebeu = pdFALSE;
+
+    pthread_mutex_lock(&trava);
+
+    while (fila->ocupados == 0 && aguarda(espera, &limite))
+    {
+    }
+
+    if (fila->ocupados > 0)
+    {
+        memcpy(item, &fila->dados[fila->inicio * fila->item], fila->item);
+        fila->inicio = (fila->inicio + 1) % fila->tamanho;
+        fila->ocupados--;
+        pthread_cond_broadcast(&mudou);
+        recebeu = pdTRUE;
+    }
+
+    pthread_mutex_unlock(&trava);
+
+    return recebeu;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t fila)
+{
+    UBaseType_t n;
+
+    pthread_mutex_lock(&trava);
+    n = fila->ocupados;
+    pthread_mutex_unlock(&trava);
+
+    return n;
+}
+
+// semáforos: contagem até o máximo; o mutex é um binário que começa cheio
+struct semaforo_hospedeiro
+{
+    UBaseType_t contagem;
+    UBaseType_t maximo;
+};
+
+static SemaphoreHandle_t cria_semaforo(UBaseType_t contagem, UBaseType_t maximo)
+{
+    SemaphoreHandle_t s = malloc(sizeof(struct semaforo_hospedeiro));
+
+    if (s != NULL)
+    {
+        s->contagem = contagem;
+        s->maximo = maximo;
+    }
+
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return cria_semaforo(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return cria_semaforo(0, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaforo)
+{
+    free(semaforo);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera)
+{
+    struct timespec limite = prazo(espera);
+    BaseType_t tomou = pdFALSE;
+
+    pthread_mutex_lock(&trava);
+
+    while (semaforo->contagem == 0 && aguarda(espera, &limite))
+    {
+    }
+
+    if (semaforo->contagem > 0)
+    {
+        semaforo->contagem--;
+        tomou = pdTRUE;
+    }
+
+    pthread_mutex_unlock(&trava);
+
+    return tomou;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaforo)
+{
+    BaseType_t deu = pdFALSE;
+
+    pthread_mutex_lock(&trava);
+
+    if (semaforo->contagem < semaforo->maximo)
+    {
+        semaforo->contagem++;
+        pthread_cond_broadcast(&mudou);
+        deu = pdTRUE;
+    }
+
+    pthread_mutex_unlock(&trava);
+
+    return deu;
+}
+
+// grupos de eventos
+struct grupo_hospedeiro
+{
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    EventGroupHandle_t grupo = malloc(sizeof(struct grupo_hospedeiro));
+
+    if (grupo != NULL)
+    {
+        grupo->bits = 0;
+    }
+
+    return grupo;
+}
+
+void vEventGroupDelete(EventGroupHandle_t grupo)
+{
+    free(grupo);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t grupo, EventBits_t bits)
+{
+    EventBits_t atuais;
+
+    pthread_mutex_lock(&trava);
+    grupo->bits |= bits;
+    atuais = grupo->bits;
+    pthread_cond_broadcast(&mudou);
+    pthread_mutex_unlock(&trava);
+
+    return atuais;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t grupo, EventBits_t bits)
+{
+    EventBits_t anteriores;
+
+    pthread_mutex_lock(&trava);
+    anteriores = grupo->bits;
+    grupo->bits &= ~bits;
+    pthread_mutex_unlock(&trava);
+
+    return anteriores;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t grupo)
+{
+    return xEventGroupClearBits(grupo, 0);
+}
+
+static bool bits_chegaram(EventBits_t atuais, EventBits_t bits, BaseType_t todos)
+{
+    return todos ? (atuais & bits) == bits : (atuais & bits) != 0;
+}
+
+// devolve os bits de quando a espera terminou, antes de limpar
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t grupo, EventBits_t bits, BaseType_t limpa,
+                                BaseType_t todos, TickType_t espera)
+{
+    struct timespec limite = prazo(espera);
+    EventBits_t atuais;
+
+    // configASSERT(bits != 0) do FreeRTOS
+    if (bits == 0)
+    {
+        abort();
+    }
+
+    pthread_mutex_lock(&trava);
+
+    while (!bits_chegaram(grupo->bits, bits, todos) && aguarda(espera, &limite))
+    {
+    }
+
+    atuais = grupo->bits;
+    if (limpa && bits_chegaram(atuais, bits, todos))
+    {
+        grupo->bits &= ~bits;
+    }
+
+    pthread_mutex_unlock(&trava);
+
+    return atuais;
+}
+
+// CRC-32 refletido (0xEDB88320), como o crc32_le da ROM: com crc = 0 dá o
+// CRC-32 usual, e o resultado de um trecho serve de crc para o seguinte
+uint32_t crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+
+    return ~crc;
+}
+
+static esp_reset_reason_t motivo_reset = ESP_RST_POWERON;
+
+esp_reset_reason_t esp_reset_reason(void)
+{
+    return motivo_reset;
+}
+
+void hospedeiro_reset(esp_reset_reason_t motivo)
+{
+    motivo_reset = motivo;
+}
+
+// nenhum teste reinicia de verdade: chegar aqui é falha
+void esp_restart(void)
+{
+    abort();
+}
@@ -0,0 +1,39 @@
+/*
+Arquivo: nvs.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        API da NVS do ESP-IDF usada pelo checkpoint; o teste que usa
+        traz a sua NVS falsa em RAM.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_NVS_H
+#define STUB_NVS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#define ESP_ERR_NVS_BASE 0x1100
+#define ESP_ERR_NVS_NOT_FOUND (ESP_ERR_NVS_BASE + 0x02)
+#define ESP_ERR_NVS_INVALID_LENGTH (ESP_ERR_NVS_BASE + 0x0c)
+
+typedef uint32_t nvs_handle_t;
+
+typedef enum
+{
+    NVS_READONLY,
+    NVS_READWRITE,
+} nvs_open_mode_t;
+
+esp_err_t nvs_open(const char *nome, nvs_open_mode_t modo, nvs_handle_t *handle);
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *chave, const void *valor, size_t tamanho);
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *chave, void *valor, size_t *tamanho);
+esp_err_t nvs_commit(nvs_handle_t handle);
+void nvs_close(nvs_handle_t handle);
+
+#endif
@@ -0,0 +1,26 @@
+/*
+Arquivo: hal.h (stub do host)
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Contador de ciclos do Xtensa, derivado do relógio em us na
+        frequência do sdkconfig (com a mesma volta de 32 bits).
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef STUB_XTENSA_HAL_H
+#define STUB_XTENSA_HAL_H
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+
+static inline uint32_t xthal_get_ccount(void)
+{
+    return (uint32_t) (esp_timer_get_time() * CONFIG_ESP32_DEFAULT_CPU_FREQ_MHZ);
+}
+
+#endif
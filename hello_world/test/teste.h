@@ -0,0 +1,41 @@
+/*
+Arquivo: teste.h
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Conferências dos testes no host: cada falha é impressa com
+        arquivo e linha, e o teste sai com erro no fim.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#ifndef TESTE_H
+#define TESTE_H
+
+#include <stdio.h>
+
+static int teste_falhas = 0;
+
+#define CONFERE(condicao, ...) \
+    do \
+    { \
+        if (!(condicao)) \
+        { \
+            printf("%s:%d: falhou: %s: ", __FILE__, __LINE__, #condicao); \
+            printf(__VA_ARGS__); \
+            printf("\n"); \
+            teste_falhas++; \
+        } \
+    } while (0)
+
+// fim do main de cada teste
+#define TESTE_FIM() \
+    do \
+    { \
+        printf("%s\n", teste_falhas == 0 ? "ok" : "FALHOU"); \
+        return teste_falhas != 0; \
+    } while (0)
+
+#endif
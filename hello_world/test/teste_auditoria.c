@@ -0,0 +1,240 @@
+/*
+Arquivo: teste_auditoria.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Milhões de produtos pela auditoria de sequências, com a
+        inserção e o pipeline de lotes simulados como em
+        hello_world_main.c: rajadas de uma esteira só, relatório
+        parado com o pool inteiro na fila, reinícios com os lotes não
+        relatados devolvidos pela RTC e sequências dando a volta de
+        32 bits. Sem falhas injetadas a auditoria não pode achar
+        nada; com AUDITORIA_INJETA_FALHAS tem que achar exatamente o
+        que foi injetado. Cada sequência tem que cair em um lote só.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "auditoria.h"
+
+#define PRODUTOS 5000000u
+
+static uint32_t estado_aleatorio = 88172645u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+static esteira_t esteiras[NUM_ESTEIRAS];
+
+// pipeline simulado: o lote em preenchimento e os fechados, em ordem
+static lote_t pool[LOTE_NUM_BUFFERS];
+static int primeiro, fechados;      // fila circular dos fechados no pool
+static int num_produtos;
+static uint32_t num_lotes;
+static uint32_t seq_esperada[NUM_ESTEIRAS];
+
+// o que de fato aconteceu
+static uint32_t inseridos[NUM_ESTEIRAS];   // produtos aceitos na inserção
+static uint32_t relatados[NUM_ESTEIRAS];   // produtos nos lotes relatados
+static uint32_t base[NUM_ESTEIRAS];        // fim das sequências relatadas
+
+// contadores da auditoria somados entre os reinícios
+static auditoria_t total;
+
+static lote_t *atual(void)
+{
+    return &pool[(primeiro + fechados) % LOTE_NUM_BUFFERS];
+}
+
+// como aceita_produto e insere_produto
+static void aceita(int k, uint32_t sequencia)
+{
+    lote_t *lote = atual();
+
+    if ((int32_t) (sequencia - seq_esperada[k]) < 0)
+    {
+        auditoria_rejeita();
+        return;
+    }
+
+    if (num_produtos == 0)
+    {
+        for (int i = 0; i < NUM_ESTEIRAS; i++)
+        {
+            lote->contagem[i] = 0;
+            lote->seq_inicio[i] = seq_esperada[i];
+            lote->seq_fim[i] = seq_esperada[i];
+        }
+    }
+
+    lote->contagem[k]++;
+    lote->seq_fim[k] = sequencia + 1;
+    seq_esperada[k] = sequencia + 1;
+    inseridos[k]++;
+    num_produtos++;
+
+    if (num_produtos >= NUM_MAX_PROD)
+    {
+        lote->num_produtos = num_produtos;
+        lote->numero = num_lotes++;
+        fechados++;
+        num_produtos = 0;
+    }
+}
+
+// estágio de relatório: o lote fechado mais antigo
+static void relata(void)
+{
+    lote_t *lote = &pool[primeiro];
+
+    auditoria_lote(lote);
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        relatados[k] += lote->contagem[k];
+        base[k] = lote->seq_fim[k];
+    }
+
+    primeiro = (primeiro + 1) % LOTE_NUM_BUFFERS;
+    fechados--;
+}
+
+static void soma_contadores(void)
+{
+    total.lotes += auditoria.lotes;
+    total.lacunas += auditoria.lacunas;
+    total.repetidas += auditoria.repetidas;
+    total.rejeitadas += auditoria.rejeitadas;
+    total.injetadas_lacunas += auditoria.injetadas_lacunas;
+    total.injetadas_repetidas += auditoria.injetadas_repetidas;
+}
+
+// reset com a RTC preservada: os lotes fechados e o parcial voltam como
+// estavam, a auditoria recomeça da base relatada
+static void reinicia(void)
+{
+    soma_contadores();
+    auditoria_inicia(base);
+
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        esteiras[k].sequencia = seq_esperada[k];
+    }
+}
+
+int main(void)
+{
+    uint32_t produtos = 0, reinicios = 0, paradas = 0, rajadas = 0;
+    uint32_t relatar = 30;      // chance do relatório por passo, em mil
+    int rajada = -1, resta = 0;
+
+    // sequências a menos de um lote da volta de 32 bits
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        esteiras[k].id = k + 1;
+        esteiras[k].sequencia = 0xFFFFFFFFu - 150 + 41 * k;
+        seq_esperada[k] = base[k] = esteiras[k].sequencia;
+    }
+    auditoria_inicia(base);
+
+    while (produtos < PRODUTOS)
+    {
+        uint32_t r = aleatorio() % 1000;
+
+        // trechos com o relatório em dia ou parado
+        if (r == 0)
+        {
+            relatar = aleatorio() % 3 == 0 ? 0 : 30;
+            paradas += relatar == 0;
+        }
+
+        if (aleatorio() % 20000 == 0)
+        {
+            reinicia();
+            reinicios++;
+        } else if (fechados > 0 && (fechados == LOTE_NUM_BUFFERS - 1 || aleatorio() % 1000 < relatar))
+        {
+            // pool cheio: a esteira espera o relatório liberar um buffer
+            relata();
+        } else if (fechados < LOTE_NUM_BUFFERS - 1)
+        {
+            // sobrecarga: uma esteira manda centenas seguidas
+            if (resta == 0 && aleatorio() % 5000 == 0)
+            {
+                rajada = aleatorio() % NUM_ESTEIRAS;
+                resta = 500 + aleatorio() % 1000;
+                rajadas++;
+            }
+
+            int k = resta > 0 ? rajada : (int) (aleatorio() % NUM_ESTEIRAS);
+
+            resta -= resta > 0;
+            aceita(k, auditoria_sequencia(&esteiras[k]));
+            produtos++;
+        }
+    }
+
+    // o lote parcial fecha do jeito que está e tudo é relatado
+    if (num_produtos > 0)
+    {
+        atual()->num_produtos = num_produtos;
+        atual()->numero = num_lotes++;
+        fechados++;
+    }
+    while (fechados > 0)
+    {
+        relata();
+    }
+    soma_contadores();
+
+    printf("%u produtos em %u lotes, %u reinícios, %u paradas do relatório, %u rajadas\n",
+           produtos, num_lotes, reinicios, paradas, rajadas);
+    printf("lacunas %u (injetadas %u), repetidas %u, rejeitadas %u (injetadas %u)\n",
+           total.lacunas, total.injetadas_lacunas, total.repetidas, total.rejeitadas,
+           total.injetadas_repetidas);
+
+    CONFERE(reinicios > 50 && paradas > 100 && rajadas > 100, "poucos casos exercitados");
+
+    // cada produto aceito num lote relatado, exatamente uma vez
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        CONFERE(relatados[k] == inseridos[k], "esteira %d: %u relatados, %u inseridos", k,
+                relatados[k], inseridos[k]);
+    }
+    CONFERE(total.repetidas == 0, "%u repetidas", total.repetidas);
+    CONFERE(total.lacunas == total.injetadas_lacunas, "%u lacunas, %u injetadas", total.lacunas,
+            total.injetadas_lacunas);
+    CONFERE(total.rejeitadas == total.injetadas_repetidas, "%u rejeitadas, %u injetadas",
+            total.rejeitadas, total.injetadas_repetidas);
+#if AUDITORIA_INJETA_FALHAS
+    CONFERE(total.injetadas_lacunas > 10000 && total.injetadas_repetidas > 10000, "poucas falhas injetadas");
+#endif
+
+    // lote que se perdeu e lote relatado duas vezes: a auditoria acha o tamanho exato
+    {
+        lote_t lote;
+
+        memset(&lote, 0, sizeof(lote));
+        auditoria_inicia(base);
+        for (int k = 0; k < NUM_ESTEIRAS; k++)
+        {
+            lote.seq_inicio[k] = base[k] + 5;
+            lote.seq_fim[k] = base[k] + 15;
+            lote.contagem[k] = 10;
+        }
+        CONFERE(!auditoria_lote(&lote) && auditoria.lacunas == 5 * NUM_ESTEIRAS,
+                "lote perdido: %u lacunas", auditoria.lacunas);
+        CONFERE(!auditoria_lote(&lote) && auditoria.repetidas == 10 * NUM_ESTEIRAS,
+                "lote repetido: %u repetidas", auditoria.repetidas);
+    }
+
+    TESTE_FIM();
+}
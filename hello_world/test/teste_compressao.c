@@ -0,0 +1,140 @@
+/*
+Arquivo: teste_compressao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da compressão do vetor de pesos: o benchmark de 3 e 64
+        esteiras (razão, vazão e ida e volta), fluxos misturando peso
+        fixo e medido, o pior caso que o relatório reserva, estouro e
+        fluxo inválido, e o desvio em gramas que o lote guarda para o
+        arquivo.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "teste.h"
+#include "compressao.h"
+#include "lote.h"
+
+#define PRODUTOS 5000
+
+static uint32_t estado_aleatorio = 2654435761u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// corridas longas e curtas, fixo e medido, deltas pequenos e de dezenas de kg
+static void testa_misturado(void)
+{
+    static uint8_t classes[PRODUTOS], classes_dec[PRODUTOS], saida[COMPRESSAO_PIOR_CASO(PRODUTOS)];
+    static float pesos[PRODUTOS], pesos_dec[PRODUTOS];
+    static bool medido[PRODUTOS];
+    float dicionario[COMPRESSAO_MAX_CLASSES];
+    compressor_t c;
+    size_t bytes;
+    int n, erradas = 0;
+
+    for (int k = 0; k < COMPRESSAO_MAX_CLASSES; k++)
+    {
+        dicionario[k] = 0.25f * (k + 1);
+    }
+
+    for (int i = 0; i < PRODUTOS; i++)
+    {
+        // corrida da classe anterior com 90% de chance
+        classes[i] = i > 0 && aleatorio() % 10 ? classes[i - 1] : aleatorio() % COMPRESSAO_MAX_CLASSES;
+        medido[i] = (i / 100) % 2 == 1;
+        pesos[i] = dicionario[classes[i]];
+        if (medido[i])
+        {
+            pesos[i] += aleatorio() % 50 == 0 ? (float) (aleatorio() % 60000) / 1000 - 30
+                                              : (float) ((int) (aleatorio() % 41) - 20) / 1000;
+        }
+    }
+
+    compressor_inicia(&c, saida, sizeof(saida));
+    for (int i = 0; i < PRODUTOS; i++)
+    {
+        if (medido[i])
+        {
+            compressor_medido(&c, classes[i], pesos[i]);
+        } else
+        {
+            compressor_fixo(&c, classes[i]);
+        }
+    }
+    bytes = compressor_fim(&c);
+
+    n = compressao_decodifica(saida, bytes, dicionario, classes_dec, pesos_dec, PRODUTOS);
+    CONFERE(bytes > 0 && n == PRODUTOS, "%u bytes, %d produtos decodificados", (unsigned) bytes, n);
+    for (int i = 0; i < n; i++)
+    {
+        erradas += classes_dec[i] != classes[i] || fabsf(pesos_dec[i] - pesos[i]) > 0.5001f / COMPRESSAO_ESCALA;
+    }
+    CONFERE(erradas == 0, "%d produtos diferentes na volta", erradas);
+
+    // fluxo cortado no meio ou com mais produtos que o vetor: inválido
+    CONFERE(compressao_decodifica(saida, bytes - 1, dicionario, NULL, NULL, PRODUTOS) == -1,
+            "fluxo cortado aceito");
+    CONFERE(compressao_decodifica(saida, bytes, dicionario, NULL, NULL, PRODUTOS - 1) == -1,
+            "fluxo maior que o vetor aceito");
+
+    // saída curta: estoura e não devolve fluxo pela metade
+    compressor_inicia(&c, saida, 16);
+    for (int i = 0; i < 100; i++)
+    {
+        compressor_medido(&c, i % 2, pesos[i]);
+    }
+    CONFERE(compressor_fim(&c) == 0, "estouro não detectado");
+}
+
+// o pior caso do relatório: classes alternadas, todas medidas, desvios extremos
+static void testa_pior_caso(void)
+{
+    static uint8_t saida[COMPRESSAO_PIOR_CASO(NUM_MAX_PROD)];
+    compressor_t c;
+
+    compressor_inicia(&c, saida, sizeof(saida));
+    for (int i = 0; i < NUM_MAX_PROD; i++)
+    {
+        compressor_medido(&c, i % 2, i % 4 < 2 ? 0.001f : 500.0f);
+    }
+    CONFERE(compressor_fim(&c) > 0, "pior caso de %d produtos não coube em %u bytes", NUM_MAX_PROD,
+            (unsigned) sizeof(saida));
+}
+
+// desvio em gramas guardado pela inserção: arredondado e saturado
+static void testa_desvio(void)
+{
+    static lote_t lote;
+    const float desvios[] = {0, 0.0126f, -0.0124f, -0.0126f, 0.0006f, 40.0f, -40.0f};
+    const int16_t esperados[] = {0, 13, -12, -13, 1, INT16_MAX, INT16_MIN};
+
+    for (int i = 0; i < (int) (sizeof(desvios) / sizeof(desvios[0])); i++)
+    {
+        lote_insere(&lote, i, 0, desvios[i]);
+        CONFERE(lote.desvio[i] == esperados[i], "desvio %.4f kg: %d g, esperado %d g",
+                (double) desvios[i], lote.desvio[i], esperados[i]);
+    }
+}
+
+int main(void)
+{
+    testa_misturado();
+    testa_pior_caso();
+    testa_desvio();
+
+    // razão e vazão nos traços de 3 e 64 esteiras, com ida e volta conferida
+    CONFERE(compressao_benchmark(), "ida e volta divergiu no benchmark");
+
+    TESTE_FIM();
+}
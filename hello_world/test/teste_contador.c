@@ -0,0 +1,253 @@
+/*
+Arquivo: teste_contador.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes das voltas do contador de 16 bits com um PCNT simulado:
+        a interrupção do limite chega antes da leitura, no meio dela
+        (entre ler as voltas e o valor) ou só depois, e o total de
+        32 bits dá a volta. A soma dos deltas tem que bater com os
+        pulsos em toda leitura. Também o simulador do firmware no
+        relógio simulado.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "esp_timer.h"
+#include "driver/pcnt.h"
+#include "contador.h"
+
+#define UNIDADES 8
+#define LEITURAS 200000
+
+// PCNT simulado: conta até o limite, volta a 0 e deixa a interrupção
+// pendente até o teste entregá-la
+typedef struct
+{
+    bool configurado;
+    int16_t valor;
+    int16_t limite;
+    int pendentes;
+    void (*isr)(void *);
+    void *arg;
+} unidade_t;
+
+static unidade_t unidades[UNIDADES];
+static int servicos_instalados;
+static bool config_falha;
+
+// chance, em mil, de a interrupção pendente rodar dentro da leitura do valor
+static uint32_t isr_durante;
+
+static uint32_t estado_aleatorio = 362436069u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+esp_err_t pcnt_unit_config(const pcnt_config_t *config)
+{
+    if (config_falha || config->unit < 0 || config->unit >= UNIDADES)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(&unidades[config->unit], 0, sizeof(unidade_t));
+    unidades[config->unit].configurado = true;
+    unidades[config->unit].limite = config->counter_h_lim;
+
+    return ESP_OK;
+}
+
+esp_err_t pcnt_set_filter_value(pcnt_unit_t unidade, uint16_t valor)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_filter_enable(pcnt_unit_t unidade)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_event_enable(pcnt_unit_t unidade, pcnt_evt_type_t evento)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_isr_service_install(int flags)
+{
+    servicos_instalados++;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_isr_handler_add(pcnt_unit_t unidade, void (*isr)(void *), void *arg)
+{
+    unidades[unidade].isr = isr;
+    unidades[unidade].arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_pause(pcnt_unit_t unidade)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_clear(pcnt_unit_t unidade)
+{
+    unidades[unidade].valor = 0;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_counter_resume(pcnt_unit_t unidade)
+{
+    return ESP_OK;
+}
+
+static void entrega_isr(unidade_t *u)
+{
+    for (; u->pendentes > 0; u->pendentes--)
+    {
+        u->isr(u->arg);
+    }
+}
+
+// a interrupção pode rodar logo antes ou logo depois de o valor ser lido,
+// sempre depois de contador_delta ler as voltas
+esp_err_t pcnt_get_counter_value(pcnt_unit_t unidade, int16_t *valor)
+{
+    unidade_t *u = &unidades[unidade];
+    bool durante = aleatorio() % 1000 < isr_durante;
+    bool antes = aleatorio() % 2;
+
+    if (durante && antes)
+    {
+        entrega_isr(u);
+    }
+    *valor = u->valor;
+    if (durante && !antes)
+    {
+        entrega_isr(u);
+    }
+
+    return ESP_OK;
+}
+
+static void pulsos(unidade_t *u, uint32_t n)
+{
+    uint32_t valor = u->valor + n;
+
+    u->pendentes += valor / u->limite;
+    u->valor = (int16_t) (valor % u->limite);
+}
+
+// uma unidade lida LEITURAS vezes, com até ~2/3 do limite entre leituras;
+// voltas_inicio perto de 2^32 / CONTADOR_LIMITE faz o total dar a volta
+static void testa_unidade(int unidade, uint32_t voltas_inicio)
+{
+    unidade_t *u = &unidades[unidade];
+    contador_t c;
+    uint32_t contados = 0, esperados = 0, divergencias = 0, voltas_hw = 0;
+
+    CONFERE(contador_inicia_pcnt(&c, unidade, 4 + unidade), "unidade %d não configurou", unidade);
+    CONFERE(u->configurado && u->limite == CONTADOR_LIMITE && u->isr != NULL,
+            "unidade %d configurada sem o limite ou a ISR", unidade);
+
+    // ligado há muito tempo: voltas e última leitura já avançadas
+    c.voltas = voltas_inicio;
+    c.anterior = voltas_inicio * CONTADOR_LIMITE;
+
+    for (int i = 0; i < LEITURAS; i++)
+    {
+        // rajadas pequenas e leituras atrasadas (a esteira perdeu o período)
+        uint32_t n = aleatorio() % 16 == 0 ? aleatorio() % (2 * CONTADOR_LIMITE / 3) : aleatorio() % 200;
+
+        voltas_hw += (u->valor + n) / CONTADOR_LIMITE;
+        pulsos(u, n);
+        esperados += n;
+
+        // a ISR chega antes da leitura, dentro dela ou logo depois; nunca
+        // fica pendente até a leitura seguinte (latência de microssegundos
+        // contra CONTADOR_PERIODO_MS)
+        switch (aleatorio() % 3)
+        {
+        case 0:
+            entrega_isr(u);
+            break;
+        case 1:
+            isr_durante = 500;
+            break;
+        }
+
+        contados += contador_delta(&c);
+        isr_durante = 0;
+        entrega_isr(u);
+        divergencias += contados != esperados;
+    }
+
+    CONFERE(divergencias == 0 && contados == esperados, "unidade %d: %u leituras divergentes, %u de %u",
+            unidade, divergencias, contados, esperados);
+    CONFERE(c.voltas - voltas_inicio == voltas_hw && voltas_hw > 1000,
+            "unidade %d: %u voltas na ISR, %u no hardware", unidade, c.voltas - voltas_inicio, voltas_hw);
+    CONFERE(c.voltas_pendentes > 1000, "unidade %d: só %u leituras com a volta pendente", unidade,
+            c.voltas_pendentes);
+}
+
+// simulador do firmware: os produtos devidos pelo tempo saem em rajadas
+// inteiras, sem perder nem inventar nenhum
+static void testa_simulador(void)
+{
+    contador_t c;
+    uint32_t contados = 0, devidos;
+
+    hospedeiro_relogio(1000000);
+    contador_inicia_simulado(&c, 10, 7);
+    for (int i = 1; i <= 1000; i++)
+    {
+        hospedeiro_relogio(1000000 + i * CONTADOR_PERIODO_MS * 1000);
+        contados += contador_delta(&c);
+    }
+    devidos = 1000 * CONTADOR_PERIODO_MS / 10;
+
+    CONFERE(contados <= devidos && contados > devidos - CONTADOR_RAJADA_MAX,
+            "simulador: %u produtos, %u devidos", contados, devidos);
+
+    // pulsos injetados: cada volta sai no delta da leitura seguinte
+    contador_inicia_simulado(&c, 0, 1);
+    contados = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        contador_pulsos(&c, CONTADOR_LIMITE - 1);
+        contados += contador_delta(&c);
+    }
+    CONFERE(contados == 100 * (CONTADOR_LIMITE - 1) &&
+            c.voltas == 100 * (CONTADOR_LIMITE - 1) / CONTADOR_LIMITE, "pulsos injetados: %u contados, %u voltas", contados, c.voltas);
+    hospedeiro_relogio_real();
+}
+
+int main(void)
+{
+    contador_t c;
+
+    config_falha = true;
+    CONFERE(!contador_inicia_pcnt(&c, 0, 4), "unidade sem configuração aceita");
+    config_falha = false;
+
+    for (int u = 0; u < UNIDADES; u++)
+    {
+        // metade das unidades atravessa a volta de 32 bits do total
+        testa_unidade(u, u % 2 ? 0xFFFFFFFFu / CONTADOR_LIMITE - 100 : 0);
+    }
+    CONFERE(servicos_instalados == 1, "serviço de ISR instalado %d vezes", servicos_instalados);
+
+    testa_simulador();
+
+    TESTE_FIM();
+}
@@ -0,0 +1,346 @@
+/*
+Arquivo: teste_escalonamento.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da atribuição RM, da partição entre cores e da análise
+        de tempo de resposta com conjuntos de resposta conhecida, de
+        3 tarefas até o sistema montado com 64 esteiras e todos os
+        trabalhadores da redução, e a contenção no mutex com as
+        esteiras sincronizadas e defasadas.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include "teste.h"
+#include "escalonamento.h"
+
+// mesmas faixas de prioridade e periodos do firmware
+#define PRIORIDADE_MIN 1
+#define PRIORIDADE_MAX 5
+#define TEMPO_TOUCH 200
+#define TEMPO_ATUALIZACAO 2000
+#define NUM_MAX_PROD 200
+#define TICK_MS 10
+
+// 60 s de liberações na comparação das fases
+#define TICKS_SIMULADOS 6000
+
+static conjunto_tarefas_t c;
+
+// (C, T) = (1, 4), (2, 6), (c3, 10) ms num core só
+static bool tres_tarefas(uint32_t c3_ms)
+{
+    escalonamento_inicia(&c, 1);
+    escalonamento_adiciona(&c, "t1", 4000, 1000, 0, false);
+    escalonamento_adiciona(&c, "t2", 6000, 2000, 0, false);
+    escalonamento_adiciona(&c, "t3", 10000, c3_ms * 1000, 0, false);
+    escalonamento_atribui_rm(&c, PRIORIDADE_MIN, PRIORIDADE_MAX);
+
+    return escalonamento_particiona(&c);
+}
+
+static void testa_rta(void)
+{
+    // U = 0,883: R3 converge em 10 ms, exatamente o deadline
+    CONFERE(tres_tarefas(3), "conjunto escalonável rejeitado");
+    CONFERE(c.tarefas[0].prioridade == 5 && c.tarefas[1].prioridade == 4 &&
+            c.tarefas[2].prioridade == 3, "prioridades %u %u %u", c.tarefas[0].prioridade,
+            c.tarefas[1].prioridade, c.tarefas[2].prioridade);
+    CONFERE(c.tarefas[0].resposta_us == 1000, "R1 = %u", c.tarefas[0].resposta_us);
+    CONFERE(c.tarefas[1].resposta_us == 3000, "R2 = %u", c.tarefas[1].resposta_us);
+    CONFERE(c.tarefas[2].resposta_us == 10000, "R3 = %u", c.tarefas[2].resposta_us);
+
+    // U = 0,983 <= 1, mas R3 = 11 ms passa do deadline
+    CONFERE(!tres_tarefas(4), "conjunto com U <= 1 e R3 > T3 aceito");
+    CONFERE(c.tarefas[2].resposta_us == 0, "R3 = %u", c.tarefas[2].resposta_us);
+    CONFERE(c.utilizacao[0] < 1.0f, "utilização %.3f", c.utilizacao[0]);
+}
+
+static void testa_bloqueio(void)
+{
+    escalonamento_inicia(&c, 1);
+    escalonamento_adiciona(&c, "alta", 4000, 1000, 500, true);
+    escalonamento_adiciona(&c, "baixa", 10000, 2000, 1500, true);
+    escalonamento_adiciona(&c, "livre", 20000, 1000, 0, false);
+    escalonamento_atribui_rm(&c, PRIORIDADE_MIN, PRIORIDADE_MAX);
+
+    CONFERE(escalonamento_particiona(&c), "conjunto com bloqueio rejeitado");
+
+    // a de prioridade alta espera a seção inteira da baixa; quem não usa o mutex não
+    CONFERE(c.tarefas[0].resposta_us == 2500, "R alta = %u", c.tarefas[0].resposta_us);
+    CONFERE(c.tarefas[1].resposta_us == 3500, "R baixa = %u", c.tarefas[1].resposta_us);
+    CONFERE(c.tarefas[2].resposta_us == 4000, "R livre = %u", c.tarefas[2].resposta_us);
+
+    // seção medida maior que o deadline da alta: só a análise com medidas pega
+    escalonamento_registra_secao(&c.tarefas[1], 3500);
+    CONFERE(escalonamento_analisa(&c, false), "análise sem medidas mudou");
+    CONFERE(!escalonamento_analisa(&c, true), "bloqueio medido ignorado");
+}
+
+static void testa_particao(void)
+{
+    // quatro tarefas de U = 0,5: duas por core
+    escalonamento_inicia(&c, 2);
+    for (int i = 0; i < 4; i++)
+    {
+        escalonamento_adiciona(&c, "metade", 10000, 5000, 0, false);
+    }
+    escalonamento_atribui_rm(&c, PRIORIDADE_MIN, PRIORIDADE_MAX);
+
+    CONFERE(escalonamento_particiona(&c), "quatro metades não couberam em dois cores");
+    CONFERE(c.tarefas[0].core == 0 && c.tarefas[1].core == 0 &&
+            c.tarefas[2].core == 1 && c.tarefas[3].core == 1, "cores %d %d %d %d",
+            c.tarefas[0].core, c.tarefas[1].core, c.tarefas[2].core, c.tarefas[3].core);
+
+    // a quinta não cabe em nenhum
+    escalonamento_adiciona(&c, "metade", 10000, 5000, 0, false);
+    escalonamento_atribui_rm(&c, PRIORIDADE_MIN, PRIORIDADE_MAX);
+    CONFERE(!escalonamento_particiona(&c), "cinco metades couberam em dois cores");
+
+    // core fixo é respeitado mesmo com o outro livre
+    escalonamento_inicia(&c, 2);
+    escalonamento_adiciona(&c, "fixa", 10000, 1000, 0, false)->core_fixo = 1;
+    escalonamento_atribui_rm(&c, PRIORIDADE_MIN, PRIORIDADE_MAX);
+    CONFERE(escalonamento_particiona(&c) && c.tarefas[0].core == 1, "core %d", c.tarefas[0].core);
+}
+
+// o conjunto que o firmware monta com 64 esteiras de periodos 10..50 ms,
+// cada produto segurando o mutex por insercao_us
+static bool sistema_64(uint32_t insercao_us)
+{
+    static const char *nomes[64];
+    float produtos_por_s = 0;
+
+    escalonamento_inicia(&c, 2);
+
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t periodo_ms = 10 * (1 + i % 5);
+
+        nomes[i] = "esteira";
+        escalonamento_adiciona(&c, nomes[i], periodo_ms * 1000, insercao_us, insercao_us, true);
+        produtos_por_s += 1000.0f / periodo_ms;
+    }
+
+    uint32_t periodo_lote_us = (uint32_t) (NUM_MAX_PROD * 1000000.0f / produtos_por_s);
+
+    escalonamento_adiciona(&c, "reducao", periodo_lote_us, 200, 0, false)->core_fixo = 1;
+    escalonamento_adiciona(&c, "relatorio", periodo_lote_us, 2000, 0, false);
+    escalonamento_adiciona(&c, "touch", TEMPO_TOUCH * 1000, 500, 0, false);
+    escalonamento_adiciona(&c, "display", TEMPO_ATUALIZACAO * 1000, 20000, 0, false);
+    escalonamento_atribui_rm(&c, PRIORIDADE_MIN, PRIORIDADE_MAX);
+
+    return escalonamento_particiona(&c);
+}
+
+static void testa_64_esteiras(void)
+{
+    int por_core[2] = {0, 0};
+
+    CONFERE(sistema_64(20), "64 esteiras com 20 us por produto rejeitadas");
+    CONFERE(c.num_tarefas == 68, "%d tarefas", c.num_tarefas);
+
+    for (int i = 0; i < c.num_tarefas; i++)
+    {
+        CONFERE(c.tarefas[i].core >= 0 && c.tarefas[i].resposta_us > 0 &&
+                c.tarefas[i].resposta_us <= c.tarefas[i].periodo_us, "%s: core %d R %u",
+                c.tarefas[i].nome, c.tarefas[i].core, c.tarefas[i].resposta_us);
+        CONFERE(c.tarefas[i].prioridade >= PRIORIDADE_MIN &&
+                c.tarefas[i].prioridade <= PRIORIDADE_MAX, "prioridade %u", c.tarefas[i].prioridade);
+        por_core[c.tarefas[i].core]++;
+    }
+
+    // 10 ms é o menor periodo: prioridade máxima; display e touch dividem a mínima
+    CONFERE(c.tarefas[0].prioridade == PRIORIDADE_MAX, "prioridade %u", c.tarefas[0].prioridade);
+    CONFERE(c.tarefas[67].prioridade == PRIORIDADE_MIN, "prioridade %u", c.tarefas[67].prioridade);
+    CONFERE(c.tarefas[64].core == 1, "redução fora do core fixo");
+    CONFERE(por_core[0] + por_core[1] == 68, "%d + %d tarefas", por_core[0], por_core[1]);
+
+    // 1 ms por produto: U ~ 2,8 nos dois cores juntos
+    CONFERE(!sistema_64(1000), "64 esteiras sobrecarregadas aceitas");
+
+    // cabe em utilização (U ~ 0,3), mas um bloqueio medido de 9,5 ms estoura
+    // as esteiras de 10 ms
+    CONFERE(sistema_64(100), "64 esteiras com 100 us por produto rejeitadas");
+    escalonamento_registra_secao(&c.tarefas[63], 9500);
+    CONFERE(!escalonamento_analisa(&c, true), "bloqueio de 9,5 ms aceito");
+}
+
+static void testa_medicao(void)
+{
+    tres_tarefas(3);
+
+    // medidas zeradas: nada novo; depois só quando um pior caso cresce
+    CONFERE(!escalonamento_medicao_mudou(&c), "mudou sem medidas");
+    escalonamento_registra(&c.tarefas[1], 1500);
+    CONFERE(escalonamento_medicao_mudou(&c), "resposta medida nova não vista");
+    CONFERE(escalonamento_analisa(&c, true), "1,5 ms medido abaixo do R rejeitado");
+    CONFERE(!escalonamento_medicao_mudou(&c), "mudou logo após a análise");
+
+    escalonamento_registra(&c.tarefas[1], 1400);
+    CONFERE(!escalonamento_medicao_mudou(&c), "medida menor contou como mudança");
+
+    // o job medido de parede da t2 inclui a preempção pela t1 (R2 = 3 ms):
+    // não vira C, senão a t3, no limite, perderia o deadline pela t1 contada duas vezes
+    escalonamento_registra(&c.tarefas[1], 2900);
+    CONFERE(escalonamento_analisa(&c, true), "resposta medida somada como C");
+    CONFERE(c.tarefas[2].resposta_us == 10000, "R3 = %u", c.tarefas[2].resposta_us);
+
+    // um job mais longo que o R calculado desmente o C estimado
+    escalonamento_registra(&c.tarefas[2], 10100);
+    CONFERE(escalonamento_medicao_mudou(&c), "resposta maior não vista");
+    CONFERE(!escalonamento_analisa(&c, true), "job acima do R3 aceito");
+
+    escalonamento_registra_secao(&c.tarefas[0], 10);
+    CONFERE(escalonamento_medicao_mudou(&c), "seção medida não vista");
+}
+
+typedef struct
+{
+    int contencoes;     // produtos que acharam o mutex ocupado
+    int pico;           // mais liberações num mesmo tick
+    uint32_t pior_us;   // pior espera mais a própria inserção
+    uint64_t espera_us; // soma das esperas pelo mutex
+    int produtos;
+} contencao_t;
+
+// as esteiras acordam no tick da liberação e disputam o mutex por
+// insercao_us cada; o tick inteiro serializa quem acordou junto
+static contencao_t simula(const uint32_t *periodos_ms, const uint32_t *fases_ms, int n,
+                          uint32_t insercao_us)
+{
+    contencao_t r = {0, 0, 0, 0, 0};
+
+    for (uint32_t t = 0; t < TICKS_SIMULADOS; t++)
+    {
+        int liberadas = 0;
+
+        for (int i = 0; i < n; i++)
+        {
+            uint32_t p = periodos_ms[i] / TICK_MS, fase = fases_ms[i] / TICK_MS;
+
+            liberadas += t >= fase && (t - fase) % p == 0;
+        }
+
+        r.contencoes += liberadas > 1 ? liberadas - 1 : 0;
+        r.espera_us += (uint64_t) liberadas * (liberadas - 1) / 2 * insercao_us;
+        r.produtos += liberadas;
+        r.pico = liberadas > r.pico ? liberadas : r.pico;
+        if (liberadas * insercao_us > r.pior_us)
+        {
+            r.pior_us = liberadas * insercao_us;
+        }
+    }
+
+    return r;
+}
+
+static uint32_t mdc(uint32_t a, uint32_t b)
+{
+    return b == 0 ? a : mdc(b, a % b);
+}
+
+// sincronizadas, a fase antiga (i * mdc / n truncado em ticks) e a nova
+static void compara_fases(const char *nome, const uint32_t *periodos, int n, contencao_t *nova)
+{
+    uint32_t zeros[64] = {0}, antigas[64], fases[64];
+    uint32_t g = 0;
+    bool dentro = true;
+
+    for (int i = 0; i < n; i++)
+    {
+        g = mdc(g, periodos[i] / TICK_MS);
+    }
+    for (int i = 0; i < n; i++)
+    {
+        antigas[i] = (i * g / n) * TICK_MS;
+    }
+
+    escalonamento_fases(periodos, fases, n, TICK_MS);
+    for (int i = 0; i < n; i++)
+    {
+        dentro &= fases[i] < periodos[i] && fases[i] % TICK_MS == 0;
+    }
+    CONFERE(dentro, "%s: fase fora do periodo ou do tick", nome);
+
+    contencao_t sinc = simula(periodos, zeros, n, 20);
+    contencao_t antiga = simula(periodos, antigas, n, 20);
+
+    *nova = simula(periodos, fases, n, 20);
+
+    printf("%-10s contenções / espera média (us) / pico / pior inserção (us):\n"
+           "  sincronizadas %6d / %6.1f / %2d / %4u\n"
+           "  mdc truncado  %6d / %6.1f / %2d / %4u\n"
+           "  hiperperiodo  %6d / %6.1f / %2d / %4u\n", nome,
+           sinc.contencoes, (double) sinc.espera_us / sinc.produtos, sinc.pico, sinc.pior_us,
+           antiga.contencoes, (double) antiga.espera_us / antiga.produtos, antiga.pico, antiga.pior_us,
+           nova->contencoes, (double) nova->espera_us / nova->produtos, nova->pico, nova->pior_us);
+
+    CONFERE(nova->contencoes <= antiga.contencoes && nova->espera_us <= antiga.espera_us &&
+            nova->pior_us <= antiga.pior_us && antiga.pior_us <= sinc.pior_us,
+            "%s: fases novas piores que as antigas", nome);
+}
+
+static void testa_fases(void)
+{
+    static const uint32_t firmware[3] = {1000, 500, 100};
+    uint32_t esteiras_64[64], fases[64];
+    contencao_t r;
+
+    // as três esteiras do firmware nunca acordam juntas
+    compara_fases("3 esteiras", firmware, 3, &r);
+    CONFERE(r.contencoes == 0 && r.pico == 1, "%d contenções, pico %d", r.contencoes, r.pico);
+
+    // 10..50 ms: o mdc é um tick só e a fórmula antiga punha as 64 no tick 0;
+    // 13 de 10 ms acordam em todo tick, as outras 51 se espalham (~29,5 por tick)
+    for (int i = 0; i < 64; i++)
+    {
+        esteiras_64[i] = 10 * (1 + i % 5);
+    }
+    compara_fases("64 esteiras", esteiras_64, 64, &r);
+    CONFERE(r.pico <= 31 && r.pior_us <= 31 * 20, "pico %d, pior %u us", r.pico, r.pior_us);
+    CONFERE(r.espera_us * 10 < simula(esteiras_64, (uint32_t[64]) {0}, 64, 20).espera_us * 9,
+            "espera só caiu de %llu us", (unsigned long long) r.espera_us);
+
+    // hiperperiodo longo demais: as fases ficam no mdc, em us antes do tick
+    esteiras_64[0] = 40970;
+    esteiras_64[1] = 40960;
+    escalonamento_fases(esteiras_64, fases, 2, TICK_MS);
+    CONFERE(fases[0] == 0 && fases[1] == 10, "fases %u %u", fases[0], fases[1]);
+}
+
+// o firmware com 64 esteiras e o máximo de trabalhadores da redução
+static void testa_capacidade(void)
+{
+    int n = 0;
+
+    CONFERE(ESCALONAMENTO_MAX_TAREFAS == 64 + 4 + REDUCAO_MAX_TRABALHADORES, "%d tarefas",
+            ESCALONAMENTO_MAX_TAREFAS);
+
+    sistema_64(20);
+    for (int i = 0; i < REDUCAO_MAX_TRABALHADORES; i++)
+    {
+        n += escalonamento_adiciona(&c, "trabalhador", 10000, 10, 0, false) != NULL;
+    }
+    CONFERE(n == REDUCAO_MAX_TRABALHADORES && c.num_tarefas == 76, "%d trabalhadores, %d tarefas",
+            n, c.num_tarefas);
+
+    // cheio: o firmware recebe NULL e para a partida
+    CONFERE(escalonamento_adiciona(&c, "sobra", 10000, 10, 0, false) == NULL, "77ª tarefa aceita");
+}
+
+int main(void)
+{
+    testa_rta();
+    testa_bloqueio();
+    testa_particao();
+    testa_64_esteiras();
+    testa_medicao();
+    testa_capacidade();
+    testa_fases();
+
+    TESTE_FIM();
+}
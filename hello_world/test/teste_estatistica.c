@@ -0,0 +1,168 @@
+/*
+Arquivo: teste_estatistica.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da estatística por lote e do acumulado da esteira:
+        valores exatos em conjuntos pequenos, lote zerado sem restos do
+        anterior, junção de Chan igual à sequência direta e a
+        estabilidade com 10^8 amostras no fluxo do firmware (float por
+        lote, double entre lotes), que no ESP32 levaria minutos.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include "teste.h"
+#include "lote.h"
+#include "estatistica.h"
+
+#define AMOSTRAS_ESTABILIDADE 100000000u
+
+// pesos perto de 2 kg com ruído uniforme de ±50 g (variância 0,1²/12)
+#define NOMINAL 2.0f
+#define AMPLITUDE 0.1f
+
+static uint32_t aleatorio = 1;
+
+static float amostra(void)
+{
+    aleatorio = aleatorio * 1664525 + 1013904223;
+
+    return NOMINAL + AMPLITUDE * ((aleatorio >> 8) * (1.0f / (1 << 24)) - 0.5f);
+}
+
+static void testa_exatos(void)
+{
+    const float pesos[] = {2.0f, 4.0f, 4.0f, 4.0f, 5.0f, 5.0f, 7.0f, 9.0f};
+    estatistica_t e;
+
+    estatistica_zera(&e);
+    CONFERE(estatistica_variancia(&e) == 0 && e.min == 0 && e.max == 0, "lote vazio com valores");
+
+    for (int i = 0; i < 8; i++)
+    {
+        estatistica_acrescenta(&e, pesos[i]);
+    }
+    CONFERE(e.n == 8 && e.media == 5.0f && e.min == 2.0f && e.max == 9.0f,
+            "n %u média %f min %f max %f", e.n, e.media, e.min, e.max);
+    CONFERE(fabsf(estatistica_variancia(&e) - 32.0f / 7) < 1e-5f, "variância %f", estatistica_variancia(&e));
+
+    // o lote seguinte de uma esteira parada não herda min e max
+    estatistica_zera(&e);
+    CONFERE(e.n == 0 && e.media == 0 && e.min == 0 && e.max == 0,
+            "lote zerado com min %f max %f", e.min, e.max);
+    estatistica_acrescenta(&e, 3.0f);
+    CONFERE(e.min == 3.0f && e.max == 3.0f && estatistica_variancia(&e) == 0, "um produto só");
+}
+
+// lotes de tamanhos variados, vazios inclusive, juntados por Chan contra
+// o Welford direto em double
+static void testa_junta(void)
+{
+    estatistica_acumulada_t a;
+    estatistica_t lote;
+    double n = 0, media = 0, m2 = 0;
+    float min = INFINITY, max = -INFINITY;
+
+    estatistica_zera_acumulada(&a);
+    for (int l = 0; l < 200; l++)
+    {
+        int tamanho = l % 7 == 0 ? 0 : 1 + (l * 37) % NUM_MAX_PROD;
+
+        estatistica_zera(&lote);
+        for (int i = 0; i < tamanho; i++)
+        {
+            float x = amostra() + (l % 3) * 0.5f;
+            double delta = x - media;
+
+            estatistica_acrescenta(&lote, x);
+            n++;
+            media += delta / n;
+            m2 += delta * (x - media);
+            min = fminf(min, x);
+            max = fmaxf(max, x);
+        }
+        estatistica_junta(&a, &lote);
+    }
+
+    CONFERE(a.n == (uint64_t) n && a.min == min && a.max == max, "n %llu min %f max %f",
+            (unsigned long long) a.n, a.min, a.max);
+    CONFERE(fabs(a.media - media) / media < 1e-6, "média %.9f, direta %.9f", a.media, media);
+    CONFERE(fabs(estatistica_variancia_acumulada(&a) - m2 / (n - 1)) / (m2 / (n - 1)) < 1e-4,
+            "variância %.6e, direta %.6e", estatistica_variancia_acumulada(&a), m2 / (n - 1));
+}
+
+// mesmo fluxo do firmware contra o Welford em float sem lotes e a soma
+// ingênua em float; a referência soma em double os desvios em torno do
+// nominal, sem cancelamento
+static void testa_estabilidade(void)
+{
+    estatistica_t lote, direto;
+    estatistica_acumulada_t acumulado;
+    float soma = 0, soma_quadrados = 0;
+    double soma_ref = 0, quadrados_ref = 0;
+    double media_ref, variancia_ref, media_ingenua, variancia_ingenua;
+    double erro_media, erro_variancia;
+    uint32_t n = AMOSTRAS_ESTABILIDADE;
+
+    estatistica_zera(&lote);
+    estatistica_zera(&direto);
+    estatistica_zera_acumulada(&acumulado);
+    aleatorio = 1;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        float x = amostra();
+        double d = (double) x - NOMINAL;
+
+        estatistica_acrescenta(&lote, x);
+        if (lote.n == NUM_MAX_PROD)
+        {
+            estatistica_junta(&acumulado, &lote);
+            estatistica_zera(&lote);
+        }
+
+        estatistica_acrescenta(&direto, x);
+        soma += x;
+        soma_quadrados += x * x;
+        soma_ref += d;
+        quadrados_ref += d * d;
+    }
+    estatistica_junta(&acumulado, &lote);
+
+    media_ref = NOMINAL + soma_ref / n;
+    variancia_ref = (quadrados_ref - soma_ref * soma_ref / n) / (n - 1);
+    media_ingenua = (double) soma / n;
+    variancia_ingenua = ((double) soma_quadrados - (double) soma * soma / n) / (n - 1);
+    erro_media = fabs(acumulado.media - media_ref) / media_ref;
+    erro_variancia = fabs(estatistica_variancia_acumulada(&acumulado) - variancia_ref) / variancia_ref;
+
+    printf("Estabilidade com %u amostras: referência média %.6f variância %.4e\n", n, media_ref,
+           variancia_ref);
+    printf("  lotes + double: erro da média %.2e, da variância %.2e (relativo)\n", erro_media,
+           erro_variancia);
+    printf("  Welford float:  erro da média %.2e, da variância %.2e\n",
+           fabs(direto.media - media_ref) / media_ref,
+           fabs(estatistica_variancia(&direto) - variancia_ref) / variancia_ref);
+    printf("  soma ingênua:   erro da média %.2e, da variância %.2e\n",
+           fabs(media_ingenua - media_ref) / media_ref,
+           fabs(variancia_ingenua - variancia_ref) / variancia_ref);
+
+    CONFERE(acumulado.n == n, "%llu amostras no acumulado", (unsigned long long) acumulado.n);
+    CONFERE(erro_media < 1e-8 && erro_variancia < 1e-6, "acumulado instável: média %.2e, variância %.2e",
+            erro_media, erro_variancia);
+    // a soma ingênua em float para de andar: a conferência tem que enxergar isso
+    CONFERE(fabs(media_ingenua - media_ref) / media_ref > 0.1, "soma ingênua não divergiu");
+}
+
+int main(void)
+{
+    testa_exatos();
+    testa_junta();
+    testa_estabilidade();
+
+    TESTE_FIM();
+}
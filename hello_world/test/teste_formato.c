@@ -0,0 +1,157 @@
+/*
+Arquivo: teste_formato.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes do formatador: números em ponto fixo, valores fora de
+        int32_t, NaN e infinito, e a escrita que descarta em vez de
+        bloquear quando o buffer de transmissão da UART está cheio,
+        contando também o que printf entregou ao driver.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "teste.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "formato.h"
+
+// UART falsa: guarda o que seria transmitido
+static char transmitido[16384];
+static int num_transmitido;
+
+esp_err_t uart_driver_install(uart_port_t porta, int rx, int tx, int fila, void *handle, int flags)
+{
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t porta, const char *dados, size_t n)
+{
+    memcpy(&transmitido[num_transmitido], dados, n);
+    num_transmitido += n;
+    return n;
+}
+
+// formata valor com casas decimais e confere o texto
+static void confere_decimal(float valor, int casas, const char *esperado)
+{
+    char buf[32];
+    linha_t l;
+
+    linha_inicia(&l, buf, sizeof(buf) - 1);
+    linha_decimal(&l, valor, casas);
+    buf[l.pos] = '\0';
+
+    CONFERE(strcmp(buf, esperado) == 0, "%g com %d casas: \"%s\", esperado \"%s\"",
+            (double) valor, casas, buf, esperado);
+}
+
+static void testa_decimal(void)
+{
+    confere_decimal(61728.5f, 3, "61728.500");
+    confere_decimal(10.04f, 2, "10.04");
+    confere_decimal(0.05f, 3, "0.050");
+    confere_decimal(-1.25f, 1, "-1.3");
+    confere_decimal(-0.004f, 2, "0.00");
+    confere_decimal(0, 0, "0");
+    confere_decimal(2147483000.0f, 0, "2147483008");
+    confere_decimal(-2147483000.0f, 0, "-2147483008");
+
+    // fora de int32_t depois da escala
+    confere_decimal(3e9f, 0, "ovf");
+    confere_decimal(1e7f, 3, "ovf");
+    confere_decimal(-1e7f, 3, "-ovf");
+    confere_decimal(INFINITY, 2, "ovf");
+    confere_decimal(-INFINITY, 2, "-ovf");
+    confere_decimal(NAN, 2, "nan");
+}
+
+static void testa_fixo(void)
+{
+    char buf[64];
+    linha_t l;
+
+    linha_inicia(&l, buf, sizeof(buf) - 1);
+    linha_fixo(&l, -5, 3);
+    linha_texto(&l, " ");
+    linha_i32(&l, INT32_MIN);
+    linha_texto(&l, " ");
+    linha_u32(&l, UINT32_MAX);
+    linha_texto(&l, " ");
+    linha_duracao(&l, 12345678);
+    buf[l.pos] = '\0';
+
+    CONFERE(strcmp(buf, "-0.005 -2147483648 4294967295 12.345 s") == 0, "\"%s\"", buf);
+
+    // linha curta: o excesso é contado, não escrito
+    linha_inicia(&l, buf, 4);
+    linha_u32(&l, 1234567);
+    CONFERE(l.pos == 4 && l.truncado == 3 && memcmp(buf, "1234", 4) == 0,
+            "pos %d, truncado %d", l.pos, l.truncado);
+}
+
+static void testa_uart_cheia(void)
+{
+    static char dados[FORMATO_BUFFER_TX];
+    int64_t agora = 1000000;
+
+    memset(dados, 'x', sizeof(dados));
+    hospedeiro_relogio(agora);
+
+    // o buffer de transmissão inteiro cabe de uma vez
+    CONFERE(formato_escreve(dados, 1000) == 1000, "primeira escrita");
+    CONFERE(formato_escreve(dados, FORMATO_BUFFER_TX - 1000) == FORMATO_BUFFER_TX - 1000,
+            "escrita até encher");
+
+    // cheio: descarta a escrita inteira e conta, sem bloquear nem cortar
+    CONFERE(formato_escreve(dados, 100) == 0, "escrita com o buffer cheio aceita");
+    CONFERE(formato_descartadas() == 1, "%u descartadas", formato_descartadas());
+    CONFERE(num_transmitido == FORMATO_BUFFER_TX, "%d bytes transmitidos", num_transmitido);
+
+    // 10 ms a 115200 baud escoam 115 bytes
+    agora += 10000;
+    hospedeiro_relogio(agora);
+    CONFERE(formato_escreve(dados, 100) == 100, "escrita depois de escoar");
+    CONFERE(formato_escreve(dados, 100) == 0, "escrita além do que escoou aceita");
+    CONFERE(formato_descartadas() == 2, "%u descartadas", formato_descartadas());
+
+    // depois de o buffer esvaziar, uma linha do log sai inteira
+    agora += 1000000;
+    hospedeiro_relogio(agora);
+    num_transmitido = 0;
+    {
+        linha_t l;
+
+        linha_inicia(&l, dados, sizeof(dados));
+        linha_texto(&l, "Lote 7: ");
+        linha_decimal(&l, 12.5f, 3);
+        linha_nova(&l);
+        CONFERE(linha_escreve(&l) == 15 && l.pos == 0, "linha não escrita");
+        CONFERE(num_transmitido == 15 && memcmp(transmitido, "Lote 7: 12.500\n", 15) == 0,
+                "\"%.*s\"", num_transmitido, transmitido);
+    }
+
+    // um despejo por printf maior que o buffer: ao voltar, no máximo o
+    // buffer inteiro está pendente, e escoa no mesmo ritmo
+    agora += 1000000;
+    hospedeiro_relogio(agora);
+    formato_externo(36000);
+    CONFERE(formato_escreve(dados, 100) == 0, "escrita aceita logo depois do printf");
+    agora += 10000;
+    hospedeiro_relogio(agora);
+    CONFERE(formato_escreve(dados, 100) == 100, "o buffer do printf não escoou");
+    hospedeiro_relogio_real();
+}
+
+int main(void)
+{
+    testa_decimal();
+    testa_fixo();
+    testa_uart_cheia();
+
+    TESTE_FIM();
+}
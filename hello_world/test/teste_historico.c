@@ -0,0 +1,225 @@
+/*
+Arquivo: teste_historico.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes do anel do histórico sobre uma partição falsa em RAM
+        que se comporta como NOR (apagar põe 0xFF, gravar só zera
+        bits): releitura depois da partida, volta do anel, registro
+        corrompido, gravação interrompida e setor meio apagado.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "teste.h"
+#include "esp_partition.h"
+#include "historico.h"
+
+#define SETORES 4
+#define POR_SETOR (SPI_FLASH_SEC_SIZE / HISTORICO_REGISTRO - 1)
+
+static uint8_t flash[SETORES * SPI_FLASH_SEC_SIZE];
+static const esp_partition_t particao = {ESP_PARTITION_TYPE_DATA, HISTORICO_SUBTIPO, 0x310000,
+                                         sizeof(flash), "historico"};
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t tipo,
+                                                esp_partition_subtype_t subtipo, const char *rotulo)
+{
+    return tipo == particao.type && subtipo == particao.subtype ? &particao : NULL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *p, size_t inicio, size_t tamanho,
+                             spi_flash_mmap_memory_t memoria, const void **ponteiro,
+                             spi_flash_mmap_handle_t *handle)
+{
+    *ponteiro = flash + inicio;
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t inicio, size_t tamanho)
+{
+    if (inicio % SPI_FLASH_SEC_SIZE != 0 || tamanho % SPI_FLASH_SEC_SIZE != 0 ||
+        inicio + tamanho > sizeof(flash))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(flash + inicio, 0xFF, tamanho);
+    return ESP_OK;
+}
+
+// NOR: a gravação só leva bits de 1 para 0
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t destino, const void *origem,
+                              size_t tamanho)
+{
+    if (destino + tamanho > sizeof(flash))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < tamanho; i++)
+    {
+        flash[destino + i] &= ((const uint8_t *) origem)[i];
+    }
+    return ESP_OK;
+}
+
+// registro cujos campos são todos função do número do lote
+static void preenche(historico_registro_t *r, uint32_t lote)
+{
+    memset(r, 0, sizeof(*r));
+    r->lote = lote;
+    r->tempo_ms = lote * 250;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        r->seq_inicio[i] = lote * 100 + i;
+        r->contagem[i] = (uint16_t) (lote % 1000 + i);
+    }
+    r->peso_total = lote * 0.5f;
+    r->reducao_us = lote % 7;
+}
+
+static void acrescenta(uint32_t de, uint32_t ate)
+{
+    historico_registro_t r;
+
+    for (uint32_t lote = de; lote < ate; lote++)
+    {
+        preenche(&r, lote);
+        CONFERE(historico_acrescenta(&r), "acréscimo do lote %u", lote);
+    }
+}
+
+typedef struct
+{
+    uint32_t lidos[SETORES * POR_SETOR];
+    uint32_t n;
+    uint32_t campos_errados;
+} leitura_t;
+
+static bool visita(const historico_registro_t *r, void *contexto)
+{
+    leitura_t *l = (leitura_t *) contexto;
+    historico_registro_t esperado;
+
+    preenche(&esperado, r->lote);
+    esperado.crc = r->crc;
+    l->campos_errados += memcmp(r, &esperado, sizeof(*r)) != 0;
+    l->lidos[l->n++] = r->lote;
+
+    return l->n < SETORES * POR_SETOR;
+}
+
+// reparte (relê a flash do zero) e confere os lotes de..ate-1 em ordem,
+// menos os pulados
+static void confere_anel(uint32_t de, uint32_t ate, uint32_t pulado)
+{
+    static leitura_t l;
+    historico_estatisticas_t e;
+    uint32_t k = 0;
+
+    CONFERE(historico_inicia(), "partida");
+    historico_estatisticas(&e);
+
+    memset(&l, 0, sizeof(l));
+    historico_percorre(visita, &l);
+
+    CONFERE(e.registros == l.n, "%u registros contados, %u percorridos", e.registros, l.n);
+    CONFERE(l.campos_errados == 0, "%u registros com campos errados", l.campos_errados);
+
+    for (uint32_t lote = de; lote < ate; lote++)
+    {
+        if (lote == pulado)
+        {
+            continue;
+        }
+        if (k >= l.n || l.lidos[k] != lote)
+        {
+            CONFERE(false, "posição %u: lote %u, esperado %u", k, k < l.n ? l.lidos[k] : 0, lote);
+            return;
+        }
+        k++;
+    }
+    CONFERE(k == l.n, "%u registros além do esperado", l.n - k);
+}
+
+int main(void)
+{
+    // partição virgem: formata e não acha nada
+    memset(flash, 0xFF, sizeof(flash));
+    confere_anel(0, 0, UINT32_MAX);
+
+    // releitura depois da partida, sem volta do anel
+    acrescenta(0, 250);
+    confere_anel(0, 250, UINT32_MAX);
+
+    // volta do anel: o setor mais antigo é apagado inteiro, então ficam entre
+    // três e quatro setores dos mais novos
+    acrescenta(250, 1000);
+    {
+        historico_estatisticas_t e;
+
+        confere_anel(1000 - (SETORES - 1) * POR_SETOR - (1000 % POR_SETOR), 1000, UINT32_MAX);
+        historico_estatisticas(&e);
+        CONFERE(e.registros > (SETORES - 1) * POR_SETOR && e.registros <= SETORES * POR_SETOR,
+                "%u registros no anel", e.registros);
+    }
+
+    // um bit trocado no meio: só aquele registro some
+    {
+        leitura_t *l = calloc(1, sizeof(*l));
+        uint8_t *alvo = NULL;
+
+        historico_percorre(visita, l);
+        for (size_t s = 0; s < SETORES; s++)
+        {
+            for (size_t i = 1; i <= POR_SETOR; i++)
+            {
+                uint8_t *r = flash + s * SPI_FLASH_SEC_SIZE + i * HISTORICO_REGISTRO;
+
+                if (((historico_registro_t *) r)->lote == l->lidos[l->n / 2])
+                {
+                    alvo = r + offsetof(historico_registro_t, peso_total);
+                }
+            }
+        }
+        CONFERE(alvo != NULL, "registro a corromper não achado");
+        if (alvo != NULL)
+        {
+            *alvo ^= 0x10;
+            confere_anel(l->lidos[0], 1000, l->lidos[l->n / 2]);
+        }
+        free(l);
+    }
+
+    // queda de energia no meio da gravação: só o número do lote chegou à
+    // flash; na partida o registro é pulado e a escrita segue depois dele
+    memset(flash, 0xFF, sizeof(flash));
+    confere_anel(0, 0, UINT32_MAX);
+    acrescenta(0, 40);
+    {
+        historico_registro_t r;
+
+        preenche(&r, 40);
+        esp_partition_write(&particao, 41 * HISTORICO_REGISTRO, &r, sizeof(r.lote));
+    }
+    confere_anel(0, 40, UINT32_MAX);
+    acrescenta(41, 60);
+    confere_anel(0, 60, 40);
+
+    // queda no meio do apagamento do setor seguinte: o cabeçalho dele se foi
+    // e parte dos registros também; a partida volta ao setor cheio e o
+    // próximo acréscimo reabre o setor quebrado
+    memset(flash, 0xFF, sizeof(flash));
+    confere_anel(0, 0, UINT32_MAX);
+    acrescenta(0, SETORES * POR_SETOR);
+    memset(flash, 0xFF, SPI_FLASH_SEC_SIZE / 2);
+    confere_anel(POR_SETOR, SETORES * POR_SETOR, UINT32_MAX);
+    acrescenta(SETORES * POR_SETOR, SETORES * POR_SETOR + 10);
+    confere_anel(POR_SETOR, SETORES * POR_SETOR + 10, UINT32_MAX);
+
+    TESTE_FIM();
+}
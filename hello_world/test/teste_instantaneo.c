@@ -0,0 +1,189 @@
+/*
+Arquivo: teste_instantaneo.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Tortura do seqlock do instantâneo: uma thread por esteira,
+        uma de lotes e uma de taxas escrevendo sem parar enquanto
+        vários leitores conferem que nenhuma cópia sai rasgada.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <sys/time.h>
+#include "teste.h"
+#include "instantaneo.h"
+
+#define PRODUTOS_POR_ESTEIRA 300000u
+#define LEITORES 4
+
+static volatile bool parar;
+
+// preempção forçada a cada 50 us em qualquer ponto de qualquer thread,
+// para os leitores pegarem escritores no meio da escrita mesmo num core só
+static void preempta(int sinal)
+{
+    sched_yield();
+}
+
+// cópias com defeito, por invariante (só somadas no fim)
+typedef struct
+{
+    uint32_t copias;
+    uint32_t rasgadas;          // soma das contagens != total
+    uint32_t lote_rasgado;      // total do lote fora do par (lote, total)
+    uint32_t taxas_rasgadas;    // taxas de escritas diferentes misturadas
+    uint32_t voltou;            // alguma contagem ou lote andou para trás
+} leitor_t;
+
+static void *esteira(void *arg)
+{
+    int k = (int) (intptr_t) arg;
+
+    for (uint32_t i = 1; i <= PRODUTOS_POR_ESTEIRA; i++)
+    {
+        instantaneo_produto(k, (int) (i % 200));
+    }
+
+    return NULL;
+}
+
+// o total de cada lote é função do número: a cópia tem que trazer o par
+static void *lotes(void *arg)
+{
+    for (uint32_t n = 1; !parar; n++)
+    {
+        instantaneo_lote(n, 0.5f * (n % 1000));
+    }
+
+    return NULL;
+}
+
+// todas as taxas de uma escrita são iguais
+static void *taxas(void *arg)
+{
+    float t[NUM_ESTEIRAS];
+
+    for (uint32_t n = 1; !parar; n++)
+    {
+        for (int k = 0; k < NUM_ESTEIRAS; k++)
+        {
+            t[k] = (float) (n % 100000);
+        }
+        instantaneo_taxas(t);
+    }
+
+    return NULL;
+}
+
+static void *leitor(void *arg)
+{
+    leitor_t *l = (leitor_t *) arg;
+    instantaneo_t copia, anterior = {0};
+
+    while (!parar)
+    {
+        instantaneo_le(&copia);
+        l->copias++;
+
+        if (!instantaneo_consistente(&copia))
+        {
+            l->rasgadas++;
+        }
+        if (copia.ultimo_total != 0.5f * (copia.lote % 1000))
+        {
+            l->lote_rasgado++;
+        }
+        for (int k = 1; k < NUM_ESTEIRAS; k++)
+        {
+            if (copia.taxa[k] != copia.taxa[0])
+            {
+                l->taxas_rasgadas++;
+                break;
+            }
+        }
+        for (int k = 0; k < NUM_ESTEIRAS; k++)
+        {
+            if (copia.contagem[k] < anterior.contagem[k])
+            {
+                l->voltou++;
+                break;
+            }
+        }
+        if (copia.lote < anterior.lote)
+        {
+            l->voltou++;
+        }
+        anterior = copia;
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t escritores[NUM_ESTEIRAS], lote, taxa, leitores[LEITORES];
+    leitor_t estado[LEITORES] = {0};
+    instantaneo_t final;
+    leitor_t soma = {0};
+    struct itimerval intervalo = {{0, 50}, {0, 50}};
+
+    signal(SIGALRM, preempta);
+    setitimer(ITIMER_REAL, &intervalo, NULL);
+
+    for (int i = 0; i < LEITORES; i++)
+    {
+        pthread_create(&leitores[i], NULL, leitor, &estado[i]);
+    }
+    pthread_create(&lote, NULL, lotes, NULL);
+    pthread_create(&taxa, NULL, taxas, NULL);
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        pthread_create(&escritores[k], NULL, esteira, (void *) (intptr_t) k);
+    }
+
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        pthread_join(escritores[k], NULL);
+    }
+    parar = true;
+    setitimer(ITIMER_REAL, &(struct itimerval) {{0, 0}, {0, 0}}, NULL);
+    pthread_join(lote, NULL);
+    pthread_join(taxa, NULL);
+
+    for (int i = 0; i < LEITORES; i++)
+    {
+        pthread_join(leitores[i], NULL);
+        soma.copias += estado[i].copias;
+        soma.rasgadas += estado[i].rasgadas;
+        soma.lote_rasgado += estado[i].lote_rasgado;
+        soma.taxas_rasgadas += estado[i].taxas_rasgadas;
+        soma.voltou += estado[i].voltou;
+    }
+
+    printf("%u cópias lidas durante %u produtos\n", soma.copias,
+           NUM_ESTEIRAS * PRODUTOS_POR_ESTEIRA);
+
+    CONFERE(soma.copias > 0, "nenhuma cópia lida");
+    CONFERE(soma.rasgadas == 0, "%u cópias com contagens rasgadas", soma.rasgadas);
+    CONFERE(soma.lote_rasgado == 0, "%u cópias com lote rasgado", soma.lote_rasgado);
+    CONFERE(soma.taxas_rasgadas == 0, "%u cópias com taxas rasgadas", soma.taxas_rasgadas);
+    CONFERE(soma.voltou == 0, "%u cópias voltaram no tempo", soma.voltou);
+
+    // nenhuma escrita perdida
+    instantaneo_le(&final);
+    CONFERE(final.produtos_total == NUM_ESTEIRAS * PRODUTOS_POR_ESTEIRA, "total %u",
+            final.produtos_total);
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        CONFERE(final.contagem[k] == PRODUTOS_POR_ESTEIRA, "esteira %d: %u", k, final.contagem[k]);
+    }
+
+    TESTE_FIM();
+}
@@ -0,0 +1,253 @@
+/*
+Arquivo: teste_log.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Teste do anel MPMC do log diferido com threads: quatro
+        produtores a 10k msgs/s somados e a tarefa de log esvaziando,
+        depois rajadas que enchem o anel. Cada mensagem sai uma vez só,
+        na ordem do seu produtor, ou entra na contagem de descartadas,
+        e os avisos de descarte somam exatamente essa contagem.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "teste.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "formato.h"
+#include "log_diferido.h"
+
+#define PRODUTORES 4
+#define TAXA_TOTAL 10000
+#define SEGUNDOS 2
+
+// cada produtor manda um pacote a cada 2 ms
+#define PACOTE_US 2000
+#define PACOTE (TAXA_TOTAL / PRODUTORES * PACOTE_US / 1000000)
+
+// mensagens por rajada de cada produtor na fase que enche o anel
+#define RAJADA 2000
+#define RAJADAS 5
+
+#define ENVIADAS_MAX (TAXA_TOTAL / PRODUTORES * SEGUNDOS + RAJADA * RAJADAS)
+
+// tempo que o anel segura a TAXA_TOTAL sem esvaziar
+#define FOLGA_US ((int64_t) LOG_TAMANHO * 1000000 / TAXA_TOTAL)
+
+// UART falsa: guarda as linhas que a tarefa de log escreve e o maior
+// intervalo entre duas escritas (o host pode parar a tarefa de log)
+static pthread_mutex_t trava_uart = PTHREAD_MUTEX_INITIALIZER;
+static char transmitido[8 << 20];
+static size_t num_transmitido;
+static int64_t ultima_escrita;
+static int64_t maior_intervalo;
+
+esp_err_t uart_driver_install(uart_port_t porta, int rx, int tx, int fila, void *handle, int flags)
+{
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t porta, const char *dados, size_t n)
+{
+    pthread_mutex_lock(&trava_uart);
+    int64_t agora = esp_timer_get_time();
+    if (ultima_escrita != 0 && agora - ultima_escrita > maior_intervalo)
+    {
+        maior_intervalo = agora - ultima_escrita;
+    }
+    ultima_escrita = agora;
+    if (num_transmitido + n < sizeof(transmitido))
+    {
+        memcpy(&transmitido[num_transmitido], dados, n);
+        num_transmitido += n;
+    }
+    pthread_mutex_unlock(&trava_uart);
+
+    return n;
+}
+
+static volatile uint32_t enviadas[PRODUTORES];
+static volatile bool rajadas;
+static char principal;
+
+static void dorme_ate(struct timespec *t, long ns)
+{
+    t->tv_nsec += ns;
+    t->tv_sec += t->tv_nsec / 1000000000;
+    t->tv_nsec %= 1000000000;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, t, NULL);
+}
+
+// argumento: produtor * 10^6 + número da mensagem
+static void produtor(void *parametro)
+{
+    int p = (int) (intptr_t) parametro;
+    uint32_t k = 0;
+    struct timespec t;
+
+    // TAXA_TOTAL / PRODUTORES por segundo, como as esteiras: espalhado
+    // no tempo, não em rajadas de um tick
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    for (int n = 0; n < SEGUNDOS * 1000000 / PACOTE_US; n++)
+    {
+        for (int j = 0; j < PACOTE; j++)
+        {
+            LOG_DIF(MSG_TESTE, LOG_U(p * 1000000 + k++));
+        }
+        enviadas[p] = k;
+        dorme_ate(&t, PACOTE_US * 1000);
+    }
+
+    // sem pausa: bem mais que o anel entre dois esvaziamentos
+    while (!rajadas)
+    {
+        vTaskDelay(1);
+    }
+    for (int r = 0; r < RAJADAS; r++)
+    {
+        for (int j = 0; j < RAJADA; j++)
+        {
+            LOG_DIF(MSG_TESTE, LOG_U(p * 1000000 + k++));
+        }
+        enviadas[p] = k;
+        vTaskDelay(LOG_PERIODO_MS / portTICK_PERIOD_MS);
+    }
+
+    xTaskNotifyGive(&principal);
+    vTaskDelete(NULL);
+}
+
+// espera a tarefa de log escrever tudo o que está no anel
+static void espera_esvaziar(void)
+{
+    size_t antes;
+
+    do
+    {
+        pthread_mutex_lock(&trava_uart);
+        antes = num_transmitido;
+        pthread_mutex_unlock(&trava_uart);
+        vTaskDelay(4 * LOG_PERIODO_MS / portTICK_PERIOD_MS);
+    } while (antes != num_transmitido);
+}
+
+typedef struct
+{
+    uint32_t entregues;
+    uint32_t repetidas;
+    uint32_t fora_de_ordem;
+    uint32_t avisadas;
+} conferencia_t;
+
+// cada linha "teste N" uma vez, crescente por produtor; soma os avisos
+static conferencia_t confere_saida(void)
+{
+    static uint8_t vistas[PRODUTORES][ENVIADAS_MAX];
+    int64_t ultima[PRODUTORES];
+    conferencia_t r = {0, 0, 0, 0};
+    char *linha = transmitido;
+
+    memset(vistas, 0, sizeof(vistas));
+    for (int p = 0; p < PRODUTORES; p++)
+    {
+        ultima[p] = -1;
+    }
+
+    transmitido[num_transmitido] = '\0';
+    while (*linha != '\0')
+    {
+        char *fim = strchr(linha, '\n');
+        unsigned long n;
+
+        if (sscanf(linha, "teste %lu", &n) == 1 && n / 1000000 < PRODUTORES &&
+            n % 1000000 < ENVIADAS_MAX)
+        {
+            int p = n / 1000000;
+            uint32_t k = n % 1000000;
+
+            r.entregues++;
+            r.repetidas += vistas[p][k]++ > 0;
+            r.fora_de_ordem += (int64_t) k <= ultima[p];
+            ultima[p] = k;
+        } else if (sscanf(linha, "Log: %lu mensagens descartadas", &n) == 1)
+        {
+            r.avisadas += n;
+        }
+
+        linha = fim != NULL ? fim + 1 : linha + strlen(linha);
+    }
+
+    return r;
+}
+
+int main(void)
+{
+    uint32_t total = 0;
+    conferencia_t r;
+
+    hospedeiro_tarefa(&principal);
+    CONFERE(log_inicia(), "tarefa de log não criada");
+
+    for (int p = 0; p < PRODUTORES; p++)
+    {
+        xTaskCreate(produtor, "produtor", 2048, (void *) (intptr_t) p, 1, NULL);
+    }
+
+    // 10k msgs/s somados: a tarefa de log dá conta sem descartar
+    vTaskDelay((SEGUNDOS * 1000 + 100) / portTICK_PERIOD_MS);
+    pthread_mutex_lock(&trava_uart);
+    int64_t intervalo = maior_intervalo;
+    pthread_mutex_unlock(&trava_uart);
+    espera_esvaziar();
+    r = confere_saida();
+    for (int p = 0; p < PRODUTORES; p++)
+    {
+        total += enviadas[p];
+    }
+    printf("%u msgs/s em %d produtores: %u enviadas, %u entregues, %u descartadas, "
+           "esvaziamentos a até %lld us\n", TAXA_TOTAL, PRODUTORES, total, r.entregues,
+           log_descartadas(), (long long) intervalo);
+    CONFERE(total == TAXA_TOTAL * SEGUNDOS, "%u enviadas", total);
+    CONFERE(r.entregues + log_descartadas() == total && r.repetidas == 0,
+            "%u entregues + %u descartadas != %u", r.entregues, log_descartadas(), total);
+
+    // descarte só se o host segurou a tarefa de log além do que o anel aguenta
+    CONFERE(log_descartadas() == 0 || intervalo > FOLGA_US,
+            "%u descartadas com esvaziamentos a até %lld us (folga %lld us)", log_descartadas(),
+            (long long) intervalo, (long long) FOLGA_US);
+
+    // rajadas: o anel enche, o que não entra é contado e avisado
+    rajadas = true;
+    for (int p = 0; p < PRODUTORES; p++)
+    {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+    espera_esvaziar();
+    r = confere_saida();
+    total = 0;
+    for (int p = 0; p < PRODUTORES; p++)
+    {
+        total += enviadas[p];
+    }
+    printf("rajadas: %u enviadas, %u entregues, %u descartadas, %u avisadas\n", total, r.entregues,
+           log_descartadas(), r.avisadas);
+
+    CONFERE(log_descartadas() > 0, "rajadas de %d sem descarte", PRODUTORES * RAJADA);
+    CONFERE(r.entregues + log_descartadas() == total, "%u entregues + %u descartadas != %u",
+            r.entregues, log_descartadas(), total);
+    CONFERE(r.avisadas == log_descartadas(), "avisos somam %u, contador %u", r.avisadas,
+            log_descartadas());
+    CONFERE(r.repetidas == 0 && r.fora_de_ordem == 0, "%u repetidas, %u fora de ordem",
+            r.repetidas, r.fora_de_ordem);
+    CONFERE(formato_descartadas() == 0, "%u escritas perdidas na UART falsa", formato_descartadas());
+
+    TESTE_FIM();
+}
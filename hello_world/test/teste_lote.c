@@ -0,0 +1,256 @@
+/*
+Arquivo: teste_lote.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da passagem dos lotes entre os estágios pelas filas:
+        pool esgotado com e sem espera, o preenchimento acordado quando
+        o relatório devolve um buffer, e 20000 lotes pelas tarefas de
+        redução e relatório sem perda, repetição ou troca de ordem.
+        Também os p1/p50/p99 exatos do lote contra a ordenação direta
+        dos pesos com desvio, e o esboço do turno recebendo todos.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "lote.h"
+
+#define LOTES 20000
+
+// espera dos testes que podem travar (10 s)
+#define ESPERA_MAX (10000 / portTICK_PERIOD_MS)
+
+static char principal;
+static lote_t *recebido;
+
+static void espera_livre(void *parametro)
+{
+    recebido = lote_obtem_livre(portMAX_DELAY);
+    xTaskNotifyGive(&principal);
+    vTaskDelete(NULL);
+}
+
+static void testa_esgotamento(void)
+{
+    lote_t *lotes[LOTE_NUM_BUFFERS];
+    bool distintos = true;
+
+    for (int i = 0; i < LOTE_NUM_BUFFERS; i++)
+    {
+        lotes[i] = lote_obtem_livre(0);
+        for (int j = 0; j < i; j++)
+        {
+            distintos &= lotes[i] != lotes[j];
+        }
+    }
+    CONFERE(distintos && lotes[LOTE_NUM_BUFFERS - 1] != NULL, "pool sem %d buffers distintos",
+            LOTE_NUM_BUFFERS);
+
+    // pool vazio: sem espera volta na hora, com espera vence o prazo
+    CONFERE(lote_obtem_livre(0) == NULL, "buffer além do pool");
+
+    int64_t inicio = esp_timer_get_time();
+    CONFERE(lote_obtem_livre(3) == NULL, "buffer além do pool com espera");
+    int64_t esperou = esp_timer_get_time() - inicio;
+    CONFERE(esperou >= 3 * portTICK_PERIOD_MS * 1000, "esperou só %lld us", (long long) esperou);
+
+    // o buffer devolvido volta zerado
+    lotes[0]->num_produtos = 7;
+    lotes[0]->peso_total = 1;
+    lotes[0]->contagem_classe[0] = 3;
+    lote_libera(lotes[0]);
+    lotes[0] = lote_obtem_livre(0);
+    CONFERE(lotes[0] != NULL && lotes[0]->num_produtos == 0 && lotes[0]->peso_total == 0 &&
+            lotes[0]->contagem_classe[0] == 0, "buffer devolvido sem zerar");
+
+    // quem espera o pool vazio acorda quando o relatório libera um
+    recebido = NULL;
+    CONFERE(xTaskCreate(espera_livre, "espera", 2048, NULL, 1, NULL) == pdPASS, "tarefa não criada");
+    vTaskDelay(2);
+    CONFERE(recebido == NULL, "buffer entregue com o pool vazio");
+    lote_libera(lotes[1]);
+    CONFERE(ulTaskNotifyTake(pdTRUE, ESPERA_MAX) == 1 && recebido == lotes[1],
+            "preenchimento não acordou com o buffer liberado");
+    lotes[1] = recebido;
+
+    for (int i = 0; i < LOTE_NUM_BUFFERS; i++)
+    {
+        lote_libera(lotes[i]);
+    }
+}
+
+static uint32_t estado_aleatorio = 2463534242u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// lotes de tamanhos variados com três classes e desvios de até ±150 g:
+// os quantis têm que ser exatamente os do posto mais próximo
+static void testa_quantis(void)
+{
+    static const int tamanhos[] = {0, 1, 2, 3, 99, 100, 101, NUM_MAX_PROD};
+    static const int percentis[LOTE_NUM_QUANTIS] = {1, 50, 99};
+    static lote_t lote;
+    static quantil_t turno;
+    static float ref[NUM_MAX_PROD];
+    int classes[3] = {lote_classe(5.0f), lote_classe(2.0f), lote_classe(0.5f)};
+    uint32_t produtos = 0;
+    int errados = 0;
+
+    quantil_inicia(&turno, 1);
+    for (size_t t = 0; t < sizeof(tamanhos) / sizeof(tamanhos[0]); t++)
+    {
+        int n = tamanhos[t];
+
+        memset(&lote, 0, sizeof(lote));
+        lote.num_produtos = n;
+        for (int i = 0; i < n; i++)
+        {
+            int c = classes[aleatorio() % 3];
+
+            lote_insere(&lote, i, c, (float) ((int) (aleatorio() % 301) - 150) / 1000);
+            ref[i] = lote_peso_classe(c) + (float) lote_desvio(&lote, i) / LOTE_ESCALA_DESVIO;
+        }
+
+        // referência: inserção direta, sem o qsort do lote
+        for (int i = 1; i < n; i++)
+        {
+            float x = ref[i];
+            int j = i;
+
+            for (; j > 0 && ref[j - 1] > x; j--)
+            {
+                ref[j] = ref[j - 1];
+            }
+            ref[j] = x;
+        }
+
+        lote_quantis(&lote, &turno);
+        produtos += n;
+        for (int j = 0; j < LOTE_NUM_QUANTIS; j++)
+        {
+            int posto = (percentis[j] * n + 99) / 100;
+            float esperado = n == 0 ? 0 : ref[posto < 1 ? 0 : posto - 1];
+
+            errados += lote.quantis[j] != esperado;
+        }
+
+        // o turno acumula todos os pesos e fica ordenado entre min e max
+        CONFERE(lote.produtos_turno == produtos && turno.n == produtos,
+                "turno com %u produtos, %u esperados", lote.produtos_turno, produtos);
+        CONFERE(produtos == 0 || (lote.quantis_turno[0] <= lote.quantis_turno[1] &&
+                lote.quantis_turno[1] <= lote.quantis_turno[2] && lote.quantis_turno[0] >= 0.35f &&
+                lote.quantis_turno[2] <= 5.15f), "quantis do turno %.3f %.3f %.3f",
+                (double) lote.quantis_turno[0], (double) lote.quantis_turno[1],
+                (double) lote.quantis_turno[2]);
+    }
+
+    CONFERE(errados == 0, "%d quantis diferentes da ordenação direta", errados);
+}
+
+// redução e relatório como no firmware, conferindo a ordem em cada estágio
+static volatile int fora_de_ordem_reducao;
+static volatile int fora_de_ordem_relatorio;
+static volatile int totais_errados;
+
+static void reducao(void *parametro)
+{
+    for (uint32_t esperado = 0; esperado < LOTES; esperado++)
+    {
+        lote_t *lote = lote_aguarda_reducao();
+
+        fora_de_ordem_reducao += lote->numero != esperado;
+        lote->peso_total = lote_total(lote);
+        lote_envia_relatorio(lote);
+    }
+    vTaskDelete(NULL);
+}
+
+static void relatorio(void *parametro)
+{
+    for (uint32_t esperado = 0; esperado < LOTES; esperado++)
+    {
+        lote_t *lote = lote_aguarda_relatorio();
+        int n = (int) (esperado % NUM_MAX_PROD) + 1;
+
+        fora_de_ordem_relatorio += lote->numero != esperado;
+        totais_errados += lote->num_produtos != n || lote->peso_total != n * 2.0f;
+        lote_libera(lote);
+    }
+    xTaskNotifyGive(&principal);
+    vTaskDelete(NULL);
+}
+
+static void testa_ordem(void)
+{
+    int classe = lote_classe(2.0f);
+    int cheios = 0;
+
+    CONFERE(xTaskCreate(reducao, "reducao", 2048, NULL, 2, NULL) == pdPASS &&
+            xTaskCreate(relatorio, "relatorio", 2048, NULL, 1, NULL) == pdPASS, "tarefas não criadas");
+
+    // o preenchimento roda aqui: às vezes acha o pool vazio e espera
+    for (uint32_t numero = 0; numero < LOTES; numero++)
+    {
+        lote_t *lote = lote_obtem_livre(0);
+
+        if (lote == NULL)
+        {
+            cheios++;
+            lote = lote_obtem_livre(ESPERA_MAX);
+        }
+        if (lote == NULL)
+        {
+            CONFERE(false, "lote %u sem buffer", numero);
+            return;
+        }
+
+        lote->numero = numero;
+        lote->num_produtos = (int) (numero % NUM_MAX_PROD) + 1;
+        for (int i = 0; i < lote->num_produtos; i++)
+        {
+            lote_insere(lote, i, classe, 0);
+        }
+        lote_envia_reducao(lote);
+    }
+
+    CONFERE(ulTaskNotifyTake(pdTRUE, ESPERA_MAX) == 1, "relatório não chegou ao último lote");
+    CONFERE(fora_de_ordem_reducao == 0 && fora_de_ordem_relatorio == 0,
+            "%d lotes fora de ordem na redução, %d no relatório", fora_de_ordem_reducao,
+            fora_de_ordem_relatorio);
+    CONFERE(totais_errados == 0, "%d lotes com conteúdo trocado", totais_errados);
+
+    // todos os buffers voltaram ao pool
+    for (int i = 0; i < LOTE_NUM_BUFFERS; i++)
+    {
+        CONFERE(lote_obtem_livre(0) != NULL, "buffer %d não voltou", i);
+    }
+    CONFERE(lote_obtem_livre(0) == NULL, "buffer a mais no pool");
+
+    printf("%d lotes pelas filas, pool vazio %d vezes no preenchimento\n", LOTES, cheios);
+}
+
+int main(void)
+{
+    hospedeiro_tarefa(&principal);
+
+    CONFERE(lote_inicia_pipeline(), "filas não criadas");
+
+    testa_esgotamento();
+    testa_quantis();
+    testa_ordem();
+
+    TESTE_FIM();
+}
@@ -0,0 +1,108 @@
+/*
+Arquivo: teste_metricas.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes das métricas de vazão: massa exata depois de milhões de
+        produtos leves, volta dos contadores de 32 bits e janela que
+        não acumula erro entre atualizações.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include "teste.h"
+#include "metricas.h"
+
+static void testa_massa(void)
+{
+    metricas_esteira_t m;
+    const uint32_t produtos = 20000000;     // 10 t de produtos de 0,5 kg
+
+    metricas_inicia(&m, 100);
+
+    for (uint32_t k = 0; k < produtos; k++)
+    {
+        metricas_produto(&m, 0.5f);
+        if (k % 1000000 == 999999)
+        {
+            metricas_atualiza(&m, 1, 2000000);
+        }
+    }
+    metricas_atualiza(&m, 1, 2000000);
+
+    // somando em float, 0,5 kg some no total a partir de 8,4 t
+    CONFERE(m.massa == produtos * 0.5, "massa %.3f kg", m.massa);
+    CONFERE(m.contagem == produtos, "contagem %u", m.contagem);
+}
+
+static void testa_volta(void)
+{
+    metricas_esteira_t m;
+
+    // contadores a 10 produtos da volta: o delta atravessa sem sentir
+    metricas_inicia(&m, 100);
+    m.contagem = m.contagem_anterior = 0xFFFFFFF6u;
+    m.gramas = m.gramas_anterior = 0xFFFFFFFFu - 2499;
+
+    for (int k = 0; k < 20; k++)
+    {
+        metricas_produto(&m, 0.5f);
+    }
+    metricas_atualiza(&m, 1, 1000000);
+
+    CONFERE(m.contagem == 10, "contagem %u", m.contagem);
+    CONFERE(m.taxa_ewma == 20.0f, "taxa %.3f", m.taxa_ewma);
+    CONFERE(m.massa == 10.0, "massa %.3f", m.massa);
+    CONFERE(m.massa_ewma == 10.0f, "kg/s %.3f", m.massa_ewma);
+}
+
+static void testa_janela(void)
+{
+    metricas_esteira_t m;
+
+    metricas_inicia(&m, 100);
+
+    // dez mil atualizações de vazões variadas; a janela tem que ser a
+    // média exata das METRICAS_JANELA últimas, como se recalculada do zero
+    for (int a = 0; a < 10000; a++)
+    {
+        for (int k = 0; k < a % 37; k++)
+        {
+            metricas_produto(&m, 0.1f + 0.013f * (a % 11));
+        }
+        metricas_atualiza(&m, 1, 1000000);
+    }
+
+    uint32_t produtos = 0, gramas = 0;
+
+    for (int a = 10000 - METRICAS_JANELA; a < 10000; a++)
+    {
+        produtos += a % 37;
+        gramas += (a % 37) * (uint32_t) ((0.1f + 0.013f * (a % 11)) * 1000.0f + 0.5f);
+    }
+
+    CONFERE(m.taxa_janela == produtos / (float) METRICAS_JANELA, "taxa %.4f, esperada %.4f",
+            m.taxa_janela, produtos / (float) METRICAS_JANELA);
+    CONFERE(fabsf(m.massa_janela - gramas / 1000.0f / METRICAS_JANELA) < 1e-5f,
+            "kg/s %.6f, esperado %.6f", m.massa_janela, gramas / 1000.0f / METRICAS_JANELA);
+
+    // vazão que zera: a janela esvazia de fato depois de METRICAS_JANELA intervalos
+    for (int a = 0; a < METRICAS_JANELA; a++)
+    {
+        metricas_atualiza(&m, 1, 1000000);
+    }
+    CONFERE(m.taxa_janela == 0 && m.massa_janela == 0, "janela vazia %.6f %.6f",
+            m.taxa_janela, m.massa_janela);
+}
+
+int main(void)
+{
+    testa_massa();
+    testa_volta();
+    testa_janela();
+
+    TESTE_FIM();
+}
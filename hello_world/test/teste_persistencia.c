@@ -0,0 +1,297 @@
+/*
+Arquivo: teste_persistencia.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes do checkpoint com uma NVS falsa em RAM e relógio
+        simulado: commits agrupados por lotes e por prazo, gravação
+        que falha no meio deixando o checkpoint anterior, blob ausente,
+        de outro tamanho ou de outra versão ignorado, e a partida
+        seguinte restaurando só o que foi gravado.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "persistencia.h"
+
+// NVS falsa: um blob gravado (o que sobrevive ao reinício) e um escrito
+// ainda sem commit
+static uint8_t gravado[2 * sizeof(checkpoint_t)];
+static size_t tamanho_gravado = 0;
+static uint8_t escrito[2 * sizeof(checkpoint_t)];
+static size_t tamanho_escrito = 0;
+static bool nvs_disponivel = true;
+static bool falha_escrita = false;
+static uint32_t commits = 0;
+
+esp_err_t nvs_open(const char *nome, nvs_open_mode_t modo, nvs_handle_t *handle)
+{
+    *handle = 1;
+    return nvs_disponivel ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+// a NVS grava cada entrada com CRC: faltar energia no meio deixa a anterior
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *chave, const void *valor, size_t tamanho)
+{
+    if (falha_escrita)
+    {
+        return ESP_FAIL;
+    }
+    if (strcmp(chave, "checkpoint") != 0 || tamanho > sizeof(escrito))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memcpy(escrito, valor, tamanho);
+    tamanho_escrito = tamanho;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *chave, void *valor, size_t *tamanho)
+{
+    if (strcmp(chave, "checkpoint") != 0 || tamanho_gravado == 0)
+    {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    if (*tamanho < tamanho_gravado)
+    {
+        *tamanho = tamanho_gravado;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    memcpy(valor, gravado, tamanho_gravado);
+    *tamanho = tamanho_gravado;
+
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    memcpy(gravado, escrito, tamanho_escrito);
+    tamanho_gravado = tamanho_escrito;
+    commits++;
+
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+}
+
+static int64_t agora = 1000000;
+
+static void avanca_ms(uint32_t ms)
+{
+    agora += (int64_t) ms * 1000;
+    hospedeiro_relogio(agora);
+}
+
+// reinicia: a RAM some, só o blob gravado fica
+static bool reinicia(checkpoint_t *restaurado)
+{
+    tamanho_escrito = 0;
+    avanca_ms(3000);
+
+    return persistencia_inicia(restaurado);
+}
+
+static void estado_do_lote(checkpoint_t *c, uint32_t lotes)
+{
+    memset(c, 0, sizeof(*c));
+    c->lotes = lotes;
+    for (int i = 0; i < NUM_ESTEIRAS; i++)
+    {
+        c->contagem[i] = lotes * 67 + i;
+        c->massa[i] = lotes * 1.25 + i;
+    }
+    c->peso_acumulado = lotes * 100.5;
+    c->ultimo_total = 100.5f;
+}
+
+static bool igual(const checkpoint_t *a, const checkpoint_t *b)
+{
+    return a->lotes == b->lotes && memcmp(a->contagem, b->contagem, sizeof(a->contagem)) == 0 &&
+           memcmp(a->massa, b->massa, sizeof(a->massa)) == 0 &&
+           a->peso_acumulado == b->peso_acumulado && a->ultimo_total == b->ultimo_total;
+}
+
+// primeira partida e NVS que não abre
+static void testa_sem_checkpoint(void)
+{
+    checkpoint_t restaurado, estado;
+    persistencia_estatisticas_t e;
+
+    hospedeiro_relogio(agora);
+
+    nvs_disponivel = false;
+    CONFERE(!reinicia(&restaurado), "NVS indisponível abriu");
+    estado_do_lote(&estado, 4);
+    CONFERE(!persistencia_atualiza(&estado) && !persistencia_grava() && commits == 0,
+            "gravou sem NVS");
+    nvs_disponivel = true;
+
+    // NVS vazia: tudo zerado, versão atual
+    CONFERE(reinicia(&restaurado), "NVS não abriu");
+    persistencia_estatisticas(&e);
+    CONFERE(!e.restaurado && restaurado.lotes == 0 && restaurado.peso_acumulado == 0 &&
+            restaurado.versao == PERSISTENCIA_VERSAO, "checkpoint restaurado da NVS vazia");
+}
+
+// um commit a cada PERSISTENCIA_LOTES lotes ou PERSISTENCIA_PERIODO_MS
+static void testa_agrupamento(void)
+{
+    checkpoint_t restaurado, estado;
+    persistencia_estatisticas_t e;
+    uint32_t antes;
+    int gravados = 0;
+
+    reinicia(&restaurado);
+    antes = commits;
+
+    for (uint32_t lote = 1; lote <= 4 * PERSISTENCIA_LOTES; lote++)
+    {
+        avanca_ms(1000);
+        estado_do_lote(&estado, lote);
+        gravados += persistencia_atualiza(&estado);
+    }
+    CONFERE(gravados == 4 && commits - antes == 4, "%d commits em %d lotes, esperados 4",
+            commits - antes, 4 * PERSISTENCIA_LOTES);
+
+    // um lote a mais fica pendente até o prazo vencer
+    avanca_ms(1000);
+    estado_do_lote(&estado, 4 * PERSISTENCIA_LOTES + 1);
+    antes = commits;
+    CONFERE(!persistencia_atualiza(&estado) && !persistencia_periodica() && commits == antes,
+            "commit antes do prazo");
+    avanca_ms(PERSISTENCIA_PERIODO_MS);
+    CONFERE(persistencia_periodica() && commits == antes + 1, "prazo vencido sem commit");
+
+    // sem lote novo o prazo não grava de novo
+    avanca_ms(2 * PERSISTENCIA_PERIODO_MS);
+    CONFERE(!persistencia_periodica() && commits == antes + 1, "commit sem nada novo");
+
+    // lote lento: o prazo grava no próprio lote, antes de juntar PERSISTENCIA_LOTES
+    avanca_ms(PERSISTENCIA_PERIODO_MS);
+    estado_do_lote(&estado, 4 * PERSISTENCIA_LOTES + 2);
+    CONFERE(persistencia_atualiza(&estado) && commits == antes + 2, "prazo não gravou o lote");
+
+    persistencia_estatisticas(&e);
+    CONFERE(e.gravacoes == 6 && e.falhas == 0, "%u gravações, %u falhas", e.gravacoes, e.falhas);
+
+    // a partida seguinte volta exatamente ao último gravado
+    CONFERE(reinicia(&restaurado), "NVS não abriu");
+    persistencia_estatisticas(&e);
+    CONFERE(e.restaurado && igual(&restaurado, &estado), "restaurado o lote %u, gravado o %u",
+            restaurado.lotes, estado.lotes);
+}
+
+// o que não teve commit se perde; o reinício volta ao último gravado
+static void testa_reinicio(void)
+{
+    checkpoint_t restaurado, gravado_antes, estado;
+
+    reinicia(&restaurado);
+    gravado_antes = restaurado;
+
+    estado_do_lote(&estado, restaurado.lotes + 1);
+    CONFERE(!persistencia_atualiza(&estado), "um lote só gravou");
+    CONFERE(reinicia(&restaurado) && igual(&restaurado, &gravado_antes),
+            "restaurou o lote %u sem commit", restaurado.lotes);
+
+    // desligando pelo touch: o pendente é gravado na hora
+    estado_do_lote(&estado, restaurado.lotes + 1);
+    persistencia_atualiza(&estado);
+    CONFERE(persistencia_grava(), "gravação final falhou");
+    CONFERE(reinicia(&restaurado) && igual(&restaurado, &estado), "gravação final não restaurou");
+}
+
+// gravação interrompida: fica o anterior, e o pendente é tentado de novo
+static void testa_gravacao_interrompida(void)
+{
+    checkpoint_t restaurado, gravado_antes, estado;
+    persistencia_estatisticas_t e;
+
+    reinicia(&restaurado);
+    gravado_antes = restaurado;
+
+    falha_escrita = true;
+    estado_do_lote(&estado, restaurado.lotes + PERSISTENCIA_LOTES);
+    CONFERE(!persistencia_atualiza(&estado), "commit com a escrita falhando");
+    persistencia_estatisticas(&e);
+    CONFERE(e.falhas == 1 && e.gravacoes == 0, "%u falhas, %u gravações", e.falhas, e.gravacoes);
+
+    CONFERE(reinicia(&restaurado) && igual(&restaurado, &gravado_antes),
+            "gravação interrompida mudou o checkpoint");
+
+    // sujo continua sujo: o próximo lote tenta de novo e grava
+    estado_do_lote(&estado, restaurado.lotes + PERSISTENCIA_LOTES);
+    CONFERE(!persistencia_atualiza(&estado), "commit com a escrita falhando");
+    falha_escrita = false;
+    estado_do_lote(&estado, estado.lotes + 1);
+    CONFERE(persistencia_atualiza(&estado), "nova tentativa não gravou");
+    CONFERE(reinicia(&restaurado) && igual(&restaurado, &estado), "nova tentativa não restaurou");
+}
+
+// blob cortado, de outro tamanho ou de outra versão: começa do zero
+static void testa_blob_invalido(void)
+{
+    checkpoint_t restaurado, estado;
+    persistencia_estatisticas_t e;
+
+    estado_do_lote(&estado, 99);
+
+    // versão anterior do layout, mesmo tamanho
+    estado.versao = PERSISTENCIA_VERSAO - 1;
+    memcpy(gravado, &estado, sizeof(estado));
+    tamanho_gravado = sizeof(estado);
+    CONFERE(reinicia(&restaurado), "NVS não abriu");
+    persistencia_estatisticas(&e);
+    CONFERE(!e.restaurado && restaurado.lotes == 0 && restaurado.versao == PERSISTENCIA_VERSAO,
+            "versão %u aceita", PERSISTENCIA_VERSAO - 1);
+
+    // blob cortado: menor que o checkpoint
+    estado.versao = PERSISTENCIA_VERSAO;
+    memcpy(gravado, &estado, sizeof(estado));
+    tamanho_gravado = sizeof(estado) - 8;
+    reinicia(&restaurado);
+    persistencia_estatisticas(&e);
+    CONFERE(!e.restaurado && restaurado.lotes == 0, "blob cortado aceito");
+
+    // blob maior (layout de outro firmware): a leitura falha
+    tamanho_gravado = sizeof(estado) + 8;
+    reinicia(&restaurado);
+    persistencia_estatisticas(&e);
+    CONFERE(!e.restaurado && restaurado.lotes == 0, "blob maior aceito");
+
+    // blob ausente
+    tamanho_gravado = 0;
+    reinicia(&restaurado);
+    persistencia_estatisticas(&e);
+    CONFERE(!e.restaurado && restaurado.lotes == 0, "checkpoint sem blob");
+
+    // o primeiro commit depois do inválido grava a versão atual
+    estado_do_lote(&estado, PERSISTENCIA_LOTES);
+    CONFERE(persistencia_atualiza(&estado) && reinicia(&restaurado), "commit falhou");
+    persistencia_estatisticas(&e);
+    CONFERE(e.restaurado && igual(&restaurado, &estado), "checkpoint novo não restaurou");
+}
+
+int main(void)
+{
+    testa_sem_checkpoint();
+    testa_agrupamento();
+    testa_reinicio();
+    testa_gravacao_interrompida();
+    testa_blob_invalido();
+
+    hospedeiro_relogio_real();
+
+    TESTE_FIM();
+}
@@ -0,0 +1,163 @@
+/*
+Arquivo: teste_pesagem.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da detecção de produtos no sinal da célula de carga:
+        o benchmark de 3 e 64 esteiras (todo produto achado, com o
+        peso dentro da tolerância), o mesmo resultado com qualquer
+        tamanho de bloco, os produtos além do vetor de um bloco
+        contados, batida que não chega a assentar e deriva lenta da
+        tara.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "teste.h"
+#include "pesagem.h"
+
+#define AMOSTRAS (10 * PESAGEM_TAXA_HZ)
+#define MAX_PRODUTOS 256
+
+typedef struct
+{
+    pesagem_produto_t produtos[MAX_PRODUTOS];
+    int n;
+    pesagem_t p;
+} resultado_t;
+
+static float traco[AMOSTRAS];
+
+// produtos do gerador que chegam até margem amostras antes do fim do traço;
+// os das últimas 100 podem não ter assentado
+static int chegadas(const pesagem_gerador_t *g, uint32_t margem)
+{
+    return (AMOSTRAS - margem - g->fase - 1) / g->periodo + 1;
+}
+
+static bool todos(const resultado_t *r, const pesagem_gerador_t *g)
+{
+    return r->n >= chegadas(g, 100) && r->n <= chegadas(g, 0);
+}
+
+// processa o traço inteiro em blocos de tamanho bloco
+static void processa(resultado_t *r, int bloco)
+{
+    memset(r, 0, sizeof(*r));
+    pesagem_inicia(&r->p, PESAGEM_TAXA_HZ);
+
+    for (int b = 0; b < AMOSTRAS; b += bloco)
+    {
+        int k = AMOSTRAS - b < bloco ? AMOSTRAS - b : bloco;
+
+        r->n += pesagem_processa(&r->p, &traco[b], k, &r->produtos[r->n], MAX_PRODUTOS - r->n);
+    }
+}
+
+// o filtro e a detecção andam amostra a amostra: o bloco não muda nada
+static void testa_blocos(void)
+{
+    static resultado_t referencia, r;
+    const int blocos[] = {1, 7, 64, 65, 1000};
+    pesagem_gerador_t g;
+
+    pesagem_gerador_inicia(&g, PESAGEM_TAXA_HZ, 230, 11, 1.75f, 42);
+    pesagem_gera(&g, traco, AMOSTRAS);
+    processa(&referencia, PESAGEM_BLOCO);
+
+    CONFERE(todos(&referencia, &g), "%d produtos de %d", referencia.n, chegadas(&g, 0));
+    CONFERE(referencia.p.latencia_max < 100, "latência de %u amostras", referencia.p.latencia_max);
+
+    for (int i = 0; i < (int) (sizeof(blocos) / sizeof(blocos[0])); i++)
+    {
+        int iguais;
+
+        processa(&r, blocos[i]);
+        iguais = r.n == referencia.n &&
+                 memcmp(r.produtos, referencia.produtos, r.n * sizeof(r.produtos[0])) == 0;
+        CONFERE(iguais, "blocos de %d: %d produtos, diferentes dos blocos de %d", blocos[i], r.n,
+                PESAGEM_BLOCO);
+    }
+}
+
+// bloco com mais produtos assentados que o vetor: os de fora são contados
+static void testa_limite(void)
+{
+    static resultado_t referencia;
+    pesagem_produto_t produtos[PESAGEM_MAX_PRODUTOS];
+    pesagem_gerador_t g;
+    pesagem_t p;
+    int n;
+
+    pesagem_gerador_inicia(&g, PESAGEM_TAXA_HZ, 230, 11, 1.75f, 42);
+    pesagem_gera(&g, traco, AMOSTRAS);
+    processa(&referencia, PESAGEM_BLOCO);
+
+    pesagem_inicia(&p, PESAGEM_TAXA_HZ);
+    n = pesagem_processa(&p, traco, AMOSTRAS, produtos, PESAGEM_MAX_PRODUTOS);
+    CONFERE(n == PESAGEM_MAX_PRODUTOS && (int) p.descartados == referencia.n - n &&
+            referencia.p.descartados == 0, "%d emitidos e %u descartados de %d", n, p.descartados,
+            referencia.n);
+}
+
+// batida de 8 ms: sobe acima do limiar e volta sem assentar
+static void testa_batida(void)
+{
+    static resultado_t r;
+
+    for (int i = 0; i < AMOSTRAS; i++)
+    {
+        traco[i] = 0.250f + (i >= 5000 && i < 5008 ? 0.8f : 0.0f);
+    }
+    processa(&r, PESAGEM_BLOCO);
+
+    CONFERE(r.n == 0 && r.p.falsos == 1, "batida: %d produtos, %u falsos", r.n, r.p.falsos);
+}
+
+// sem deriva, a chegada e a saída de cada produto não podem arrastar a
+// tara; com a tara subindo 10 g em 10 s, sem acompanhar, o peso sairia
+// até 10 g acima
+static void testa_deriva(void)
+{
+    static resultado_t r;
+    pesagem_gerador_t g;
+    const uint32_t periodos_ms[] = {137, 230, 690};
+    const float derivas[] = {0, 0, 0.010f};
+
+    for (int d = 0; d < 3; d++)
+    {
+        float pior = 0;
+
+        pesagem_gerador_inicia(&g, PESAGEM_TAXA_HZ, periodos_ms[d], 0, 2.0f, 7);
+        pesagem_gera(&g, traco, AMOSTRAS);
+        for (int i = 0; i < AMOSTRAS; i++)
+        {
+            traco[i] += derivas[d] * i / AMOSTRAS;
+        }
+        processa(&r, PESAGEM_BLOCO);
+
+        for (int i = 0; i < r.n; i++)
+        {
+            pior = fmaxf(pior, fabsf(r.produtos[i].peso - 2.0f));
+        }
+        CONFERE(todos(&r, &g) && pior <= PESAGEM_TOLERANCIA,
+                "produtos a cada %u ms, deriva de %.0f g: %d produtos, pior erro %.4f kg",
+                periodos_ms[d], derivas[d] * 1000, r.n, pior);
+    }
+}
+
+int main(void)
+{
+    testa_blocos();
+    testa_limite();
+    testa_batida();
+    testa_deriva();
+
+    CONFERE(pesagem_benchmark(), "produto perdido ou fora da tolerância no benchmark");
+
+    TESTE_FIM();
+}
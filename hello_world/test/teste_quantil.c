@@ -0,0 +1,130 @@
+/*
+Arquivo: teste_quantil.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes do esboço de quantis: quantis exatos enquanto tudo cabe
+        no nível 0, peso total dos níveis igual aos produtos depois de
+        compactações e junções, níveis acima do 0 sempre ordenados, e
+        o benchmark de 10^7 amostras com o erro de posto dentro do
+        limite, direto e pelos lotes juntados no turno.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "lote.h"
+#include "quantil.h"
+
+static uint32_t estado_aleatorio = 88172645u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// Σ 2^nível dos itens e a ordem de cada nível acima do 0
+static bool consistente(const quantil_t *s, uint64_t *peso)
+{
+    *peso = 0;
+    if (s->inicio[0] > s->inicio[s->niveis] || s->inicio[s->niveis] != QUANTIL_CAPACIDADE)
+    {
+        return false;
+    }
+
+    for (int h = 0; h < s->niveis; h++)
+    {
+        if (s->inicio[h] > s->inicio[h + 1])
+        {
+            return false;
+        }
+        *peso += (uint64_t) (s->inicio[h + 1] - s->inicio[h]) << h;
+        for (uint32_t i = s->inicio[h] + 1; h > 0 && i < s->inicio[h + 1]; i++)
+        {
+            if (s->itens[i - 1] > s->itens[i])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// até K itens não há compactação: os quantis são os exatos
+static void testa_exatos(void)
+{
+    static quantil_t s;
+    const float q[] = {0, 0.25f, 0.5f, 1};
+    float valores[4];
+
+    quantil_inicia(&s, 7);
+    valores[0] = -1;
+    quantil_valores(&s, q, valores, 1);
+    CONFERE(s.n == 0 && valores[0] == 0, "esboço vazio: %u produtos, mínimo %f", s.n, valores[0]);
+
+    // 1..40 embaralhados
+    for (int i = 0; i < 40; i++)
+    {
+        quantil_acrescenta(&s, (float) ((i * 17) % 40 + 1));
+    }
+    quantil_valores(&s, q, valores, 4);
+
+    CONFERE(s.niveis == 1 && s.min == 1 && s.max == 40, "%d níveis, min %f max %f", s.niveis, s.min,
+            s.max);
+    CONFERE(valores[0] == 1 && valores[1] == 10 && valores[2] == 20 && valores[3] == 40,
+            "quantis %f %f %f %f", valores[0], valores[1], valores[2], valores[3]);
+}
+
+// muitas compactações e junções, inclusive de esboços vazios e de um
+// esboço no vazio: nenhum produto ganha nem perde peso
+static void testa_peso(void)
+{
+    static quantil_t turno, lote, vazio;
+    uint64_t peso;
+    uint32_t total = 0;
+    int erradas = 0;
+
+    quantil_inicia(&turno, 1);
+    quantil_inicia(&vazio, 2);
+    for (int l = 0; l < 5000; l++)
+    {
+        uint32_t tamanho = l % 11 == 0 ? 0 : aleatorio() % (4 * NUM_MAX_PROD);
+
+        quantil_inicia(&lote, l);
+        for (uint32_t i = 0; i < tamanho; i++)
+        {
+            quantil_acrescenta(&lote, 2.0f + (aleatorio() % 1000) * 1e-4f);
+        }
+        erradas += !consistente(&lote, &peso) || peso != lote.n;
+
+        quantil_junta(&turno, &lote);
+        quantil_junta(&turno, &vazio);
+        total += tamanho;
+        erradas += !consistente(&turno, &peso) || peso != total || turno.n != total;
+    }
+    CONFERE(erradas == 0 && turno.n == total && turno.niveis > 10, "%d esboços inconsistentes (%u produtos, %d níveis)",
+            erradas, turno.n, turno.niveis);
+
+    // junção num esboço vazio leva min e max junto
+    quantil_inicia(&vazio, 3);
+    quantil_junta(&vazio, &turno);
+    CONFERE(vazio.n == turno.n && vazio.min == turno.min && vazio.max == turno.max,
+            "junção no vazio: %u produtos, min %f max %f", vazio.n, vazio.min, vazio.max);
+}
+
+int main(void)
+{
+    testa_exatos();
+    testa_peso();
+
+    CONFERE(quantil_benchmark(), "erro de posto acima do limite no benchmark");
+
+    TESTE_FIM();
+}
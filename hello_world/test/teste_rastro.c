@@ -0,0 +1,125 @@
+/*
+Arquivo: teste_rastro.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes dos anéis do rastro com relógio simulado: cada core no
+        seu anel, o anel guardando os eventos mais novos, o contador de
+        ciclos dando a volta e o recomeço depois do despejo. Os
+        despejos saem na saída padrão, com o instante esperado de cada
+        evento em comentário, para teste_rastro.py conferir a conversão
+        de tools/rastro_chrome.py.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "teste.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "formato.h"
+#include "rastro.h"
+
+#define EVENTOS_CORE_0 (RASTRO_TAMANHO + 188)
+#define EVENTOS_CORE_1 100
+
+// o despejo sai por printf; a UART do formatador não é usada
+esp_err_t uart_driver_install(uart_port_t porta, int rx, int tx, int fila, void *handle, int flags)
+{
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t porta, const char *dados, size_t n)
+{
+    return n;
+}
+
+// um evento no core, no instante us; a linha "#" vai para teste_rastro.py
+static void evento(int core, int64_t us, rastro_regiao_t regiao, char fase, bool despejado)
+{
+    hospedeiro_core(core);
+    hospedeiro_relogio(us);
+    rastro_evento(regiao, fase);
+
+    if (despejado)
+    {
+        printf("# %d %c %d %lld\n", core, fase, regiao, (long long) us);
+    }
+}
+
+// despeja num arquivo temporário, confere as linhas e repete na saída
+static void despeja(int eventos_0, int eventos_1)
+{
+    FILE *arquivo = tmpfile();
+    char linha[128];
+    int eventos[2] = {0, 0};
+    int refs = 0, nomes = 0, fim = 0, saida = dup(1);
+
+    fflush(stdout);
+    dup2(fileno(arquivo), 1);
+    rastro_despeja();
+    fflush(stdout);
+    dup2(saida, 1);
+    close(saida);
+
+    rewind(arquivo);
+    while (fgets(linha, sizeof(linha), arquivo) != NULL)
+    {
+        int core;
+
+        fputs(linha, stdout);
+
+        if (sscanf(linha, "RASTRO EV %d", &core) == 1 && core >= 0 && core < 2)
+        {
+            eventos[core]++;
+        }
+        refs += strncmp(linha, "RASTRO REF", 10) == 0;
+        nomes += strncmp(linha, "RASTRO NOME", 11) == 0;
+        fim += strcmp(linha, "RASTRO FIM\n") == 0;
+    }
+    fclose(arquivo);
+
+    CONFERE(eventos[0] == eventos_0 && eventos[1] == eventos_1, "eventos %d e %d, esperados %d e %d",
+            eventos[0], eventos[1], eventos_0, eventos_1);
+    CONFERE(refs == portNUM_PROCESSORS && nomes == RASTRO_NUM_REGIOES && fim == 1,
+            "%d referências, %d nomes, %d fins", refs, nomes, fim);
+}
+
+int main(void)
+{
+    // 1 s de partida; a 160 MHz o contador de 32 bits volta a cada 26,8 s
+    int64_t us = 1000000;
+
+    // core 0: mais eventos que o anel, por 42 s (o contador volta uma vez)
+    for (int k = 0; k < EVENTOS_CORE_0; k++)
+    {
+        us += 60000;
+        evento(0, us, k % 4 < 2 ? RASTRO_SOMA_PRODUTO : RASTRO_DISPLAY, k % 2 == 0 ? 'B' : 'E',
+               k >= EVENTOS_CORE_0 - RASTRO_TAMANHO);
+    }
+
+    // core 1: poucos eventos, intercalados no fim do core 0
+    for (int k = 0; k < EVENTOS_CORE_1; k++)
+    {
+        evento(1, us - 5000000 + k * 50000 + 7, RASTRO_RELATORIO, k % 2 == 0 ? 'B' : 'E', true);
+    }
+
+    hospedeiro_relogio(us + 1000);
+    despeja(RASTRO_TAMANHO, EVENTOS_CORE_1);
+
+    // depois do despejo o anel recomeça: só os eventos novos
+    us += 30000000;
+    evento(0, us, RASTRO_TOUCH, 'B', true);
+    evento(0, us + 250, RASTRO_TOUCH, 'E', true);
+    hospedeiro_relogio(us + 500);
+    despeja(2, 0);
+
+    hospedeiro_relogio_real();
+
+    TESTE_FIM();
+}
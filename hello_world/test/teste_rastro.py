@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Confere tools/rastro_chrome.py com os despejos de teste_rastro: cada evento
+convertido tem que cair no instante esperado (linhas "#" da saída), com o
+contador de ciclos dando a volta no meio, e o JSON tem que abrir no Perfetto
+(pares B/E casados por thread, tempos crescentes). Um recuo pequeno dos
+ciclos não pode virar uma volta do contador.
+
+Uso:
+    python3 teste_rastro.py caminho/do/teste_rastro
+"""
+
+import importlib.util
+import json
+import os
+import subprocess
+import sys
+
+AQUI = os.path.dirname(os.path.abspath(__file__))
+CONVERSOR = os.path.join(AQUI, "..", "tools", "rastro_chrome.py")
+
+
+def carrega_conversor():
+    spec = importlib.util.spec_from_file_location("rastro_chrome", CONVERSOR)
+    modulo = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(modulo)
+    return modulo
+
+
+def esperados(linhas):
+    """Eventos esperados de cada despejo, na ordem dos despejos."""
+    atual = []
+    for linha in linhas:
+        if linha.startswith("# "):
+            core, fase, regiao, us = linha.split()[1:]
+            atual.append((int(core), fase, int(regiao), int(us)))
+        elif linha.startswith("RASTRO FIM"):
+            yield atual
+            atual = []
+
+
+def confere_recuo(rastro):
+    """Recuo de 100 ciclos fica 100 ciclos antes, não 26,8 s depois,
+    antes e depois de uma volta de verdade."""
+    despejo = {
+        "mhz": 160, "nomes": {0: "soma_produto"}, "refs": {0: (1000, 5000000)},
+        "eventos": {0: [("B", 0, 2 ** 32 - 3000, "1"), ("E", 0, 2 ** 32 - 3100, "1"),
+                        ("B", 0, 500, "1"), ("E", 0, 400, "1")]},
+    }
+    tempos = [e["ts"] for e in rastro.converte(despejo) if e["ph"] != "M"]
+    previstos = [5000000 - 4000 / 160, 5000000 - 4100 / 160,
+                 5000000 - 500 / 160, 5000000 - 600 / 160]
+
+    if len(tempos) != len(previstos) or any(abs(t - p) > 1.0 / 160 for t, p in zip(tempos, previstos)):
+        print("recuo de ciclos: %s, esperados %s" % (tempos, previstos))
+        return 1
+    return 0
+
+
+def main():
+    rastro = carrega_conversor()
+    execucao = subprocess.run([sys.argv[1]], stdout=subprocess.PIPE, universal_newlines=True)
+    linhas = execucao.stdout.splitlines()
+    falhas = 0 if execucao.returncode == 0 else 1
+    falhas += confere_recuo(rastro)
+
+    despejos = list(rastro.despejos(linhas))
+    previstos = list(esperados(linhas))
+    if len(despejos) != 2 or len(previstos) != 2:
+        print("despejos: %d, esperados 2" % len(despejos))
+        return 1
+
+    for n, (despejo, previsto) in enumerate(zip(despejos, previstos)):
+        convertidos = [e for e in rastro.converte(despejo) if e["ph"] != "M"]
+        obtidos = sorted((e["pid"], e["ph"], e["name"], e["ts"]) for e in convertidos)
+        nomes = despejo["nomes"]
+        previsto = sorted((c, f, nomes[r], us) for c, f, r, us in previsto)
+
+        if len(obtidos) != len(previsto):
+            print("despejo %d: %d eventos, esperados %d" % (n, len(obtidos), len(previsto)))
+            falhas += 1
+            continue
+
+        # um ciclo a 160 MHz é 1/160 us; o float do JSON não pode desviar mais que isso
+        for obtido, esperado in zip(obtidos, previsto):
+            if obtido[:3] != esperado[:3] or abs(obtido[3] - esperado[3]) > 1.0 / despejo["mhz"]:
+                print("despejo %d: evento %s, esperado %s" % (n, obtido, esperado))
+                falhas += 1
+                break
+
+        # por core e thread: tempos crescentes e B/E alternados, como o Perfetto espera
+        por_thread = {}
+        for e in convertidos:
+            por_thread.setdefault((e["pid"], e["tid"]), []).append(e)
+        for chave, eventos in por_thread.items():
+            tempos = [e["ts"] for e in eventos]
+            fases = "".join(e["ph"] for e in eventos)
+            if tempos != sorted(tempos) or fases.replace("BE", "") not in ("", "E", "B"):
+                print("despejo %d, thread %s: ordem ou pares quebrados" % (n, chave))
+                falhas += 1
+
+        # o JSON completo serializa
+        json.dumps({"traceEvents": rastro.converte(despejo), "displayTimeUnit": "ms"})
+
+    print("ok" if falhas == 0 else "FALHOU")
+    return 1 if falhas else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
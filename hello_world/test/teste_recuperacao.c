@@ -0,0 +1,360 @@
+/*
+Arquivo: teste_recuperacao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Resets em pontos aleatórios da retomada pela RTC, com o
+        pipeline de lotes simulado como em hello_world_main.c: produtos
+        entrando, lotes parados na fila da redução e do relatório,
+        reset com o produto pela metade no diário e no meio da
+        gravação da base. Depois de cada partida nenhum produto
+        confirmado pode sumir nem ser relatado duas vezes.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "teste.h"
+#include "esp_system.h"
+
+// o teste estraga a RTC como um reset no meio de uma gravação estragaria:
+// inclui a fonte para enxergar as cópias e os diários
+#include "recuperacao.c"
+
+#define PRODUTOS 3000000u
+
+float lote_peso_classe(int classe)
+{
+    return 0.5f + 0.25f * classe;
+}
+
+// peso do produto seq da esteira k (a classe é a esteira); exato em float
+static float peso(int k, uint32_t seq)
+{
+    return lote_peso_classe(k) + (float) (seq % 7) / 64;
+}
+
+static uint32_t estado_aleatorio = 2463534242u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// pipeline e relatório simulados: tudo isto se perde num reset
+static lote_t pool[LOTE_NUM_BUFFERS];
+static bool usado[LOTE_NUM_BUFFERS];
+static lote_t *fila[LOTE_NUM_BUFFERS];     // fechados, à espera do relatório
+static int fila_n;
+static lote_t *atual;
+static int num_produtos;
+static uint32_t num_lotes;
+static uint32_t seq_esperada[NUM_ESTEIRAS];
+static checkpoint_t checkpoint_base;
+static double massa_relatada[NUM_ESTEIRAS];
+static double peso_acumulado;
+
+// o que de fato aconteceu, fora da memória do firmware
+static uint32_t produzidos[NUM_ESTEIRAS];      // produtos com o selo gravado
+static uint32_t relatados[NUM_ESTEIRAS];       // fim das sequências na base
+static uint32_t relatados_antes[NUM_ESTEIRAS]; // antes da última incorporação
+static uint32_t proximo_relatado;              // número do próximo lote a relatar
+static uint32_t lacunas, repetidas, desencontros;
+static uint32_t resets, devolvidos, rasgados, bases_rasgadas;
+
+// como lote_obtem_livre; NULL com o pool inteiro no pipeline
+static lote_t *obtem(void)
+{
+    for (int b = 0; b < LOTE_NUM_BUFFERS; b++)
+    {
+        if (!usado[b])
+        {
+            lote_t *lote = &pool[b];
+
+            usado[b] = true;
+            lote->num_produtos = 0;
+            lote->peso_total = 0;
+            memset(lote->contagem_classe, 0, sizeof(lote->contagem_classe));
+            memset(lote->desvio_classe, 0, sizeof(lote->desvio_classe));
+            for (int i = 0; i < NUM_ESTEIRAS; i++)
+            {
+                estatistica_zera(&lote->estatistica[i]);
+            }
+
+            return lote;
+        }
+    }
+
+    return NULL;
+}
+
+// como insere_produto
+static void insere(int k)
+{
+    uint32_t seq = produzidos[k];
+    float p = peso(k, seq);
+
+    if (num_produtos == 0)
+    {
+        for (int i = 0; i < NUM_ESTEIRAS; i++)
+        {
+            atual->contagem[i] = 0;
+            atual->seq_inicio[i] = seq_esperada[i];
+            atual->seq_fim[i] = seq_esperada[i];
+        }
+    }
+
+    lote_insere(atual, num_produtos, k, p - lote_peso_classe(k));
+    atual->contagem[k]++;
+    estatistica_acrescenta(&atual->estatistica[k], p);
+    atual->seq_fim[k] = seq + 1;
+    seq_esperada[k] = seq + 1;
+    recuperacao_produto(num_produtos, k, k, p);
+    produzidos[k]++;
+    num_produtos++;
+
+    if (num_produtos >= NUM_MAX_PROD)
+    {
+        atual->num_produtos = num_produtos;
+        atual->numero = num_lotes++;
+        recuperacao_fecha_lote();
+        fila[fila_n++] = atual;
+        atual = obtem();
+        num_produtos = 0;
+    }
+}
+
+// redução e relatório do lote mais antigo, como relatorio e monta_checkpoint
+static void relata(void)
+{
+    lote_t *lote = fila[0];
+    checkpoint_t c;
+    double total = 0;
+
+    fila_n--;
+    memmove(&fila[0], &fila[1], fila_n * sizeof(fila[0]));
+
+    desencontros += lote->numero != proximo_relatado;
+    proximo_relatado = lote->numero + 1;
+
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        const estatistica_t *e = &lote->estatistica[k];
+
+        if (lote->seq_inicio[k] > relatados[k])
+        {
+            lacunas += lote->seq_inicio[k] - relatados[k];
+        } else
+        {
+            repetidas += relatados[k] - lote->seq_inicio[k];
+        }
+        desencontros += lote->seq_fim[k] - lote->seq_inicio[k] != lote->contagem[k] ||
+                        e->n != lote->contagem[k];
+
+        massa_relatada[k] += (double) e->n * e->media;
+        total += (double) e->n * e->media;
+    }
+    lote->peso_total = (float) total;
+    peso_acumulado += lote->peso_total;
+
+    c.lotes = lote->numero + 1;
+    c.peso_acumulado = peso_acumulado;
+    c.ultimo_total = lote->peso_total;
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        c.contagem[k] = lote->seq_fim[k];
+        c.massa[k] = checkpoint_base.massa[k] + massa_relatada[k];
+        relatados_antes[k] = relatados[k];
+        relatados[k] = lote->seq_fim[k];
+    }
+    recuperacao_relatado(&c);
+
+    usado[lote - pool] = false;
+}
+
+static uint32_t soma(const uint32_t *v)
+{
+    uint32_t total = 0;
+
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        total += v[k];
+    }
+
+    return total;
+}
+
+// reset com a RTC preservada e a partida de app_main
+static void reinicia(void)
+{
+    checkpoint_t c;
+    recuperacao_info_t info;
+    lote_t *lote;
+
+    switch (aleatorio() % 3)
+    {
+    case 0:
+        // produto com os dados no diário e sem o selo: não aconteceu
+        if (atual != NULL)
+        {
+            diario_t *d = diario(lote_diario);
+
+            d->pesos[num_produtos] = 123.0f;
+            d->esteira[num_produtos] = 0;
+            d->classe[num_produtos] = 0;
+            rasgados++;
+        }
+        break;
+
+    case 1:
+        // reset no meio da gravação da base: a cópia nova fica estragada,
+        // vale a anterior e o lote volta do diário
+        if (fila_n > 0)
+        {
+            uint8_t *copia;
+
+            relata();
+            copia = (uint8_t *) &rtc_base[ativa_base];
+            copia[8 + aleatorio() % (sizeof(copia_base_t) - 8)] ^= 1 << (aleatorio() % 8);
+            memcpy(relatados, relatados_antes, sizeof(relatados));
+            proximo_relatado--;
+            bases_rasgadas++;
+        }
+        break;
+    }
+
+    // a RAM se perde; a NVS traz um checkpoint qualquer, que a RTC substitui
+    memset(usado, 0, sizeof(usado));
+    memset(massa_relatada, 0, sizeof(massa_relatada));
+    fila_n = 0;
+    atual = NULL;
+    memset(&c, 0, sizeof(c));
+    resets++;
+
+    hospedeiro_reset(aleatorio() % 2 ? ESP_RST_SW : ESP_RST_TASK_WDT);
+    recuperacao_inicia(&c, &info);
+
+    CONFERE(info.retomado, "reset %u: RTC não retomada", resets);
+    CONFERE(info.produtos == soma(produzidos), "reset %u: %u produtos restaurados, %u confirmados",
+            resets, info.produtos, soma(produzidos));
+    CONFERE(memcmp(c.contagem, relatados, sizeof(relatados)) == 0 && c.lotes == proximo_relatado,
+            "reset %u: base com %u lotes, esperados %u", resets, c.lotes, proximo_relatado);
+
+    checkpoint_base = c;
+    peso_acumulado = c.peso_acumulado;
+
+    // lotes do diário de volta ao pipeline; com o pool cheio o relatório
+    // libera um buffer, como a espera em lote_obtem_livre
+    lote = obtem();
+    while (recuperacao_lote(lote))
+    {
+        fila[fila_n++] = lote;
+        devolvidos++;
+        lote = obtem();
+        if (lote == NULL)
+        {
+            relata();
+            lote = obtem();
+        }
+    }
+
+    atual = lote;
+    num_lotes = lote->numero;
+    num_produtos = lote->num_produtos;
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        seq_esperada[k] = lote->seq_fim[k];
+        CONFERE(seq_esperada[k] == produzidos[k], "reset %u, esteira %d: continua em %u, confirmados %u",
+                resets, k, seq_esperada[k], produzidos[k]);
+    }
+}
+
+int main(void)
+{
+    checkpoint_t c;
+    recuperacao_info_t info;
+    uint32_t relatar = 100;     // em mil: parado ou em dia
+
+    // primeira partida: RTC com lixo, NVS vazia
+    memset(rtc_base, 0xA5, sizeof(rtc_base));
+    memset(rtc_diario, 0x5A, sizeof(rtc_diario));
+    memset(&c, 0, sizeof(c));
+    hospedeiro_reset(ESP_RST_POWERON);
+    recuperacao_inicia(&c, &info);
+    CONFERE(!info.retomado && info.produtos == 0, "partida a frio com %u produtos", info.produtos);
+
+    atual = obtem();
+
+    for (uint32_t passo = 0; soma(produzidos) < PRODUTOS; passo++)
+    {
+        uint32_t r = aleatorio() % 1000;
+
+        // alterna trechos com o relatório em dia e parado (a fila enche)
+        if (passo % 20000 == 0)
+        {
+            relatar = aleatorio() % 2 ? 100 : 2;
+        }
+
+        if (atual == NULL)
+        {
+            atual = obtem();
+        }
+
+        if (r == 0)
+        {
+            reinicia();
+        } else if (fila_n > 0 && (atual == NULL || r <= relatar))
+        {
+            relata();
+        } else if (atual != NULL)
+        {
+            insere(aleatorio() % NUM_ESTEIRAS);
+        }
+    }
+
+    // esvazia o pipeline: o que não foi relatado está no lote em preenchimento
+    while (fila_n > 0)
+    {
+        relata();
+    }
+    if (atual == NULL)
+    {
+        atual = obtem();
+    }
+
+    printf("%u produtos, %u resets, %u lotes devolvidos ao pipeline, %u produtos e %u bases rasgados\n",
+           soma(produzidos), resets, devolvidos, rasgados, bases_rasgadas);
+
+    CONFERE(resets > 1000 && devolvidos > 1000 && rasgados > 100 && bases_rasgadas > 100,
+            "poucos casos exercitados");
+    CONFERE(lacunas == 0, "%u produtos perdidos", lacunas);
+    CONFERE(repetidas == 0, "%u produtos relatados duas vezes", repetidas);
+    CONFERE(desencontros == 0, "%u lotes com número ou contagens fora do lugar", desencontros);
+
+    for (int k = 0; k < NUM_ESTEIRAS; k++)
+    {
+        double esperada = 0;
+
+        CONFERE(relatados[k] + atual->contagem[k] * (num_produtos > 0) == produzidos[k],
+                "esteira %d: %u relatados + %u no lote, %u confirmados", k, relatados[k],
+                atual->contagem[k], produzidos[k]);
+
+        // massa da base, somada lote a lote por n × média (a média em float
+        // erra uns 1e-7 por lote); um produto a mais ou a menos passaria de
+        // meio peso nominal
+        for (uint32_t seq = 0; seq < relatados[k]; seq++)
+        {
+            esperada += peso(k, seq);
+        }
+        CONFERE(fabs(base.massa[k] - esperada) < lote_peso_classe(0) / 2,
+                "esteira %d: massa %.6f, esperada %.6f", k, base.massa[k], esperada);
+    }
+
+    TESTE_FIM();
+}
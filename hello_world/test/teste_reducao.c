@@ -0,0 +1,157 @@
+/*
+Arquivo: teste_reducao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da redução paralela com os trabalhadores em threads:
+        a soma em blocos igual bit a bit a uma referência sequencial
+        para todo K e todo tamanho de bloco, o benchmark de N até 1M e
+        K = 1..8, e a redução sem trabalhadores.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "reducao.h"
+
+#define N 100000
+#define N_MAX 1048576
+
+static float v[N_MAX];
+static float blocos[REDUCAO_MAX_BLOCOS];
+
+static uint32_t estado_aleatorio = 2463534242u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// a ordem que a soma reprodutível promete, escrita à parte: blocos de
+// potência de 2 (o menor que cabe em REDUCAO_MAX_BLOCOS) somados em
+// sequência e combinados em árvore de pares
+static float referencia(const float *x, int n, int *tamanho_bloco)
+{
+    int b = REDUCAO_BLOCO_MIN, num = 0;
+
+    while ((int64_t) b * REDUCAO_MAX_BLOCOS < n)
+    {
+        b *= 2;
+    }
+    *tamanho_bloco = b;
+
+    for (int inicio = 0; inicio < n; inicio += b)
+    {
+        float s = 0;
+
+        for (int j = inicio; j < n && j < inicio + b; j++)
+        {
+            s += x[j];
+        }
+        blocos[num++] = s;
+    }
+
+    for (int passo = 1; passo < num; passo *= 2)
+    {
+        for (int i = 0; i + passo < num; i += 2 * passo)
+        {
+            blocos[i] += blocos[i + passo];
+        }
+    }
+
+    return num > 0 ? blocos[0] : 0;
+}
+
+static bool mesmo_float(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// pesos de magnitudes bem diferentes: qualquer troca de ordem aparece nos bits
+static void testa_reprodutivel(void)
+{
+    static const int tamanhos[] = {
+        0, 1, 63, 64, 65, 1000, 4097, 65535, 65536, 65537, 100003, 131073, 524288, N_MAX,
+    };
+    int diferentes = 0, ingenuas_diferentes = 0, bloco_min = N_MAX, bloco_max = 0;
+
+    for (int j = 0; j < N_MAX; j++)
+    {
+        v[j] = (aleatorio() % 1000) * 0.001f + (aleatorio() % 16 == 0 ? 1000.0f : 0.0f);
+    }
+
+    for (int t = 0; t < (int) (sizeof(tamanhos) / sizeof(tamanhos[0])); t++)
+    {
+        int n = tamanhos[t], b;
+        float esperada = referencia(v, n, &b), ingenua_1 = 0;
+
+        bloco_min = b < bloco_min ? b : bloco_min;
+        bloco_max = b > bloco_max ? b : bloco_max;
+
+        for (int k = 1; k <= REDUCAO_MAX_TRABALHADORES; k++)
+        {
+            float r = reducao_soma_reprodutivel_k(v, n, k);
+            float ingenua = reducao_soma_k(v, n, k);
+
+            if (!mesmo_float(r, esperada))
+            {
+                diferentes++;
+                printf("N = %d, K = %d, bloco %d: %.9g, referência %.9g\n", n, k, b, r, esperada);
+            }
+
+            if (k == 1)
+            {
+                ingenua_1 = ingenua;
+            }
+            ingenuas_diferentes += !mesmo_float(ingenua, ingenua_1);
+        }
+    }
+
+    printf("soma reprodutível: blocos de %d a %d, pedaços por K diferiram %d vezes\n",
+           bloco_min, bloco_max, ingenuas_diferentes);
+    CONFERE(diferentes == 0, "%d somas fora da ordem de blocos", diferentes);
+
+    // os pesos têm que ser capazes de mostrar a diferença de ordem
+    CONFERE(ingenuas_diferentes > 0, "soma por pedaços igual para todo K");
+    CONFERE(bloco_min == REDUCAO_BLOCO_MIN && bloco_max > bloco_min, "blocos de %d a %d",
+            bloco_min, bloco_max);
+}
+
+// K = 0 soma no chamador, sem esperar uma máscara de eventos vazia
+static void testa_sem_trabalhadores(void)
+{
+    float sequencial = 0;
+
+    for (int j = 0; j < N; j++)
+    {
+        v[j] = (j % 3 == 0) ? 5.0f : (j % 3 == 1) ? 2.0f : 0.1f * (j % 7);
+        sequencial += v[j];
+    }
+
+    float ingenua = reducao_soma_k(v, N, 0);
+    float reprodutivel = reducao_soma_reprodutivel_k(v, N, 0);
+
+    CONFERE(mesmo_float(ingenua, sequencial), "K = 0: %.9g, sequencial %.9g", ingenua, sequencial);
+
+    float um = reducao_soma_reprodutivel_k(v, N, 1);
+    CONFERE(mesmo_float(reprodutivel, um), "K = 0: %.9g, K = 1: %.9g", reprodutivel, um);
+}
+
+int main(void)
+{
+    CONFERE(reducao_inicia(REDUCAO_MAX_TRABALHADORES, 1), "trabalhadores não criados");
+
+    testa_reprodutivel();
+    testa_sem_trabalhadores();
+#if REDUCAO_BENCHMARK
+    CONFERE(reducao_benchmark(), "soma reprodutível diferente entre os K");
+#endif
+
+    TESTE_FIM();
+}
@@ -0,0 +1,476 @@
+/*
+Arquivo: teste_rejeicao.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da rejeição por faixa com prazo e da ingestão por
+        interrupção: faixa, atrasos e histograma; ISR de timer e o lote
+        recolhido sem amostra, que fica com o evento anterior; e a
+        simulação de 64 esteiras a 1000 produtos/s somados, com as
+        fotocélulas e um core no relógio simulado, em que nenhum produto
+        decidido a tempo pode ter passado do prazo de verdade.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <string.h>
+#include "teste.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "driver/timer.h"
+#include "ingestao.h"
+#include "rejeicao.h"
+
+#define ESTEIRAS 64
+#define PRODUTOS_S 1000
+#define SEGUNDOS 10
+#define PERIODO_US (ESTEIRAS * 1000000 / PRODUTOS_S)
+
+// produtos entre a fotocélula e a decisão de uma esteira
+#define FILA 16
+
+// custo de um despertar da tarefa da esteira (troca de contexto,
+// notificação, mutex) e de cada produto (inserção no lote e decisão),
+// com folga sobre o ESP32
+#define CUSTO_DESPERTAR_US 100
+#define CUSTO_PRODUTO_US 50
+
+// GPIOs falsos: a fotocélula chama a ISR registrada
+static struct
+{
+    void (*isr)(void *);
+    void *arg;
+} pinos[ESTEIRAS];
+static int servicos_gpio;
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return config->pin_bit_mask != 0 ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_install_isr_service(int flags)
+{
+    servicos_gpio++;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio, void (*isr)(void *), void *arg)
+{
+    pinos[gpio].isr = isr;
+    pinos[gpio].arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio)
+{
+    pinos[gpio].isr = NULL;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t nivel)
+{
+    return ESP_OK;
+}
+
+// timers falsos: o contador guarda a latência que a ISR vai ler
+static struct
+{
+    void (*isr)(void *);
+    void *arg;
+    uint64_t contador;
+    bool rodando;
+} timers[4];
+static int interrupcoes_liberadas;
+
+esp_err_t timer_init(timer_group_t grupo, timer_idx_t indice, const timer_config_t *config)
+{
+    return ESP_OK;
+}
+
+esp_err_t timer_set_counter_value(timer_group_t grupo, timer_idx_t indice, uint64_t valor)
+{
+    timers[grupo * 2 + indice].contador = valor;
+    return ESP_OK;
+}
+
+esp_err_t timer_set_alarm_value(timer_group_t grupo, timer_idx_t indice, uint64_t valor)
+{
+    return ESP_OK;
+}
+
+esp_err_t timer_enable_intr(timer_group_t grupo, timer_idx_t indice)
+{
+    return ESP_OK;
+}
+
+esp_err_t timer_isr_register(timer_group_t grupo, timer_idx_t indice, void (*isr)(void *), void *arg,
+                             int flags, timer_isr_handle_t *handle)
+{
+    timers[grupo * 2 + indice].isr = isr;
+    timers[grupo * 2 + indice].arg = arg;
+    *handle = &timers[grupo * 2 + indice];
+    return ESP_OK;
+}
+
+esp_err_t timer_start(timer_group_t grupo, timer_idx_t indice)
+{
+    timers[grupo * 2 + indice].rodando = true;
+    return ESP_OK;
+}
+
+esp_err_t timer_pause(timer_group_t grupo, timer_idx_t indice)
+{
+    timers[grupo * 2 + indice].rodando = false;
+    return ESP_OK;
+}
+
+void timer_group_clr_intr_status_in_isr(timer_group_t grupo, timer_idx_t indice)
+{
+}
+
+void timer_group_enable_alarm_in_isr(timer_group_t grupo, timer_idx_t indice)
+{
+}
+
+uint64_t timer_group_get_counter_value_in_isr(timer_group_t grupo, timer_idx_t indice)
+{
+    return timers[grupo * 2 + indice].contador;
+}
+
+esp_err_t esp_intr_free(intr_handle_t handle)
+{
+    interrupcoes_liberadas++;
+    return ESP_OK;
+}
+
+// tarefas das esteiras: só os endereços servem de handle
+static char tarefas[ESTEIRAS + 1];
+
+static uint32_t estado_aleatorio = 2463534242u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// faixa de ±2% em torno de 2 kg, dentro e fora do prazo
+static void testa_faixa(void)
+{
+    rejeicao_t r;
+
+    CONFERE(rejeicao_inicia(&r, 2.0f, 0.02f, 20000, -1), "rejeição não iniciou");
+
+    hospedeiro_relogio(1000100);
+    CONFERE(rejeicao_decide(&r, 2.0f, 1000000) == REJEICAO_ACEITO, "2 kg não foi aceito");
+    CONFERE(rejeicao_decide(&r, 1.95f, 1000000) == REJEICAO_ABAIXO, "1,95 kg não ficou abaixo");
+    CONFERE(rejeicao_decide(&r, 2.05f, 1000000) == REJEICAO_ACIMA, "2,05 kg não ficou acima");
+
+    // 30 ms depois do evento o produto já passou do ejetor
+    hospedeiro_relogio(1030000);
+    CONFERE(rejeicao_decide(&r, 1.95f, 1000000) == REJEICAO_ATRASADO, "decisão atrasada aceita");
+    CONFERE(rejeicao_decide(&r, 2.0f, 1000000) == REJEICAO_ATRASADO, "decisão atrasada aceita");
+
+    CONFERE(r.aceitos == 1 && r.abaixo == 1 && r.acima == 1 && r.atrasados == 2 && r.atrasados_fora == 1,
+            "contadores %u %u %u %u %u", r.aceitos, r.abaixo, r.acima, r.atrasados, r.atrasados_fora);
+    CONFERE(r.latencia_max_us == 30000 && r.faixas[6] == 3 && r.faixas[14] == 2,
+            "latência máxima %u us, faixas %u e %u", r.latencia_max_us, r.faixas[6], r.faixas[14]);
+    CONFERE(rejeicao_percentil_us(&r, 0.5f) == 128 && rejeicao_percentil_us(&r, 1.0f) == 32768,
+            "percentis %u e %u us", rejeicao_percentil_us(&r, 0.5f), rejeicao_percentil_us(&r, 1.0f));
+    hospedeiro_relogio_real();
+}
+
+// ISR do timer e o lote sem amostra de latência
+static void testa_ingestao(void)
+{
+    static ingestao_t g;
+    TaskHandle_t tarefa = &tarefas[ESTEIRAS];
+
+    CONFERE(!ingestao_inicia_simulada(&g, 4, 1000, tarefa), "timer inexistente aceito");
+    CONFERE(ingestao_inicia_simulada(&g, 1, 1000, tarefa) && timers[1].rodando && timers[1].isr != NULL,
+            "timer 1 não configurou");
+
+    hospedeiro_tarefa(tarefa);
+    CONFERE(ingestao_aguarda(&g, 0) == 0, "produto sem interrupção");
+
+    // duas interrupções, a primeira atendida 7 us depois do alarme
+    timers[1].contador = 7;
+    hospedeiro_relogio(1000);
+    timers[1].isr(timers[1].arg);
+    timers[1].contador = 3;
+    hospedeiro_relogio(1500);
+    timers[1].isr(timers[1].arg);
+
+    hospedeiro_relogio(1800);
+    CONFERE(ingestao_aguarda(&g, 0) == 2 && g.evento_us == 1000 && g.latencia_max_us == 800,
+            "lote de 2: evento em %lld us, latência %u us", (long long) g.evento_us, g.latencia_max_us);
+    CONFERE(g.interrupcoes == 2 && g.latencia_isr_max == 7, "%u interrupções, latência da ISR %u us",
+            g.interrupcoes, g.latencia_isr_max);
+
+    // a ISR caiu entre o take e a troca do lote anterior, que levou a sua
+    // marca: o lote fica com o evento anterior, nunca com o agora
+    hospedeiro_relogio(2000);
+    timers[1].isr(timers[1].arg);
+    g.primeiro_us = 0;
+    hospedeiro_relogio(2500);
+    CONFERE(ingestao_aguarda(&g, 0) == 1 && g.evento_us == 1000 && g.latencia_max_us == 800,
+            "lote sem amostra: evento em %lld us, latência %u us", (long long) g.evento_us,
+            g.latencia_max_us);
+    CONFERE(g.despertares == 2 && g.produtos == 3 && g.maior_lote == 2, "%u despertares, %u produtos",
+            g.despertares, g.produtos);
+
+    ingestao_para(&g);
+    CONFERE(!timers[1].rodando && interrupcoes_liberadas == 1 && g.timer == -1, "timer não parou");
+    hospedeiro_tarefa(NULL);
+    hospedeiro_relogio_real();
+}
+
+typedef struct
+{
+    ingestao_t ingestao;
+    rejeicao_t rejeicao;
+    int64_t proxima_us;             // próxima fotocélula
+
+    // produtos passados pela fotocélula e ainda sem decisão
+    float pesos[FILA];
+    int64_t eventos[FILA];
+    uint32_t entrada, saida;
+
+    bool pronta;                    // notificada e à espera do core
+} esteira_t;
+
+static esteira_t esteiras[ESTEIRAS];
+
+// esteiras notificadas, na ordem em que ficaram prontas
+static int prontas[ESTEIRAS];
+static int prontas_inicio, prontas_n;
+
+typedef struct
+{
+    uint32_t produtos, decididos, aceitos, rejeitados, atrasados, atrasados_fora;
+    uint32_t erradas;               // dentro do prazo e fora da faixa certa
+    uint32_t inseguras;             // decididas a tempo depois do prazo de verdade
+    uint32_t transbordos;
+    uint32_t latencia_real_max, latencia_max, p50, p99;
+} resultado_t;
+
+// pesos nominais de 0,5 a 5 kg com ±3% de variação: ~1/3 fora da faixa de ±2%
+static float nominal(int k)
+{
+    return 0.5f + 4.5f * k / (ESTEIRAS - 1);
+}
+
+// produto na fotocélula da esteira k: a ISR só notifica a tarefa
+static void fotocelula(int k, resultado_t *res)
+{
+    esteira_t *e = &esteiras[k];
+    float variacao = 0.06f * ((aleatorio() >> 8) * (1.0f / (1 << 24)) - 0.5f);
+
+    hospedeiro_relogio(e->proxima_us);
+    if (e->entrada - e->saida == FILA)
+    {
+        res->transbordos++;
+    } else
+    {
+        e->pesos[e->entrada % FILA] = nominal(k) * (1 + variacao);
+        e->eventos[e->entrada % FILA] = e->proxima_us;
+        e->entrada++;
+    }
+    pinos[k].isr(pinos[k].arg);
+    res->produtos++;
+
+    if (!e->pronta)
+    {
+        e->pronta = true;
+        prontas[(prontas_inicio + prontas_n++) % ESTEIRAS] = k;
+    }
+    e->proxima_us += PERIODO_US;
+}
+
+// dispara as fotocélulas até o instante ate (inclusive), em ordem
+static void fotocelulas(int64_t ate, int64_t fim, resultado_t *res)
+{
+    while (1)
+    {
+        int proxima = -1;
+
+        for (int k = 0; k < ESTEIRAS; k++)
+        {
+            if (esteiras[k].proxima_us < fim && esteiras[k].proxima_us <= ate &&
+                (proxima < 0 || esteiras[k].proxima_us < esteiras[proxima].proxima_us))
+            {
+                proxima = k;
+            }
+        }
+        if (proxima < 0)
+        {
+            return;
+        }
+        fotocelula(proxima, res);
+    }
+}
+
+// um core roda as tarefas das esteiras na ordem em que foram notificadas,
+// sem preempção entre elas (mesma prioridade); as ISRs entram no meio. O
+// job recolhe todos os pendentes e decide cada produto no fim do custo
+static resultado_t simula(bool sincronizadas, uint32_t despertar_us, uint32_t produto_us)
+{
+    const int64_t inicio = 1000000, fim = inicio + (int64_t) SEGUNDOS * 1000000;
+    resultado_t res;
+    rejeicao_t total;
+    int64_t livre = inicio;
+
+    memset(&res, 0, sizeof(res));
+    memset(&total, 0, sizeof(total));
+    prontas_inicio = prontas_n = 0;
+    for (int k = 0; k < ESTEIRAS; k++)
+    {
+        esteira_t *e = &esteiras[k];
+
+        memset(e, 0, sizeof(*e));
+        ingestao_inicia_gpio(&e->ingestao, k, &tarefas[k]);
+        rejeicao_inicia(&e->rejeicao, nominal(k), REJEICAO_TOLERANCIA, REJEICAO_PRAZO_US, -1);
+        e->proxima_us = inicio + (sincronizadas ? 0 : (int64_t) k * PERIODO_US / ESTEIRAS);
+    }
+
+    while (1)
+    {
+        esteira_t *e;
+        int k;
+        uint32_t n;
+        int64_t termino;
+
+        if (prontas_n == 0)
+        {
+            // core ocioso até a próxima fotocélula
+            int64_t proxima = fim;
+
+            for (k = 0; k < ESTEIRAS; k++)
+            {
+                proxima = esteiras[k].proxima_us < proxima ? esteiras[k].proxima_us : proxima;
+            }
+            if (proxima >= fim)
+            {
+                break;
+            }
+            fotocelulas(proxima, fim, &res);
+            livre = livre > proxima ? livre : proxima;
+            continue;
+        }
+
+        fotocelulas(livre, fim, &res);
+        k = prontas[prontas_inicio];
+        prontas_inicio = (prontas_inicio + 1) % ESTEIRAS;
+        prontas_n--;
+        e = &esteiras[k];
+        e->pronta = false;
+
+        hospedeiro_relogio(livre);
+        hospedeiro_tarefa(&tarefas[k]);
+        n = ingestao_aguarda(&e->ingestao, 0);
+        termino = livre + despertar_us + n * produto_us;
+
+        // interrupções durante o job notificam de novo
+        fotocelulas(termino - 1, fim, &res);
+        hospedeiro_relogio(termino);
+
+        for (uint32_t i = 0; i < n && e->saida != e->entrada; i++, e->saida++)
+        {
+            float peso = e->pesos[e->saida % FILA];
+            uint32_t real = (uint32_t) (termino - e->eventos[e->saida % FILA]);
+            rejeicao_resultado_t esperado =
+                peso < e->rejeicao.minimo ? REJEICAO_ABAIXO :
+                peso > e->rejeicao.maximo ? REJEICAO_ACIMA : REJEICAO_ACEITO;
+
+            // como soma_produtos: todo o lote com o evento mais antigo recolhido
+            rejeicao_resultado_t r = rejeicao_decide(&e->rejeicao, peso, e->ingestao.evento_us);
+
+            res.erradas += r != REJEICAO_ATRASADO && r != esperado;
+            res.inseguras += r != REJEICAO_ATRASADO && real > REJEICAO_PRAZO_US;
+            res.latencia_real_max = real > res.latencia_real_max ? real : res.latencia_real_max;
+            res.decididos++;
+        }
+        livre = termino;
+    }
+
+    for (int k = 0; k < ESTEIRAS; k++)
+    {
+        rejeicao_t *r = &esteiras[k].rejeicao;
+
+        ingestao_para(&esteiras[k].ingestao);
+        res.aceitos += r->aceitos;
+        res.rejeitados += r->abaixo + r->acima;
+        res.atrasados += r->atrasados;
+        res.atrasados_fora += r->atrasados_fora;
+        res.latencia_max = r->latencia_max_us > res.latencia_max ? r->latencia_max_us : res.latencia_max;
+        for (int i = 0; i < REJEICAO_FAIXAS; i++)
+        {
+            total.faixas[i] += r->faixas[i];
+        }
+    }
+    res.p50 = rejeicao_percentil_us(&total, 0.5f);
+    res.p99 = rejeicao_percentil_us(&total, 0.99f);
+    hospedeiro_tarefa(NULL);
+    hospedeiro_relogio_real();
+
+    return res;
+}
+
+static void mostra(const char *nome, const resultado_t *r)
+{
+    printf("  %s: %u produtos, %u aceitos, %u rejeitados, %u atrasados (%u fora da faixa), "
+           "%u erradas; latência p50 < %u us, p99 < %u us, máx %u us (real %u us, prazo %u us)\n",
+           nome, r->produtos, r->aceitos, r->rejeitados, r->atrasados, r->atrasados_fora, r->erradas,
+           r->p50, r->p99, r->latencia_max, r->latencia_real_max, REJEICAO_PRAZO_US);
+}
+
+static void testa_esteiras(void)
+{
+    const uint32_t esperados = SEGUNDOS * PRODUTOS_S;
+    resultado_t r;
+
+    // a última rodada de fotocélulas pode passar de esperados em até uma por esteira
+
+    printf("Simulação da rejeição: %d esteiras, %d produtos/s somados, %d s, "
+           "%d us por despertar e %d us por produto\n",
+           ESTEIRAS, PRODUTOS_S, SEGUNDOS, CUSTO_DESPERTAR_US, CUSTO_PRODUTO_US);
+
+    // espalhadas e as 64 chegando juntas: tudo decidido dentro do prazo
+    for (int s = 0; s < 2; s++)
+    {
+        r = simula(s == 1, CUSTO_DESPERTAR_US, CUSTO_PRODUTO_US);
+        mostra(s ? "sincronizadas" : "espalhadas", &r);
+
+        CONFERE(r.produtos >= esperados && r.produtos <= esperados + ESTEIRAS &&
+                r.decididos == r.produtos && r.transbordos == 0,
+                "%u produtos, %u decididos, %u transbordos", r.produtos, r.decididos, r.transbordos);
+        CONFERE(r.aceitos + r.rejeitados == r.produtos && r.atrasados == 0 && r.erradas == 0,
+                "%u atrasados, %u decisões erradas", r.atrasados, r.erradas);
+        CONFERE(r.rejeitados > r.produtos / 5 && r.rejeitados < r.produtos / 2, "%u rejeitados", r.rejeitados);
+        CONFERE(r.latencia_max <= REJEICAO_PRAZO_US && r.p99 <= REJEICAO_PRAZO_US &&
+                r.latencia_max >= r.latencia_real_max, "latência máxima %u us (real %u us), p99 %u us",
+                r.latencia_max, r.latencia_real_max, r.p99);
+    }
+    CONFERE(servicos_gpio == 1, "serviço de ISR do GPIO instalado %d vezes", servicos_gpio);
+
+    // core sobrecarregado nas rajadas: os atrasados são contados e nenhum
+    // passa como decidido a tempo
+    r = simula(true, 4 * CUSTO_DESPERTAR_US, 8 * CUSTO_PRODUTO_US);
+    mostra("sincronizadas, custo 8x", &r);
+    CONFERE(r.decididos == r.produtos && r.atrasados > 0 && r.atrasados_fora > 0 && r.inseguras == 0,
+            "sobrecarga: %u decididos, %u atrasados, %u fora da faixa, %u a tempo depois do prazo",
+            r.decididos, r.atrasados, r.atrasados_fora, r.inseguras);
+}
+
+int main(void)
+{
+    testa_faixa();
+    testa_ingestao();
+    testa_esteiras();
+
+    TESTE_FIM();
+}
@@ -0,0 +1,324 @@
+/*
+Arquivo: teste_sensor.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes da camada de entrada das células de carga: reprodução
+        de traço em memória com volta ao início, traço gravado numa
+        partição falsa (cabeçalho inválido, taxa errada) reproduzido
+        pela detecção com o mesmo resultado do sinal original, e o
+        ADC por DMA com um I2S falso que entrega buffers pela metade
+        e falha. Roda também o benchmark das fontes. Com um arquivo de
+        tools/traco_grava.py na linha de comando, só reproduz esse
+        traço pela detecção e lista os produtos para teste_traco.py.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "teste.h"
+#include "esp_partition.h"
+#include "driver/i2s.h"
+#include "sensor.h"
+
+#define SEGUNDOS 10
+#define AMOSTRAS (SEGUNDOS * PESAGEM_TAXA_HZ)
+
+// partição "traco" falsa: cabeçalho seguido das amostras
+static struct
+{
+    sensor_traco_t cabecalho;
+    int16_t amostras[AMOSTRAS];
+} flash;
+
+static esp_partition_t particao = {ESP_PARTITION_TYPE_DATA, SENSOR_TRACO_SUBTIPO, 0x200000,
+                                   sizeof(flash), "traco"};
+static bool particao_existe;
+static int mapeamentos, desmapeamentos;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t tipo,
+                                                esp_partition_subtype_t subtipo, const char *rotulo)
+{
+    return particao_existe && tipo == particao.type && subtipo == particao.subtype ? &particao : NULL;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *p, size_t inicio, size_t tamanho,
+                             spi_flash_mmap_memory_t memoria, const void **ponteiro,
+                             spi_flash_mmap_handle_t *handle)
+{
+    mapeamentos++;
+    *ponteiro = (const uint8_t *) &flash + inicio;
+    return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle)
+{
+    desmapeamentos++;
+}
+
+// I2S falso: cada leitura entrega até meio buffer de DMA, com o canal nos
+// 4 bits de cima, e a leitura de número falha_em falha
+static uint32_t adc_proxima;
+static int adc_leituras, adc_falha_em = -1, dma_instalado;
+static esp_err_t instala_resultado = ESP_OK;
+
+esp_err_t i2s_driver_install(i2s_port_t porta, const i2s_config_t *config, int fila_tamanho,
+                             void *fila)
+{
+    dma_instalado = config->dma_buf_len;
+    return instala_resultado;
+}
+
+esp_err_t i2s_driver_uninstall(i2s_port_t porta)
+{
+    dma_instalado = 0;
+    return ESP_OK;
+}
+
+esp_err_t i2s_set_adc_mode(adc_unit_t unidade, adc1_channel_t canal)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2s_adc_enable(i2s_port_t porta)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2s_adc_disable(i2s_port_t porta)
+{
+    return ESP_OK;
+}
+
+esp_err_t adc1_config_channel_atten(adc1_channel_t canal, adc_atten_t atenuacao)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2s_read(i2s_port_t porta, void *destino, size_t tamanho, size_t *lidos,
+                   TickType_t espera)
+{
+    uint16_t *bruto = (uint16_t *) destino;
+    size_t n = tamanho / sizeof(uint16_t);
+
+    if (adc_leituras++ == adc_falha_em)
+    {
+        *lidos = 0;
+        return ESP_FAIL;
+    }
+
+    n = n > (size_t) dma_instalado / 2 ? (size_t) dma_instalado / 2 : n;
+    for (size_t i = 0; i < n; i++)
+    {
+        bruto[i] = 0x6000 | (adc_proxima++ & 0x0FFF);
+    }
+    *lidos = n * sizeof(uint16_t);
+
+    return ESP_OK;
+}
+
+// reprodução em memória: blocos de qualquer tamanho, inclusive maiores que
+// o traço, seguem amostra a amostra com a volta ao início
+static void testa_replay(void)
+{
+    static int16_t traco[1000];
+    static float amostras[2500];
+    const int blocos[] = {1, 64, 333, 1000, 2500};
+    sensor_t s;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        traco[i] = (int16_t) (i * 7 - 3000);
+    }
+
+    for (int b = 0; b < (int) (sizeof(blocos) / sizeof(blocos[0])); b++)
+    {
+        uint32_t esperada = 990;
+        int erradas = 0;
+
+        sensor_inicia_replay(&s, PESAGEM_TAXA_HZ, traco, 1000, 0.002f, 1990);
+        for (int lidas = 0; lidas < 5000; lidas += blocos[b])
+        {
+            CONFERE(sensor_bloco(&s, amostras, blocos[b]) == blocos[b], "bloco %d incompleto", blocos[b]);
+            for (int i = 0; i < blocos[b]; i++, esperada = (esperada + 1) % 1000)
+            {
+                erradas += amostras[i] != traco[esperada] * 0.002f;
+            }
+        }
+        CONFERE(erradas == 0, "blocos de %d: %d amostras erradas", blocos[b], erradas);
+    }
+}
+
+// detecta um traço inteiro em blocos de PESAGEM_BLOCO
+static int detecta(sensor_t *s, pesagem_produto_t *produtos, int max)
+{
+    float amostras[PESAGEM_BLOCO];
+    pesagem_t p;
+    int n = 0;
+
+    pesagem_inicia(&p, PESAGEM_TAXA_HZ);
+    for (int lidas = 0; lidas < AMOSTRAS; lidas += PESAGEM_BLOCO)
+    {
+        sensor_bloco(s, amostras, PESAGEM_BLOCO);
+        n += pesagem_processa(&p, amostras, PESAGEM_BLOCO, &produtos[n], max - n);
+    }
+
+    return n;
+}
+
+// o sinal do gerador gravado na partição a 1 g por LSB, como
+// tools/traco_grava.py grava o da célula, e reproduzido pela detecção
+static void testa_traco(void)
+{
+    static pesagem_produto_t originais[64], reproduzidos[64];
+    static float sinal[AMOSTRAS];
+    sensor_t s;
+    int n_originais, n_reproduzidos, diferentes = 0;
+
+    sensor_inicia_sintetico(&s, PESAGEM_TAXA_HZ, 310, 0, 1.5f, 9);
+    sensor_bloco(&s, sinal, AMOSTRAS);
+    flash.cabecalho.magico = SENSOR_TRACO_MAGICO;
+    flash.cabecalho.taxa_hz = PESAGEM_TAXA_HZ;
+    flash.cabecalho.amostras = AMOSTRAS;
+    flash.cabecalho.kg_por_lsb = 0.001f;
+    for (int i = 0; i < AMOSTRAS; i++)
+    {
+        flash.amostras[i] = (int16_t) lrintf(sinal[i] / 0.001f);
+    }
+
+    // sem partição, cabeçalho estragado ou maior que a partição: recusa e
+    // não deixa a partição mapeada
+    particao_existe = false;
+    CONFERE(!sensor_inicia_traco(&s, PESAGEM_TAXA_HZ, 0), "traço aceito sem partição");
+    particao_existe = true;
+    flash.cabecalho.magico ^= 1;
+    CONFERE(!sensor_inicia_traco(&s, PESAGEM_TAXA_HZ, 0), "traço aceito com o mágico errado");
+    flash.cabecalho.magico ^= 1;
+    flash.cabecalho.amostras = AMOSTRAS + 1;
+    CONFERE(!sensor_inicia_traco(&s, PESAGEM_TAXA_HZ, 0), "traço maior que a partição aceito");
+    flash.cabecalho.amostras = AMOSTRAS;
+    CONFERE(mapeamentos == 2 && desmapeamentos == 2, "%d mapeamentos, %d desfeitos", mapeamentos,
+            desmapeamentos);
+
+    // válido: mapeado uma vez para todas as esteiras, só na taxa gravada
+    CONFERE(sensor_inicia_traco(&s, PESAGEM_TAXA_HZ, 0), "traço válido recusado");
+    CONFERE(!sensor_inicia_traco(&s, 2 * PESAGEM_TAXA_HZ, 0), "traço aceito em outra taxa");
+    CONFERE(sensor_inicia_traco(&s, PESAGEM_TAXA_HZ, 0) && mapeamentos == 3,
+            "%d mapeamentos da partição", mapeamentos);
+
+    // reproduzido, dá os mesmos produtos do sinal original; o grama da
+    // quantização pode mudar a amostra em que a janela estável começa
+    n_reproduzidos = detecta(&s, reproduzidos, 64);
+    sensor_inicia_sintetico(&s, PESAGEM_TAXA_HZ, 310, 0, 1.5f, 9);
+    n_originais = detecta(&s, originais, 64);
+
+    CONFERE(n_originais > 20 && n_reproduzidos == n_originais, "%d produtos reproduzidos, %d originais",
+            n_reproduzidos, n_originais);
+    for (int i = 0; i < n_originais && i < n_reproduzidos; i++)
+    {
+        diferentes += fabsf(reproduzidos[i].peso - originais[i].peso) > PESAGEM_TOLERANCIA ||
+                      abs((int) reproduzidos[i].amostra - (int) originais[i].amostra) > PESAGEM_JANELA;
+    }
+    CONFERE(diferentes == 0, "%d produtos diferentes na reprodução", diferentes);
+}
+
+// ADC: o bloco junta quantas leituras de DMA forem precisas; o canal não
+// entra no valor; a leitura que falha devolve o bloco incompleto
+static void testa_adc(void)
+{
+    static float amostras[3000];
+    sensor_t s;
+    int erradas = 0;
+
+    instala_resultado = ESP_FAIL;
+    CONFERE(!sensor_inicia_adc(&s, 10000, 256) && s.bruto == NULL, "ADC sem driver aceito");
+    instala_resultado = ESP_OK;
+
+    CONFERE(sensor_inicia_adc(&s, 10000, 3000) && dma_instalado == SENSOR_ADC_MAX_DMA,
+            "buffer de DMA de %d amostras", dma_instalado);
+
+    adc_proxima = 4000;
+    CONFERE(sensor_bloco(&s, amostras, 3000) == 3000, "bloco do ADC incompleto");
+    for (int i = 0; i < 3000; i++)
+    {
+        erradas += amostras[i] != ((4000 + i) & 0x0FFF) * SENSOR_ADC_KG_POR_LSB;
+    }
+    CONFERE(erradas == 0, "%d amostras do ADC erradas", erradas);
+    CONFERE(s.leituras == 6 && s.falhas == 0, "%u leituras, %u falhas", s.leituras, s.falhas);
+
+    adc_falha_em = adc_leituras + 2;
+    CONFERE(sensor_bloco(&s, amostras, 3000) == SENSOR_ADC_MAX_DMA && s.falhas == 1,
+            "falha do DMA: %u falhas", s.falhas);
+
+    sensor_para(&s);
+    CONFERE(s.bruto == NULL && dma_instalado == 0, "driver do ADC ficou instalado");
+}
+
+// imagem gravada por tools/traco_grava.py na partição falsa, reproduzida
+// do começo ao fim; uma linha "produto amostra peso" por produto
+static void testa_arquivo(const char *caminho)
+{
+    FILE *arquivo = fopen(caminho, "rb");
+    float amostras[PESAGEM_BLOCO];
+    pesagem_produto_t produtos[PESAGEM_MAX_PRODUTOS];
+    pesagem_t p;
+    sensor_t s;
+    size_t lidos;
+
+    CONFERE(arquivo != NULL, "%s não abriu", caminho);
+    if (arquivo == NULL)
+    {
+        return;
+    }
+    lidos = fread(&flash, 1, sizeof(flash), arquivo);
+    CONFERE(lidos >= sizeof(flash.cabecalho) && fgetc(arquivo) == EOF,
+            "%s com %u bytes ou maior que a partição falsa", caminho, (unsigned) lidos);
+    fclose(arquivo);
+
+    particao_existe = true;
+    if (!sensor_inicia_traco(&s, PESAGEM_TAXA_HZ, 0))
+    {
+        printf("traço recusado\n");
+        return;
+    }
+    CONFERE(sizeof(flash.cabecalho) + flash.cabecalho.amostras * sizeof(int16_t) <= lidos,
+            "cabeçalho com %u amostras, arquivo com %u bytes", flash.cabecalho.amostras,
+            (unsigned) lidos);
+
+    // uma passada pelo traço, sem a volta ao início
+    pesagem_inicia(&p, PESAGEM_TAXA_HZ);
+    for (uint32_t lidas = 0; lidas + PESAGEM_BLOCO <= flash.cabecalho.amostras; lidas += PESAGEM_BLOCO)
+    {
+        sensor_bloco(&s, amostras, PESAGEM_BLOCO);
+
+        int k = pesagem_processa(&p, amostras, PESAGEM_BLOCO, produtos, PESAGEM_MAX_PRODUTOS);
+
+        for (int i = 0; i < k; i++)
+        {
+            printf("produto %u %.4f\n", produtos[i].amostra, (double) produtos[i].peso);
+        }
+    }
+    CONFERE(p.descartados == 0, "%u produtos além do bloco", p.descartados);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc == 2)
+    {
+        testa_arquivo(argv[1]);
+        TESTE_FIM();
+    }
+
+    testa_replay();
+    testa_traco();
+    testa_adc();
+
+    // vazão do gerador e da reprodução, lendo e lendo com a detecção
+    sensor_benchmark();
+
+    TESTE_FIM();
+}
@@ -0,0 +1,176 @@
+/*
+Arquivo: teste_serie.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Testes das séries temporais: segundos, minutos e horas iguais
+        às somas diretas dos produtos ao longo de 30 h simuladas com
+        rajadas e paradas maiores que os anéis, a massa da hora em
+        gramas exata onde o float já arredonda, e o benchmark de 3 e
+        64 esteiras a 1000 produtos/s.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "teste.h"
+#include "serie.h"
+
+#define HORAS_SIMULADAS 30
+#define SEGUNDOS_SIMULADOS (HORAS_SIMULADAS * 3600)
+
+// começa no meio de uma hora, como uma partida qualquer
+#define BASE_US ((int64_t) 1234 * 1000000 + 567)
+
+static uint32_t estado_aleatorio = 123456789u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// referência: contagem e gramas de cada segundo desde a época
+static uint32_t contagem_ref[SEGUNDOS_SIMULADOS + 1300];
+static uint64_t massa_ref[SEGUNDOS_SIMULADOS + 1300];
+
+static const int tamanhos[SERIE_NIVEIS] = {SERIE_SEGUNDOS, SERIE_MINUTOS, SERIE_HORAS};
+static const uint32_t duracoes[SERIE_NIVEIS] = {1, 60, 3600};
+
+// os intervalos que a consulta devolve contra as somas dos segundos;
+// os que saíram do anel voltam zerados
+static int confere(const serie_t *s, int64_t agora_us)
+{
+    serie_ponto_t pontos[SERIE_SEGUNDOS];
+    int erradas = 0;
+
+    for (int nivel = 0; nivel < SERIE_NIVEIS; nivel++)
+    {
+        int n = tamanhos[nivel];
+        int64_t ultimo = agora_us / 1000000 / duracoes[nivel];
+
+        serie_consulta(s, nivel, agora_us, pontos, n);
+        for (int i = 0; i < n; i++)
+        {
+            int64_t k = ultimo - (n - 1) + i;
+            uint32_t contagem = 0;
+            uint64_t massa = 0;
+
+            for (int64_t seg = k * duracoes[nivel]; k >= 0 && seg < (k + 1) * duracoes[nivel]; seg++)
+            {
+                if (seg < (int64_t) (sizeof(contagem_ref) / sizeof(contagem_ref[0])))
+                {
+                    contagem += contagem_ref[seg];
+                    massa += massa_ref[seg];
+                }
+            }
+            erradas += pontos[i].contagem != contagem || pontos[i].massa_g != massa;
+        }
+    }
+
+    return erradas;
+}
+
+// produtos em rajadas e paradas de até 3 h (mais que o anel de minutos),
+// conferindo os três níveis a cada 500 produtos e no meio das paradas
+static void testa_cascata(void)
+{
+    static serie_t s;
+    int64_t agora = BASE_US;
+    const int64_t fim = BASE_US + (int64_t) SEGUNDOS_SIMULADOS * 1000000;
+    uint32_t produtos = 0;
+    int erradas = 0, conferencias = 0;
+
+    serie_inicia(&s, agora);
+    while (1)
+    {
+        uint32_t sorteio = aleatorio() % 10000;
+        int64_t pausa = sorteio < 9000 ? aleatorio() % 20000 :
+                        sorteio < 9995 ? aleatorio() % 2000000 :
+                        (int64_t) (aleatorio() % 3) * 3600000000 + aleatorio() % 1000000000;
+        uint32_t n = aleatorio() % 4 == 0 ? 1 + aleatorio() % 5 : 1;
+        float massa = n * (0.5f + (aleatorio() % 4500) * 0.001f);
+
+        if (agora + pausa >= fim)
+        {
+            break;
+        }
+
+        // no meio da parada, antes de o próximo produto avançar os anéis
+        if (pausa > 60000000)
+        {
+            erradas += confere(&s, agora + pausa / 2);
+            conferencias++;
+        }
+        agora += pausa;
+
+        serie_acrescenta(&s, n, massa, agora);
+        contagem_ref[agora / 1000000] += n;
+        massa_ref[agora / 1000000] += lrintf(massa * 1000);
+        produtos++;
+
+        if (produtos % 500 == 0)
+        {
+            erradas += confere(&s, agora);
+            conferencias++;
+        }
+    }
+
+    CONFERE(produtos > 50000 && conferencias > 100, "%u produtos, %d conferências", produtos,
+            conferencias);
+    CONFERE(erradas == 0, "%d intervalos diferentes da soma direta", erradas);
+}
+
+// uma esteira a 333 produtos/s de ~2 kg enche 2400 t numa hora: o float
+// arredonda cada produto, os gramas inteiros batem com a soma exata
+static void testa_massa(void)
+{
+    static serie_t s;
+    serie_ponto_t hora;
+    const uint32_t produtos = 333 * 3600;
+    uint64_t esperada = 0;
+    float soma_float = 0;
+    int64_t agora = 0;
+
+    serie_inicia(&s, 0);
+    for (uint32_t i = 0; i < produtos; i++)
+    {
+        float peso = 1.9f + (aleatorio() % 2001) * 0.0001f;
+
+        agora = (int64_t) i * 3600000000 / produtos;
+        serie_acrescenta(&s, 1, peso, agora);
+        esperada += lrintf(peso * 1000);
+        soma_float += peso;
+    }
+    serie_consulta(&s, SERIE_HORA, agora, &hora, 1);
+
+    printf("Massa da hora: %u g em gramas inteiros, %llu g somados à parte, float %.0f g\n",
+           hora.massa_g, (unsigned long long) esperada, (double) soma_float * 1000);
+    CONFERE(hora.contagem == produtos && hora.massa_g == esperada,
+            "hora com %u produtos e %u g, %llu g esperados", hora.contagem, hora.massa_g,
+            (unsigned long long) esperada);
+
+    // a conferência tem que enxergar o float derivando
+    CONFERE(fabs((double) soma_float * 1000 - (double) esperada) > 1000, "soma em float não derivou");
+
+    // massa negativa não dá a volta no inteiro
+    serie_inicia(&s, 0);
+    serie_acrescenta(&s, 1, -0.002f, 0);
+    serie_consulta(&s, SERIE_SEGUNDO, 0, &hora, 1);
+    CONFERE(hora.contagem == 1 && hora.massa_g == 0, "massa negativa somou %u g", hora.massa_g);
+}
+
+int main(void)
+{
+    testa_cascata();
+    testa_massa();
+
+    CONFERE(serie_benchmark(), "produto ou grama perdido nas horas do benchmark");
+
+    TESTE_FIM();
+}
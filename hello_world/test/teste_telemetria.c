@@ -0,0 +1,186 @@
+/*
+Arquivo: teste_telemetria.c
+Autor:  Diogo Marchi
+        George Borba
+        Leonardo Grando
+Função do arquivo:
+        Lado C da ida e volta da telemetria: grava numa captura os
+        quadros que o firmware emitiria por lote (vetor de pesos
+        comprimido em pedaços, resumo, esteiras e histograma) entre
+        linhas de texto do console, e num segundo arquivo os valores
+        esperados e a posição de cada quadro. teste_telemetria.py
+        decodifica com tools/telemetria_decodifica.py e confere.
+Criado em 19 de outubro de 2026
+Modificado em 19 de outubro de 2026
+
+*/
+
+#include <math.h>
+#include <string.h>
+#include "teste.h"
+#include "driver/uart.h"
+#include "esp_timer.h"
+#include "telemetria.h"
+#include "compressao.h"
+
+#define LOTES 6
+#define PRODUTOS 200
+#define ESTEIRAS 3
+
+static FILE *captura;
+static FILE *esperado;
+static long posicao = 0;
+static long posicao_escrita;
+static uint16_t sequencia = 0;
+static int64_t agora = 1000000;
+
+static const float dicionario[ESTEIRAS] = {5.0f, 2.0f, 0.5f};
+
+// UART falsa: a captura é o que sairia pelo console
+esp_err_t uart_driver_install(uart_port_t porta, int rx, int tx, int fila, void *handle, int flags)
+{
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t porta, const char *dados, size_t n)
+{
+    posicao_escrita = posicao;
+    posicao += fwrite(dados, 1, n, captura);
+    return n;
+}
+
+// log de texto no meio dos quadros, como o printf do firmware
+static void texto(const char *linha)
+{
+    uart_write_bytes(0, linha, strlen(linha));
+}
+
+// um segundo entre quadros: o buffer da UART sempre escoou
+static void envia(uint8_t tipo, const void *payload, uint8_t tamanho)
+{
+    agora += 1000000;
+    hospedeiro_relogio(agora);
+
+    int n = telemetria_envia(tipo, payload, tamanho);
+
+    CONFERE(n == TELEMETRIA_CABECALHO + tamanho + 2, "quadro %u com %d bytes", sequencia, n);
+    fprintf(esperado, "quadro %u %ld %d\n", sequencia, posicao_escrita, n);
+    sequencia++;
+}
+
+static uint32_t estado_aleatorio = 88172645u;
+
+static uint32_t aleatorio(void)
+{
+    estado_aleatorio ^= estado_aleatorio << 13;
+    estado_aleatorio ^= estado_aleatorio >> 17;
+    estado_aleatorio ^= estado_aleatorio << 5;
+    return estado_aleatorio;
+}
+
+// vetor de pesos do lote: classes das esteiras, metade medida
+static void envia_pesos(uint32_t lote)
+{
+    static uint8_t fluxo[COMPRESSAO_PIOR_CASO(PRODUTOS)];
+    telemetria_pesos_t pedaco;
+    compressor_t c;
+
+    compressor_inicia(&c, fluxo, sizeof(fluxo));
+    for (int i = 0; i < PRODUTOS; i++)
+    {
+        int classe = aleatorio() % ESTEIRAS;
+
+        if (i % 2 == 0)
+        {
+            float peso = dicionario[classe] + (float) ((int) (aleatorio() % 201) - 100) / 1000;
+
+            compressor_medido(&c, classe, peso);
+            fprintf(esperado, "peso %u %d %d %ld\n", lote, i, classe, lrintf(peso * COMPRESSAO_ESCALA));
+        } else
+        {
+            compressor_fixo(&c, classe);
+            fprintf(esperado, "peso %u %d %d fixo\n", lote, i, classe);
+        }
+    }
+    size_t total = compressor_fim(&c);
+
+    CONFERE(total > 0, "lote %u não comprimiu", lote);
+
+    // os mesmos pedaços que o relatório emite
+    for (size_t d = 0; d < total; d += TELEMETRIA_PESOS_PEDACO)
+    {
+        size_t n = total - d < TELEMETRIA_PESOS_PEDACO ? total - d : TELEMETRIA_PESOS_PEDACO;
+
+        pedaco.lote = lote;
+        pedaco.deslocamento = d;
+        pedaco.total = total;
+        memcpy(pedaco.dados, &fluxo[d], n);
+        envia(TELEMETRIA_PESOS, &pedaco, TELEMETRIA_PESOS_CABECALHO + n);
+    }
+}
+
+static void envia_lote(uint32_t numero)
+{
+    telemetria_lote_t resumo = {
+        numero, numero * 20000 + 17, 123.456f + numero, 150 + numero, 19000 + numero, PRODUTOS,
+    };
+
+    envia(TELEMETRIA_LOTE, &resumo, sizeof(resumo));
+    fprintf(esperado, "lote %u %u %u %a %u %u %u\n", sequencia - 1, resumo.numero, resumo.tempo_ms,
+            (double) resumo.peso_total, resumo.reducao_us, resumo.preenchimento_us,
+            resumo.num_produtos);
+
+    for (int i = 0; i < ESTEIRAS; i++)
+    {
+        telemetria_esteira_t e = {
+            i + 1, numero * 67 + i, (numero * 67 + i) * dicionario[i], 10.0f / (i + 1),
+            800 + i, 67, dicionario[i] + 0.001f, 0.0123f * (i + 1), dicionario[i] - 0.1f,
+            dicionario[i] + 0.1f,
+        };
+
+        envia(TELEMETRIA_ESTEIRA, &e, sizeof(e));
+        fprintf(esperado, "esteira %u %u %u %a %a %u %u %a %a %a %a\n", sequencia - 1, e.esteira,
+                e.contagem, (double) e.massa, (double) e.taxa, e.latencia_max_us, e.produtos_lote,
+                (double) e.media, (double) e.desvio, (double) e.min, (double) e.max);
+    }
+
+    telemetria_histograma_t h;
+
+    for (int i = 0; i < TELEMETRIA_FAIXAS; i++)
+    {
+        h.faixas[i] = (uint16_t) (numero * 1000 + i * i);
+    }
+    envia(TELEMETRIA_HISTOGRAMA, &h, sizeof(h));
+    fprintf(esperado, "histograma %u", sequencia - 1);
+    for (int i = 0; i < TELEMETRIA_FAIXAS; i++)
+    {
+        fprintf(esperado, " %u", h.faixas[i]);
+    }
+    fprintf(esperado, "\n");
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3 || (captura = fopen(argv[1], "wb")) == NULL || (esperado = fopen(argv[2], "w")) == NULL)
+    {
+        printf("uso: teste_telemetria captura.bin esperado.txt\n");
+        return 2;
+    }
+
+    fprintf(esperado, "dicionario %a %a %a\n", (double) dicionario[0], (double) dicionario[1],
+            (double) dicionario[2]);
+
+    texto("I (312) esteiras: partida\n");
+    for (uint32_t lote = 0; lote < LOTES; lote++)
+    {
+        envia_pesos(lote);
+        texto("Lote fechado, relatório a seguir\n");
+        envia_lote(lote);
+    }
+    texto("I (99999) esteiras: fim\n");
+
+    fclose(captura);
+    fclose(esperado);
+
+    TESTE_FIM();
+}
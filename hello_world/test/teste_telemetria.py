@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Ida e volta da telemetria: teste_telemetria grava a captura com os quadros
+do firmware e os valores esperados; tools/telemetria_decodifica.py tem que
+devolver exatamente esses valores, e com a captura estragada (byte trocado,
+quadro cortado no meio, sincronismo falso perto do fim, captura truncada,
+pedaço de pesos perdido) perder só os quadros atingidos.
+
+Uso:
+    python3 teste_telemetria.py caminho/do/teste_telemetria
+"""
+
+import importlib.util
+import io
+import os
+import subprocess
+import sys
+import tempfile
+
+AQUI = os.path.dirname(os.path.abspath(__file__))
+DECODIFICADOR = os.path.join(AQUI, "..", "tools", "telemetria_decodifica.py")
+
+
+def carrega_decodificador():
+    spec = importlib.util.spec_from_file_location("telemetria_decodifica", DECODIFICADOR)
+    modulo = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(modulo)
+    return modulo
+
+
+def valor(texto):
+    return float.fromhex(texto) if "p" in texto else int(texto)
+
+
+def le_esperado(caminho):
+    """(dicionario, posições dos quadros, registros por sequência, pesos)."""
+    dicionario = []
+    posicoes = {}
+    registros = {}
+    pesos = {}
+    with open(caminho) as f:
+        for linha in f:
+            campos = linha.split()
+            if campos[0] == "dicionario":
+                dicionario = [valor(c) for c in campos[1:]]
+            elif campos[0] == "quadro":
+                posicoes[int(campos[1])] = (int(campos[2]), int(campos[3]))
+            elif campos[0] == "peso":
+                lote, indice, classe = (int(c) for c in campos[1:4])
+                pesos[(lote, indice)] = (classe, None if campos[4] == "fixo" else int(campos[4]))
+            else:
+                registros[int(campos[1])] = (campos[0], [valor(c) for c in campos[2:]])
+    return dicionario, posicoes, registros, pesos
+
+
+class Conferencia:
+    def __init__(self, decodificador, dicionario, registros, pesos):
+        self.dec = decodificador
+        self.dicionario = dicionario
+        self.registros = registros
+        self.pesos = pesos
+        self.falhas = 0
+
+    def decodifica(self, dados):
+        """Registros por sequência e pesos por (lote, índice), avisos calados."""
+        erro = sys.stderr
+        sys.stderr = io.StringIO()
+        try:
+            quadros = list(self.dec.quadros(dados))
+            obtidos = {}
+            pedacos = []
+            for seq, nome, campos in quadros:
+                if nome == "pesos":
+                    pedacos.append(campos)
+                else:
+                    _, _, nomes = self.dec.TIPOS[{"lote": 1, "esteira": 2, "histograma": 3}[nome]]
+                    obtidos[seq] = (nome, [campos[c] for c in nomes])
+            pesos = {}
+            for p in self.dec.junta_pesos(pedacos, self.dicionario):
+                pesos[(p["lote"], p["indice"])] = (p["classe"], p["peso"])
+        finally:
+            sys.stderr = erro
+        return obtidos, pesos, len(quadros)
+
+    def confere(self, caso, dados, perdidos=(), lotes_perdidos=()):
+        obtidos, pesos, _ = self.decodifica(dados)
+        esperados = {s: r for s, r in self.registros.items() if s not in perdidos}
+        if obtidos != esperados:
+            faltam = sorted(set(esperados) - set(obtidos))
+            sobram = sorted(set(obtidos) - set(esperados))
+            diferentes = [s for s in esperados if s in obtidos and obtidos[s] != esperados[s]]
+            print("%s: faltam %s, sobram %s, diferentes %s" % (caso, faltam, sobram, diferentes[:5]))
+            self.falhas += 1
+
+        erradas = 0
+        for chave, (classe, gramas) in self.pesos.items():
+            if chave[0] in lotes_perdidos:
+                erradas += chave in pesos
+                continue
+            if chave not in pesos or pesos[chave][0] != classe:
+                erradas += 1
+                continue
+            peso = pesos[chave][1]
+            erradas += (peso != self.dicionario[classe] if gramas is None
+                        else round(peso * 1000) != gramas)
+        if erradas or len(pesos) + sum(1 for k in self.pesos if k[0] in lotes_perdidos) \
+                != len(self.pesos):
+            print("%s: %d pesos errados, %d decodificados" % (caso, erradas, len(pesos)))
+            self.falhas += 1
+
+
+def main():
+    dec = carrega_decodificador()
+    with tempfile.TemporaryDirectory() as pasta:
+        caminho_captura = os.path.join(pasta, "captura.bin")
+        caminho_esperado = os.path.join(pasta, "esperado.txt")
+        execucao = subprocess.run([sys.argv[1], caminho_captura, caminho_esperado])
+        if execucao.returncode != 0:
+            print("FALHOU")
+            return 1
+        with open(caminho_captura, "rb") as f:
+            captura = f.read()
+        dicionario, posicoes, registros, pesos = le_esperado(caminho_esperado)
+
+    c = Conferencia(dec, dicionario, registros, pesos)
+    resumos = sorted(registros)
+
+    # captura limpa: tudo
+    c.confere("limpa", captura)
+
+    # um byte trocado no payload: só aquele quadro cai
+    alvo = resumos[len(resumos) // 2]
+    inicio, n = posicoes[alvo]
+    estragada = bytearray(captura)
+    estragada[inicio + 8] ^= 0x40
+    c.confere("byte trocado", bytes(estragada), perdidos={alvo})
+
+    # quadro cortado no meio, o seguinte colado nele
+    alvo = resumos[3]
+    inicio, n = posicoes[alvo]
+    c.confere("quadro cortado", captura[:inicio + n // 2] + captura[inicio + n:], perdidos={alvo})
+
+    # sincronismo falso de um quadro de pesos longo logo antes do último
+    # quadro: o tamanho declarado passa do fim da captura, mas o último
+    # quadro inteiro vem depois dele
+    ultimo = max(posicoes)
+    inicio, n = posicoes[ultimo]
+    falso = dec.SINC + bytes([dec.PESOS, dec.MAX_PAYLOAD, 0, 0])
+    c.confere("sincronismo falso no fim", captura[:inicio] + falso + captura[inicio:inicio + n])
+
+    # captura truncada no meio do último quadro: só ele se perde
+    c.confere("captura truncada", captura[:inicio + n - 3], perdidos={ultimo})
+
+    # pedaço de pesos perdido: o lote dele fica incompleto, os outros inteiros
+    obtidos = [s for s in sorted(posicoes) if s not in registros]
+    inicio, n = posicoes[obtidos[len(obtidos) // 2]]
+    lote = int.from_bytes(captura[inicio + 6:inicio + 10], "little")
+    c.confere("pedaço de pesos perdido", captura[:inicio] + captura[inicio + n:],
+              lotes_perdidos={lote})
+
+    print("ok" if c.falhas == 0 else "FALHOU")
+    return 1 if c.falhas else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""
+Traço da célula de carga de ponta a ponta no host: tools/traco_grava.py
+grava a imagem da partição (sintética e a partir de um CSV "tempo,peso"),
+teste_sensor a carrega na partição falsa e reproduz pela detecção, e cada
+produto do traço tem que sair uma vez, com o peso gravado.
+
+Uso:
+    python3 teste_traco.py caminho/do/teste_sensor
+"""
+
+import csv
+import importlib.util
+import os
+import subprocess
+import sys
+import tempfile
+
+AQUI = os.path.dirname(os.path.abspath(__file__))
+GRAVADOR = os.path.join(AQUI, "..", "tools", "traco_grava.py")
+
+SEGUNDOS = 10
+TAXA = 1000
+PERIODO_MS = 500
+PESO = 2.0
+TOLERANCIA = 0.01
+
+
+def carrega_gravador():
+    spec = importlib.util.spec_from_file_location("traco_grava", GRAVADOR)
+    modulo = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(modulo)
+    return modulo
+
+
+def grava(*argumentos):
+    subprocess.run([sys.executable, GRAVADOR] + list(argumentos), check=True,
+                   stderr=subprocess.DEVNULL)
+
+
+def reproduz(teste_sensor, imagem):
+    """(produtos [(amostra, peso)], recusado, código de saída)."""
+    execucao = subprocess.run([teste_sensor, imagem], stdout=subprocess.PIPE,
+                              universal_newlines=True)
+    produtos = []
+    recusado = False
+    for linha in execucao.stdout.splitlines():
+        campos = linha.split()
+        if campos[:1] == ["produto"]:
+            produtos.append((int(campos[1]), float(campos[2])))
+        elif linha == "traço recusado":
+            recusado = True
+        elif linha != "ok":
+            print(linha)
+    return produtos, recusado, execucao.returncode
+
+
+def confere_produtos(caso, produtos):
+    """Um produto por período (o ruído muda a amostra em que a janela
+    estável fecha), todos com o peso do traço."""
+    periodo = PERIODO_MS * TAXA // 1000
+    esperados = SEGUNDOS * TAXA // periodo
+    intervalos = [b[0] - a[0] for a, b in zip(produtos, produtos[1:])]
+    errados = [p for _, p in produtos if abs(p - PESO) > TOLERANCIA]
+    if len(produtos) != esperados or any(abs(i - periodo) > periodo // 20 for i in intervalos) or errados:
+        print("%s: %d produtos (esperados %d), intervalos %s, pesos errados %s"
+              % (caso, len(produtos), esperados, sorted(set(intervalos)), errados[:5]))
+        return 1
+    return 0
+
+
+def main():
+    gravador = carrega_gravador()
+    teste_sensor = sys.argv[1]
+    falhas = 0
+
+    with tempfile.TemporaryDirectory() as pasta:
+        sintetica = os.path.join(pasta, "sintetico.bin")
+        do_csv = os.path.join(pasta, "csv.bin")
+        outra_taxa = os.path.join(pasta, "outra_taxa.bin")
+        entrada = os.path.join(pasta, "captura.csv")
+
+        # traço sintético do gravador
+        grava("--sintetico", str(SEGUNDOS), sintetica, "--taxa", str(TAXA))
+        produtos, recusado, codigo = reproduz(teste_sensor, sintetica)
+        falhas += codigo != 0 or recusado
+        falhas += confere_produtos("sintético", produtos)
+
+        # o mesmo sinal passando pelo CSV: mesma imagem, mesmos produtos
+        with open(entrada, "w", newline="") as f:
+            escritor = csv.writer(f)
+            escritor.writerow(["tempo", "peso"])
+            for n, peso in enumerate(gravador.sintetico(SEGUNDOS, TAXA)):
+                escritor.writerow(["%.3f" % (n / TAXA), repr(peso)])
+        grava(entrada, do_csv, "--taxa", str(TAXA))
+        with open(sintetica, "rb") as a, open(do_csv, "rb") as b:
+            if a.read() != b.read():
+                print("imagem do CSV diferente da sintética")
+                falhas += 1
+        produtos_csv, recusado, codigo = reproduz(teste_sensor, do_csv)
+        falhas += codigo != 0 or recusado or produtos_csv != produtos
+
+        # gravado em outra taxa: o firmware não reamostra, recusa
+        grava("--sintetico", str(SEGUNDOS // 2), outra_taxa, "--taxa", str(TAXA * 2))
+        _, recusado, codigo = reproduz(teste_sensor, outra_taxa)
+        if codigo != 0 or not recusado:
+            print("traço a %d Hz aceito" % (TAXA * 2))
+            falhas += 1
+
+    print("ok" if falhas == 0 else "FALHOU")
+    return 1 if falhas else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
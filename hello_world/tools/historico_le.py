@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Lê uma cópia da partição de histórico dos lotes (main/historico.h) e
+lista os registros válidos, do mais antigo ao mais novo, em CSV.
+
+A cópia vem da placa com o esptool (offset e tamanho de partitions.csv):
+    esptool.py read_flash 0x110000 0x40000 historico.bin
+
+Uso:
+    python historico_le.py historico.bin > lotes.csv
+    python historico_le.py historico.bin --esteiras 3
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import zlib
+
+SETOR = 4096
+REGISTRO = 40
+MAGICO = 0x32534948
+LIVRE = 0xFFFFFFFF
+
+
+def crc_valido(bloco):
+    # crc32_le(0, ...) da ROM do ESP32 é o mesmo CRC-32 do zlib
+    return struct.unpack_from("<I", bloco, REGISTRO - 4)[0] == zlib.crc32(bloco[:REGISTRO - 4])
+
+
+def setores(dados):
+    """(sequência, índice) dos setores com cabeçalho válido."""
+    validos = []
+    for s in range(len(dados) // SETOR):
+        cabecalho = dados[s * SETOR:s * SETOR + REGISTRO]
+        magico, sequencia = struct.unpack_from("<II", cabecalho)
+        if magico == MAGICO and crc_valido(cabecalho):
+            validos.append((sequencia, s))
+    return sorted(validos)
+
+
+def registros(dados, esteiras):
+    formato = "<II" + "I" * esteiras + "H" * esteiras + "HfI"
+    for _, s in setores(dados):
+        for i in range(1, SETOR // REGISTRO):
+            bloco = dados[s * SETOR + i * REGISTRO:s * SETOR + (i + 1) * REGISTRO]
+            if struct.unpack_from("<I", bloco)[0] == LIVRE:
+                break
+            if not crc_valido(bloco):
+                continue
+            campos = struct.unpack_from(formato, bloco)
+            yield {
+                "lote": campos[0],
+                "tempo_ms": campos[1],
+                "seq_inicio": list(campos[2:2 + esteiras]),
+                "contagem": list(campos[2 + esteiras:2 + 2 * esteiras]),
+                "peso_total": campos[3 + 2 * esteiras],
+                "reducao_us": campos[4 + 2 * esteiras],
+            }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("copia", help="arquivo lido da partição de histórico")
+    parser.add_argument("--esteiras", type=int, default=3, help="NUM_ESTEIRAS do firmware")
+    args = parser.parse_args()
+
+    if 8 + 6 * args.esteiras + 14 != REGISTRO:
+        sys.exit("registro de %d esteiras não tem %d bytes" % (args.esteiras, REGISTRO))
+
+    with open(args.copia, "rb") as arquivo:
+        dados = arquivo.read()
+
+    saida = csv.writer(sys.stdout)
+    saida.writerow(["lote", "tempo_ms"] + ["seq_%d" % (i + 1) for i in range(args.esteiras)]
+                   + ["esteira_%d" % (i + 1) for i in range(args.esteiras)]
+                   + ["peso_total", "reducao_us"])
+
+    # confere a emenda das faixas entre registros consecutivos
+    proxima = None
+    falhas = 0
+
+    for r in registros(dados, args.esteiras):
+        saida.writerow([r["lote"], r["tempo_ms"]] + r["seq_inicio"] + r["contagem"]
+                       + ["%.3f" % r["peso_total"], r["reducao_us"]])
+        if proxima is not None and r["seq_inicio"] != proxima:
+            falhas += 1
+        proxima = [s + c for s, c in zip(r["seq_inicio"], r["contagem"])]
+
+    if falhas:
+        print("%d registros não emendam com o anterior" % falhas, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
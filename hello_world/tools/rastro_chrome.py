@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""
+Converte o despejo do rastro (linhas "RASTRO ..." da serial, main/rastro.c)
+para o formato Trace Event JSON, aberto em chrome://tracing ou ui.perfetto.dev.
+
+Cada core vira um processo e cada tarefa (handle) uma thread. Os ciclos de
+cada core são desenrolados (o contador tem 32 bits) e alinhados ao tempo do
+esp_timer pela referência amostrada no despejo.
+
+Uso:
+    python rastro_chrome.py captura_serial.txt > rastro.json
+"""
+
+import json
+import sys
+
+
+def despejos(linhas):
+    """Gera cada despejo completo (INICIO ... FIM) da captura."""
+    atual = None
+    for linha in linhas:
+        partes = linha.split()
+        if len(partes) < 2 or partes[0] != "RASTRO":
+            continue
+        if partes[1] == "INICIO":
+            atual = {"mhz": int(partes[2]), "nomes": {}, "refs": {}, "eventos": {}}
+        elif atual is None:
+            continue
+        elif partes[1] == "NOME":
+            atual["nomes"][int(partes[2])] = partes[3]
+        elif partes[1] == "REF":
+            atual["refs"][int(partes[2])] = (int(partes[3]), int(partes[4]))
+        elif partes[1] == "EV":
+            core = int(partes[2])
+            atual["eventos"].setdefault(core, []).append(
+                (partes[3], int(partes[4]), int(partes[5]), partes[6]))
+        elif partes[1] == "FIM":
+            yield atual
+            atual = None
+
+
+def converte(despejo):
+    mhz = despejo["mhz"]
+    saida = []
+    for core, eventos in despejo["eventos"].items():
+        if not eventos:
+            continue
+
+        # desenrola os ciclos: os eventos de um core estão em ordem, então
+        # só um recuo de mais de meia volta é o contador dando a volta
+        absolutos = []
+        voltas = 0
+        anterior = eventos[0][2]
+        for _, _, ciclos, _ in eventos:
+            if anterior - ciclos > 2 ** 31:
+                voltas += 1
+            anterior = ciclos
+            absolutos.append(voltas * 2 ** 32 + ciclos)
+
+        # a referência foi amostrada depois do último evento
+        ref_ciclos, ref_us = despejo["refs"][core]
+        ultimo = absolutos[-1]
+        ref_abs = ultimo + ((ref_ciclos - eventos[-1][2]) % 2 ** 32)
+
+        for (fase, regiao, _, tarefa), ciclos in zip(eventos, absolutos):
+            saida.append({
+                "name": despejo["nomes"].get(regiao, str(regiao)),
+                "ph": fase,
+                "ts": ref_us - (ref_abs - ciclos) / mhz,
+                "pid": core,
+                "tid": int(tarefa, 16),
+            })
+
+    for core in despejo["eventos"]:
+        saida.append({"name": "process_name", "ph": "M", "pid": core,
+                      "args": {"name": "core %d" % core}})
+    return saida
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        sys.exit(1)
+
+    with open(sys.argv[1], errors="replace") as f:
+        eventos = []
+        for despejo in despejos(f):
+            eventos.extend(converte(despejo))
+
+    json.dump({"traceEvents": eventos, "displayTimeUnit": "ms"}, sys.stdout)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""
+Decodifica uma captura da UART com quadros de telemetria binária
+(main/telemetria.h) e gera CSV ou JSON.
+
+Texto comum misturado na captura é ignorado: o decodificador procura
+os bytes de sincronismo e só aceita quadros com CRC válido.
+
+Os pedaços do vetor de pesos comprimido (main/compressao.h) são juntados
+por lote e decodificados; com --dicionario os produtos de peso fixo
+saem com o peso da classe.
+
+Uso:
+    python telemetria_decodifica.py captura.bin --formato csv > saida.csv
+    python telemetria_decodifica.py captura.bin --formato json > saida.json
+    python telemetria_decodifica.py captura.bin --dicionario 5.0,2.0,0.5
+"""
+
+import argparse
+import csv
+import json
+import struct
+import sys
+
+SINC = b"\xa5\x5a"
+CABECALHO = 6
+FAIXAS = 16
+
+# tipo -> (nome, formato struct, campos)
+TIPOS = {
+    1: ("lote", "<IIfIIH",
+        ["numero", "tempo_ms", "peso_total", "reducao_us", "preenchimento_us", "num_produtos"]),
+    2: ("esteira", "<BIffIHffff",
+        ["esteira", "contagem", "massa", "taxa", "latencia_max_us",
+         "produtos_lote", "media", "desvio", "min", "max"]),
+    3: ("histograma", "<" + "H" * FAIXAS,
+        ["faixa_%d" % i for i in range(FAIXAS)]),
+}
+
+# pedaços do fluxo comprimido: cabeçalho fixo mais até 56 bytes
+PESOS = 4
+PESOS_CABECALHO = "<IHH"
+MAX_PAYLOAD = 64
+ESCALA = 1000
+
+
+def crc16(dados):
+    crc = 0xFFFF
+    for byte in dados:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def quadros(dados):
+    """Gera (sequência, nome, dict) para cada quadro válido."""
+    erros = 0
+    i = 0
+    while True:
+        i = dados.find(SINC, i)
+        if i < 0 or i + CABECALHO > len(dados):
+            break
+
+        tipo, tamanho, seq = struct.unpack_from("<BBH", dados, i + 2)
+
+        # sincronismo falso: tipo ou tamanho não batem
+        if tipo == PESOS:
+            valido = struct.calcsize(PESOS_CABECALHO) < tamanho <= MAX_PAYLOAD
+        else:
+            valido = tipo in TIPOS and struct.calcsize(TIPOS[tipo][1]) == tamanho
+        if not valido:
+            erros += 1
+            i += 1
+            continue
+
+        # passa do fim: ou o último quadro veio cortado ou o sincronismo é
+        # falso e um quadro inteiro pode começar antes do fim
+        fim = i + CABECALHO + tamanho + 2
+        if fim > len(dados):
+            erros += 1
+            i += 1
+            continue
+
+        crc, = struct.unpack_from("<H", dados, fim - 2)
+        if crc != crc16(dados[i + 2:fim - 2]):
+            erros += 1
+            i += 1
+            continue
+
+        if tipo == PESOS:
+            lote, deslocamento, total = struct.unpack_from(PESOS_CABECALHO, dados, i + CABECALHO)
+            inicio = i + CABECALHO + struct.calcsize(PESOS_CABECALHO)
+            yield seq, "pesos", dict(lote=lote, deslocamento=deslocamento, total=total,
+                                     dados=dados[inicio:fim - 2])
+        else:
+            nome, fmt, campos = TIPOS[tipo]
+
+            valores = struct.unpack_from(fmt, dados, i + CABECALHO)
+            yield seq, nome, dict(zip(campos, valores))
+        i = fim
+
+    if erros:
+        sys.stderr.write("%d quadros descartados (CRC, tipo inválido ou cortados)\n" % erros)
+
+
+def varint(fluxo, pos):
+    valor = 0
+    deslocamento = 0
+    while True:
+        b = fluxo[pos]
+        pos += 1
+        valor |= (b & 0x7F) << deslocamento
+        if not b & 0x80:
+            return valor, pos
+        deslocamento += 7
+
+
+def descomprime(fluxo, dicionario):
+    """Lista de (classe, peso) do fluxo de compressao.c."""
+    anterior = {}
+    produtos = []
+    pos = 0
+    while pos < len(fluxo):
+        controle = fluxo[pos]
+        classe = controle & 0x7F
+        k, pos = varint(fluxo, pos + 1)
+        if controle & 0x80:
+            for _ in range(k):
+                d, pos = varint(fluxo, pos)
+                anterior[classe] = anterior.get(classe, 0) + ((d >> 1) ^ -(d & 1))
+                produtos.append((classe, anterior[classe] / ESCALA))
+        else:
+            peso = dicionario[classe] if classe < len(dicionario) else None
+            produtos.extend([(classe, peso)] * k)
+    return produtos
+
+
+def junta_pesos(pedacos, dicionario):
+    """Junta os pedaços de cada lote e gera um registro por produto."""
+    fluxos = {}
+    for p in pedacos:
+        fluxo = fluxos.setdefault(p["lote"], bytearray(p["total"]))
+        fluxo[p["deslocamento"]:p["deslocamento"] + len(p["dados"])] = p["dados"]
+        p["recebidos"] = len(p["dados"])
+
+    recebidos = {}
+    for p in pedacos:
+        recebidos[p["lote"]] = recebidos.get(p["lote"], 0) + p["recebidos"]
+
+    produtos = []
+    for lote, fluxo in fluxos.items():
+        if recebidos[lote] != len(fluxo):
+            sys.stderr.write("lote %d: vetor de pesos incompleto\n" % lote)
+            continue
+        for indice, (classe, peso) in enumerate(descomprime(fluxo, dicionario)):
+            produtos.append(dict(tipo="peso", lote=lote, indice=indice, classe=classe, peso=peso))
+    return produtos
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("captura", help="arquivo binário capturado da UART")
+    parser.add_argument("--formato", choices=["csv", "json"], default="csv")
+    parser.add_argument("--dicionario", default="",
+                        help="pesos das classes separados por vírgula (ordem das esteiras)")
+    args = parser.parse_args()
+    dicionario = [float(p) for p in args.dicionario.split(",") if p]
+
+    with open(args.captura, "rb") as f:
+        dados = f.read()
+
+    anterior = None
+    perdidos = 0
+    registros = []
+    pedacos = []
+    for seq, nome, campos in quadros(dados):
+        if anterior is not None:
+            perdidos += (seq - anterior - 1) & 0xFFFF
+        anterior = seq
+        if nome == "pesos":
+            pedacos.append(campos)
+        else:
+            registros.append(dict(sequencia=seq, tipo=nome, **campos))
+
+    pesos = junta_pesos(pedacos, dicionario)
+
+    if perdidos:
+        sys.stderr.write("%d quadros perdidos (lacunas na sequência)\n" % perdidos)
+
+    if args.formato == "json":
+        json.dump(registros + pesos, sys.stdout, indent=1)
+        sys.stdout.write("\n")
+        return
+
+    # CSV: uma seção por tipo, cada uma com seu cabeçalho
+    saida = csv.writer(sys.stdout)
+    for nome, _, campos in TIPOS.values():
+        linhas = [r for r in registros if r["tipo"] == nome]
+        if not linhas:
+            continue
+        saida.writerow(["sequencia", "tipo"] + campos)
+        for r in linhas:
+            saida.writerow([r["sequencia"], r["tipo"]] + [r[c] for c in campos])
+
+    if pesos:
+        saida.writerow(["tipo", "lote", "indice", "classe", "peso"])
+        for p in pesos:
+            saida.writerow([p["tipo"], p["lote"], p["indice"], p["classe"], p["peso"]])
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Monta a imagem da partição "traco" (main/sensor.h) a partir de um traço
+de célula de carga gravado, para a fonte SENSOR_REPLAY reproduzir.
+
+A entrada é um CSV com um peso em kg por linha (a última coluna é usada,
+então um CSV "tempo,peso" também serve). Sem entrada, gera um traço
+sintético parecido com o do firmware (degrau, oscilação e ruído).
+
+Grava na placa com o esptool (offset de partitions.csv):
+    esptool.py write_flash 0x150000 traco.bin
+
+Uso:
+    python traco_grava.py captura.csv traco.bin --taxa 1000
+    python traco_grava.py --sintetico 60 traco.bin
+"""
+
+import argparse
+import csv
+import math
+import random
+import struct
+import sys
+
+MAGICO = 0x31435254
+TAMANHO_PARTICAO = 0x40000
+CABECALHO = struct.Struct("<IIIf")
+
+
+def le_csv(caminho):
+    pesos = []
+    with open(caminho, newline="") as arquivo:
+        for linha in csv.reader(arquivo):
+            try:
+                pesos.append(float(linha[-1]))
+            except (ValueError, IndexError):
+                continue            # cabeçalho ou linha vazia
+    return pesos
+
+
+def sintetico(segundos, taxa, periodo_ms=500, peso=2.0):
+    # mesmo formato de pesagem_gera: vazio, subida de 5 ms, 10% a 40 Hz
+    periodo = periodo_ms * taxa // 1000
+    presenca = periodo * 7 // 10
+    aleatorio = random.Random(1)
+    pesos = []
+    for n in range(segundos * taxa):
+        t = n % periodo - (periodo - presenca)
+        carga = 0.0
+        if t >= 0:
+            if t < 5:
+                carga = peso * (t + 1) / 5
+            else:
+                s = (t - 5) / taxa
+                carga = peso * (1 + 0.1 * math.exp(-s / 0.008) * math.cos(2 * math.pi * 40 * s))
+        pesos.append(0.25 + carga + aleatorio.uniform(-0.002, 0.002))
+    return pesos
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("entrada", nargs="?", help="CSV com um peso (kg) por linha")
+    parser.add_argument("saida", help="imagem da partição")
+    parser.add_argument("--taxa", type=int, default=1000, help="PESAGEM_TAXA_HZ do firmware")
+    parser.add_argument("--kg-por-lsb", type=float, default=0.001, help="resolução gravada")
+    parser.add_argument("--sintetico", type=int, metavar="SEGUNDOS",
+                        help="gera um traço em vez de ler a entrada")
+    args = parser.parse_args()
+
+    if args.sintetico:
+        pesos = sintetico(args.sintetico, args.taxa)
+    elif args.entrada:
+        pesos = le_csv(args.entrada)
+    else:
+        sys.exit("informe a entrada ou --sintetico")
+
+    maximo = (TAMANHO_PARTICAO - CABECALHO.size) // 2
+    if len(pesos) > maximo:
+        print("traço cortado em %d amostras (%.1f s)" % (maximo, maximo / args.taxa), file=sys.stderr)
+        pesos = pesos[:maximo]
+    if not pesos:
+        sys.exit("traço vazio")
+
+    amostras = [max(-32768, min(32767, round(p / args.kg_por_lsb))) for p in pesos]
+    saturadas = sum(1 for p, a in zip(pesos, amostras) if abs(p / args.kg_por_lsb - a) > 1)
+    if saturadas:
+        print("%d amostras saturaram em int16; aumente --kg-por-lsb" % saturadas, file=sys.stderr)
+
+    with open(args.saida, "wb") as arquivo:
+        arquivo.write(CABECALHO.pack(MAGICO, args.taxa, len(amostras), args.kg_por_lsb))
+        arquivo.write(struct.pack("<%dh" % len(amostras), *amostras))
+
+    print("%d amostras (%.1f s a %d Hz)" % (len(amostras), len(amostras) / args.taxa, args.taxa),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()